@@ -1,6 +1,11 @@
 #include "arenasavegame.h"
 
+#ifdef XNGINE_HEADLESS
+#include "xngineheadless.h"
+#else
 #include "gamearena.h"
+#endif
+#include "xnginesaveview.h"
 
 #include <QDir>
 #include <QFile>
@@ -8,6 +13,8 @@
 #include <QRegularExpression>
 #include <QStringList>
 
+#include <algorithm>
+
 namespace
 {
 using Codec = ArenaSaveGame::NibbleCodec;
@@ -62,6 +69,26 @@ const Codec kBless0Codec = makeCodec(
 const Codec kBless1Codec = makeCodec(
     {0xC, 0xD, 0xE, 0xF, 0x0, 0x1, 0x2, 0x3, 0x4, 0x5, 0x6, 0x7, 0x8, 0x9, 0xA, 0xB},
     {0x0, 0x1, 0x2, 0x3, 0x4, 0x5, 0x6, 0x7, 0x8, 0x9, 0xA, 0xB, 0xC, 0xD, 0xE, 0xF});
+
+using Table = ArenaSaveGame::DecodeTable;
+
+const Table kLevelTable = ArenaSaveGame::makeDecodeTable(kLevelCodec);
+const Table kExp0Table  = ArenaSaveGame::makeDecodeTable(kExp0Codec);
+const Table kExp1Table  = ArenaSaveGame::makeDecodeTable(kExp1Codec);
+const Table kExp2Table  = ArenaSaveGame::makeDecodeTable(kExp2Codec);
+const Table kExp3Table  = ArenaSaveGame::makeDecodeTable(kExp3Codec);
+const Table kGold0Table = ArenaSaveGame::makeDecodeTable(kGold0Codec);
+const Table kGold1Table = ArenaSaveGame::makeDecodeTable(kGold1Codec);
+const Table kGold2Table = ArenaSaveGame::makeDecodeTable(kGold2Codec);
+const Table kGold3Table = ArenaSaveGame::makeDecodeTable(kGold3Codec);
+const Table kBless0Table = ArenaSaveGame::makeDecodeTable(kBless0Codec);
+const Table kBless1Table = ArenaSaveGame::makeDecodeTable(kBless1Codec);
+
+// Gold (dword at 0x041E) and blessing (word at 0x0422) are adjacent, so they are
+// decoded as one 6-byte region.
+constexpr qsizetype kGoldBlessingOffset = 0x041E;
+const Table* const kGoldBlessingTables[] = {&kGold0Table, &kGold1Table,  &kGold2Table,
+                                            &kGold3Table, &kBless0Table, &kBless1Table};
 }  // namespace
 
 ArenaSaveGame::ArenaSaveGame(const QString& saveFile, const GameArena* game)
@@ -103,7 +130,9 @@ QString ArenaSaveGame::getGameDetails() const
 {
   QStringList lines;
 
-  if (m_Gold > 0) {
+  if (!m_HasGold && !m_IsEmptySlot) {
+    lines << QString("Gold: unknown");
+  } else if (m_Gold > 0) {
     lines << QString("Gold: %1").arg(m_Gold);
   }
   if (m_Experience > 0) {
@@ -173,73 +202,82 @@ QStringList ArenaSaveGame::allFiles() const
   return files;
 }
 
-bool ArenaSaveGame::parseSaveEngn()
+XngineSaveGame::Metadata ArenaSaveGame::metadata() const
 {
-  QFile f(m_SaveFile);
-  if (!f.open(QIODevice::ReadOnly)) {
-    m_IsEmptySlot = true;
-    m_PCName = "Empty";
-    return false;
+  Metadata meta = XngineSaveGame::metadata();
+  // Empty slots carry the "Empty" placeholder from parseSaveEngn(); drop it so they are
+  // not grouped under a character of that name. Real character names are kept: the
+  // NAMES.DAT slot label only ever goes to m_DisplayName.
+  if (m_IsEmptySlot) {
+    meta.characterName.clear();
+  }
+  if (m_HasGold) {
+    meta.gold = m_Gold;
   }
-  m_SaveEngnData = f.readAll();
-  if (m_SaveEngnData.isEmpty()) {
+  return meta;
+}
+
+bool ArenaSaveGame::parseSaveEngn()
+{
+  const XngineSaveView view(m_SaveFile);
+  if (!view.isOpen() || view.isEmpty()) {
     m_IsEmptySlot = true;
     m_PCName = "Empty";
     return false;
   }
 
-  bool anyNonZero = false;
-  for (const char c : m_SaveEngnData) {
-    if (static_cast<unsigned char>(c) != 0) {
-      anyNonZero = true;
-      break;
-    }
-  }
-  if (!anyNonZero) {
+  if (view.allZero()) {
     m_IsEmptySlot = true;
     m_PCName = "Empty";
     m_PCLevel = 0;
     m_Level = 0;
     m_Gold = 0;
+    m_HasGold = true;
     m_Experience = 0;
     m_BlessingRaw = 0;
     m_BlessingScaled = 0.0;
     return true;
   }
 
+  const QByteArray data = view.bytes();
+
   quint8 levelScrambled = 0;
-  if (readByte(0x06, levelScrambled)) {
-    const quint8 levelRaw = decodeByte(levelScrambled, kLevelCodec);
+  if (view.readU8(0x06, levelScrambled)) {
+    const quint8 levelRaw = kLevelTable[levelScrambled];
     m_Level = static_cast<quint16>(levelRaw) + 1;
     m_PCLevel = m_Level;
   }
 
   bool ok = false;
-  m_Experience = decodeDword(m_SaveEngnData, 0x0409, kExp0Codec, kExp1Codec, kExp2Codec,
-                             kExp3Codec, &ok);
+  m_Experience = decodeDword(data, 0x0409, kExp0Table, kExp1Table, kExp2Table,
+                             kExp3Table, &ok);
   if (!ok) {
     m_Experience = 0;
   }
 
-  ok = false;
-  m_Gold = decodeDword(m_SaveEngnData, 0x041E, kGold0Codec, kGold1Codec, kGold2Codec,
-                       kGold3Codec, &ok);
-  if (!ok) {
+  std::array<quint8, std::size(kGoldBlessingTables)> goldBlessing{};
+  if (decodeRegion(data, kGoldBlessingOffset, goldBlessing.size(), kGoldBlessingTables,
+                   std::size(kGoldBlessingTables), goldBlessing.data())) {
+    m_Gold = static_cast<quint32>(goldBlessing[0]) |
+             (static_cast<quint32>(goldBlessing[1]) << 8) |
+             (static_cast<quint32>(goldBlessing[2]) << 16) |
+             (static_cast<quint32>(goldBlessing[3]) << 24);
+    m_HasGold = true;
+    m_BlessingRaw = static_cast<quint16>(goldBlessing[4]) |
+                    (static_cast<quint16>(goldBlessing[5]) << 8);
+  } else {
+    // Cut short before 0x0424: gold is unknown, not zero.
     m_Gold = 0;
-  }
-
-  ok = false;
-  m_BlessingRaw = decodeWord(m_SaveEngnData, 0x0422, kBless0Codec, kBless1Codec, &ok);
-  if (!ok) {
+    m_HasGold = false;
     m_BlessingRaw = 0;
   }
   m_BlessingScaled = static_cast<double>(m_BlessingRaw) / 2.56;
 
-  readDword(0x0B90, m_DetailRaw);
-  parseQuestFlags();
+  view.readLE32U(0x0B90, m_DetailRaw);
+  parseQuestFlags(view);
 
   if (m_PCName.isEmpty()) {
-    const QString extracted = extractLikelyPersonName(m_SaveEngnData);
+    const QString extracted = extractLikelyPersonName(data);
     if (!extracted.isEmpty()) {
       m_PCName = extracted;
     }
@@ -249,19 +287,13 @@ bool ArenaSaveGame::parseSaveEngn()
 
 bool ArenaSaveGame::parseLog()
 {
-  const QString logPath = companionPath("LOG");
-  QFile f(logPath);
-  if (!f.open(QIODevice::ReadOnly)) {
-    return false;
-  }
-
-  const QByteArray data = f.readAll();
-  if (data.isEmpty()) {
+  const XngineSaveView view(companionPath("LOG"));
+  if (view.isEmpty()) {
     return false;
   }
 
   const QRegularExpression entryRe("(?s)&(.*?) \\*");
-  QRegularExpressionMatchIterator it = entryRe.globalMatch(QString::fromLocal8Bit(data));
+  QRegularExpressionMatchIterator it = entryRe.globalMatch(QString::fromLocal8Bit(view.bytes()));
 
   QString last;
   while (it.hasNext()) {
@@ -282,9 +314,8 @@ bool ArenaSaveGame::parseLog()
 
 bool ArenaSaveGame::parseSpells()
 {
-  const QString spellsPath = companionPath("SPELLS");
-  QFileInfo fi(spellsPath);
-  if (!fi.exists() || !fi.isFile()) {
+  const XngineSaveView view(companionPath("SPELLS"));
+  if (!view.isOpen()) {
     return false;
   }
   constexpr qint64 kSpellRecordSize = 85;
@@ -292,54 +323,38 @@ bool ArenaSaveGame::parseSpells()
   constexpr qsizetype kSpellNameOffset = 0x34;
   constexpr qsizetype kSpellNameLength = 33;
   constexpr int kMaxSpellRecords = 32;
-  const qint64 count = fi.size() / kSpellRecordSize;
+  const qint64 count = view.size() / kSpellRecordSize;
   m_SpellRecordCount = static_cast<int>(qMin<qint64>(count, kMaxSpellRecords));
 
-  QFile f(spellsPath);
-  if (!f.open(QIODevice::ReadOnly)) {
-    return true;
-  }
-  const QByteArray data = f.readAll();
   m_SpellActiveCount = 0;
   m_SpellPreview.clear();
+  XngineSaveView::Cursor cursor = view.cursor();
   for (int i = 0; i < m_SpellRecordCount; ++i) {
-    const qsizetype off = static_cast<qsizetype>(i) * kSpellRecordSize;
-    if (off + kSpellRecordSize > data.size()) {
+    const uchar* record = cursor.current();
+    if (!cursor.skip(kSpellRecordSize)) {
       break;
     }
-    bool anyNonZero = false;
-    for (qsizetype j = 0; j < kSpellRecordSize; ++j) {
-      if (static_cast<unsigned char>(data.at(off + j)) != 0) {
-        anyNonZero = true;
-        break;
-      }
-    }
+    const bool anyNonZero = std::any_of(record, record + kSpellRecordSize, [](uchar c) {
+      return c != 0;
+    });
     if (anyNonZero) {
       ++m_SpellActiveCount;
 
-      QString name;
-      if (off + kSpellNameOffset + kSpellNameLength <= data.size()) {
-        QByteArray rawName =
-            data.mid(off + kSpellNameOffset, kSpellNameLength);
-        const int nul = rawName.indexOf('\0');
-        if (nul >= 0) {
-          rawName.truncate(nul);
+      // Name and cost both lie inside the record the cursor just stepped over.
+      QByteArray rawName;
+      rawName.reserve(kSpellNameLength);
+      for (qsizetype j = 0; j < kSpellNameLength; ++j) {
+        const uchar ch = record[kSpellNameOffset + j];
+        if (ch == 0) {
+          break;
         }
-        for (int j = rawName.size() - 1; j >= 0; --j) {
-          const unsigned char ch = static_cast<unsigned char>(rawName.at(j));
-          if (ch < 32 || ch > 126) {
-            rawName.remove(j, 1);
-          }
+        if (ch >= 32 && ch <= 126) {
+          rawName.append(static_cast<char>(ch));
         }
-        name = QString::fromLocal8Bit(rawName).trimmed();
       }
+      QString name = QString::fromLocal8Bit(rawName).trimmed();
 
-      quint16 cost = 0;
-      if (off + kSpellCostOffset + 2 <= data.size()) {
-        const auto* p = reinterpret_cast<const uchar*>(data.constData() + off + kSpellCostOffset);
-        cost = static_cast<quint16>(p[0]) |
-               (static_cast<quint16>(p[1]) << 8);
-      }
+      const quint16 cost = XngineSaveView::loadLE<quint16>(record + kSpellCostOffset);
 
       if (name.isEmpty()) {
         name = QString("slot%1").arg(i + 1);
@@ -355,19 +370,13 @@ bool ArenaSaveGame::parseSpells()
 
 bool ArenaSaveGame::parseCityData()
 {
-  const QString cityPath = companionPath("CITYDATA");
-  QFile f(cityPath);
-  if (!f.open(QIODevice::ReadOnly)) {
-    return false;
-  }
-
-  const QByteArray data = f.readAll();
-  if (data.isEmpty()) {
+  const XngineSaveView view(companionPath("CITYDATA"));
+  if (view.isEmpty()) {
     return false;
   }
 
   if (m_PCLocation.isEmpty()) {
-    const QString location = extractLikelyLocation(data);
+    const QString location = extractLikelyLocation(view.bytes());
     if (!location.isEmpty()) {
       m_PCLocation = location;
     }
@@ -387,26 +396,15 @@ bool ArenaSaveGame::parseNamesDat()
     namesPath = QDir(saveInfo.absolutePath() + "/..").filePath("NAMES.DAT");
   }
 
-  QFile f(namesPath);
-  if (!f.open(QIODevice::ReadOnly)) {
-    return false;
-  }
-
+  const XngineSaveView names(namesPath);
   constexpr qsizetype kSlotNameBytes = 48;
   constexpr qsizetype kSlotCount = 10;
-  const QByteArray names = f.readAll();
   if (names.size() < (kSlotNameBytes * kSlotCount)) {
     return false;
   }
 
   const qsizetype offset = static_cast<qsizetype>(m_Slot) * kSlotNameBytes;
-  QByteArray raw = names.mid(offset, kSlotNameBytes);
-  const int nul = raw.indexOf('\0');
-  if (nul >= 0) {
-    raw.truncate(nul);
-  }
-
-  QString slotName = QString::fromLocal8Bit(raw).trimmed();
+  QString slotName = names.readFixedString(offset, kSlotNameBytes);
   if (slotName.compare("EMPTY", Qt::CaseInsensitive) == 0) {
     slotName.clear();
   }
@@ -418,97 +416,65 @@ bool ArenaSaveGame::parseNamesDat()
   return !slotName.isEmpty();
 }
 
-bool ArenaSaveGame::readByte(qsizetype offset, quint8& out) const
+ArenaSaveGame::DecodeTable ArenaSaveGame::makeDecodeTable(const NibbleCodec& codec)
 {
-  if (offset < 0 || offset >= m_SaveEngnData.size()) {
-    return false;
-  }
-  out = static_cast<quint8>(m_SaveEngnData.at(offset));
-  return true;
+  // Invert each 16-entry nibble map once; scanning from the top keeps the lowest
+  // index on duplicates and leaves unmapped nibbles at 0, as the scalar lookup did.
+  std::array<quint8, 16> left{};
+  std::array<quint8, 16> right{};
+  for (int i = 15; i >= 0; --i) {
+    left[codec.left[static_cast<size_t>(i)] & 0x0F] = static_cast<quint8>(i);
+    right[codec.right[static_cast<size_t>(i)] & 0x0F] = static_cast<quint8>(i);
+  }
+
+  DecodeTable table{};
+  for (int scrambled = 0; scrambled < 256; ++scrambled) {
+    table[static_cast<size_t>(scrambled)] =
+        static_cast<quint8>((left[static_cast<size_t>(scrambled >> 4)] << 4) |
+                            right[static_cast<size_t>(scrambled & 0x0F)]);
+  }
+  return table;
 }
 
-bool ArenaSaveGame::readDword(qsizetype offset, quint32& out) const
+bool ArenaSaveGame::decodeRegion(const QByteArray& data, qsizetype offset, qsizetype length,
+                                 const DecodeTable* const* tables, qsizetype tableCount,
+                                 quint8* out)
 {
-  if (offset < 0 || offset + 4 > m_SaveEngnData.size()) {
+  if (offset < 0 || length < 0 || tableCount <= 0 || offset > data.size() - length) {
     return false;
   }
-  const auto* p = reinterpret_cast<const uchar*>(m_SaveEngnData.constData() + offset);
-  out = static_cast<quint32>(p[0]) | (static_cast<quint32>(p[1]) << 8) |
-        (static_cast<quint32>(p[2]) << 16) | (static_cast<quint32>(p[3]) << 24);
-  return true;
-}
 
-bool ArenaSaveGame::readWord(qsizetype offset, quint16& out) const
-{
-  if (offset < 0 || offset + 2 > m_SaveEngnData.size()) {
-    return false;
-  }
-  const auto* p = reinterpret_cast<const uchar*>(m_SaveEngnData.constData() + offset);
-  out = static_cast<quint16>(p[0]) | (static_cast<quint16>(p[1]) << 8);
-  return true;
-}
-
-quint8 ArenaSaveGame::decodeNibble(quint8 scrambled, const std::array<quint8, 16>& map)
-{
-  for (quint8 i = 0; i < 16; ++i) {
-    if (map[static_cast<size_t>(i)] == scrambled) {
-      return i;
+  const auto* src = reinterpret_cast<const uchar*>(data.constData() + offset);
+  if (tableCount == 1) {
+    const DecodeTable& table = *tables[0];
+    for (qsizetype i = 0; i < length; ++i) {
+      out[i] = table[src[i]];
     }
-  }
-  return 0;
-}
-
-quint8 ArenaSaveGame::decodeByte(quint8 scrambled, const NibbleCodec& codec)
-{
-  const quint8 leftScr = static_cast<quint8>((scrambled >> 4) & 0x0F);
-  const quint8 rightScr = static_cast<quint8>(scrambled & 0x0F);
-  const quint8 left = decodeNibble(leftScr, codec.left);
-  const quint8 right = decodeNibble(rightScr, codec.right);
-  return static_cast<quint8>((left << 4) | right);
-}
-
-quint32 ArenaSaveGame::decodeDword(const QByteArray& data, qsizetype offset, const NibbleCodec& b0,
-                                   const NibbleCodec& b1, const NibbleCodec& b2,
-                                   const NibbleCodec& b3, bool* ok)
-{
-  if (ok != nullptr) {
-    *ok = false;
-  }
-  if (offset < 0 || offset + 4 > data.size()) {
-    return 0;
+    return true;
   }
 
-  const quint8 d0 = decodeByte(static_cast<quint8>(data.at(offset + 0)), b0);
-  const quint8 d1 = decodeByte(static_cast<quint8>(data.at(offset + 1)), b1);
-  const quint8 d2 = decodeByte(static_cast<quint8>(data.at(offset + 2)), b2);
-  const quint8 d3 = decodeByte(static_cast<quint8>(data.at(offset + 3)), b3);
-
-  if (ok != nullptr) {
-    *ok = true;
+  for (qsizetype i = 0; i < length; ++i) {
+    out[i] = (*tables[i % tableCount])[src[i]];
   }
-
-  return static_cast<quint32>(d0) | (static_cast<quint32>(d1) << 8) |
-         (static_cast<quint32>(d2) << 16) | (static_cast<quint32>(d3) << 24);
+  return true;
 }
 
-quint16 ArenaSaveGame::decodeWord(const QByteArray& data, qsizetype offset, const NibbleCodec& b0,
-                                  const NibbleCodec& b1, bool* ok)
+quint32 ArenaSaveGame::decodeDword(const QByteArray& data, qsizetype offset,
+                                   const DecodeTable& b0, const DecodeTable& b1,
+                                   const DecodeTable& b2, const DecodeTable& b3, bool* ok)
 {
+  const DecodeTable* const tables[] = {&b0, &b1, &b2, &b3};
+  quint8 d[4] = {};
+  const bool decoded = decodeRegion(data, offset, 4, tables, 4, d);
   if (ok != nullptr) {
-    *ok = false;
+    *ok = decoded;
   }
-  if (offset < 0 || offset + 2 > data.size()) {
+  if (!decoded) {
     return 0;
   }
 
-  const quint8 d0 = decodeByte(static_cast<quint8>(data.at(offset + 0)), b0);
-  const quint8 d1 = decodeByte(static_cast<quint8>(data.at(offset + 1)), b1);
-
-  if (ok != nullptr) {
-    *ok = true;
-  }
-
-  return static_cast<quint16>(d0) | (static_cast<quint16>(d1) << 8);
+  return static_cast<quint32>(d[0]) | (static_cast<quint32>(d[1]) << 8) |
+         (static_cast<quint32>(d[2]) << 16) | (static_cast<quint32>(d[3]) << 24);
 }
 
 QString ArenaSaveGame::extractLikelyPersonName(const QByteArray& data)
@@ -631,19 +597,19 @@ void ArenaSaveGame::detectSlotFromFilename()
   m_SaveNumber = static_cast<unsigned long>(slot);
 }
 
-void ArenaSaveGame::parseQuestFlags()
+void ArenaSaveGame::parseQuestFlags(const XngineSaveView& view)
 {
   quint8 flag = 0;
-  if (readByte(0x0DD2, flag)) {
+  if (view.readU8(0x0DD2, flag)) {
     m_RiaVisionEnabled = (flag == 0xE8 || flag == 0xE9);
   }
-  if (readByte(0x0DD3, flag)) {
+  if (view.readU8(0x0DD3, flag)) {
     const int pieces = static_cast<int>(flag) - 0xC0;
     if (pieces >= 0 && pieces <= 8) {
       m_StaffPieces = pieces;
     }
   }
-  if (readByte(0x0DDB, flag)) {
+  if (view.readU8(0x0DDB, flag)) {
     m_HasMainQuestItem = (flag == 0x06);
   }
 }
@@ -11,6 +11,7 @@
 #include <array>
 
 class GameArena;
+class XngineSaveView;
 
 class ArenaSaveGame : public XngineSaveGame
 {
@@ -21,11 +22,23 @@ public:
     std::array<quint8, 16> right{};
   };
 
+  // Scrambled byte -> plain byte, built once per NibbleCodec.
+  using DecodeTable = std::array<quint8, 256>;
+
   ArenaSaveGame(const QString& saveFile, const GameArena* game);
 
+  static DecodeTable makeDecodeTable(const NibbleCodec& codec);
+
+  // Decodes `length` bytes at `offset` in one pass, cycling through `tables` per byte
+  // (a single table decodes a uniformly scrambled run).
+  static bool decodeRegion(const QByteArray& data, qsizetype offset, qsizetype length,
+                           const DecodeTable* const* tables, qsizetype tableCount,
+                           quint8* out);
+
   virtual QString getName() const override;
   virtual QString getGameDetails() const override;
   virtual QStringList allFiles() const override;
+  virtual Metadata metadata() const override;
 
 private:
   void resolveSavePath();
@@ -35,40 +48,30 @@ private:
   bool parseNamesDat();
   bool parseCityData();
 
-  bool readByte(qsizetype offset, quint8& out) const;
-  bool readDword(qsizetype offset, quint32& out) const;
-  bool readWord(qsizetype offset, quint16& out) const;
-
-  static quint8 decodeNibble(quint8 scrambled, const std::array<quint8, 16>& map);
-  static quint8 decodeByte(quint8 scrambled, const NibbleCodec& codec);
-
   static quint32 decodeDword(const QByteArray& data, qsizetype offset,
-                             const NibbleCodec& b0, const NibbleCodec& b1,
-                             const NibbleCodec& b2, const NibbleCodec& b3,
+                             const DecodeTable& b0, const DecodeTable& b1,
+                             const DecodeTable& b2, const DecodeTable& b3,
                              bool* ok = nullptr);
-  static quint16 decodeWord(const QByteArray& data, qsizetype offset,
-                            const NibbleCodec& b0, const NibbleCodec& b1,
-                            bool* ok = nullptr);
   static QString extractLikelyPersonName(const QByteArray& data);
   static QString extractLikelyLocation(const QByteArray& data);
 
   QString companionPath(const QString& stem) const;
   QString slotSuffix() const;
   void detectSlotFromFilename();
-  void parseQuestFlags();
+  void parseQuestFlags(const XngineSaveView& view);
 
 private:
   QString m_SaveFile;
   QString m_SaveDir;
   QString m_SlotSuffix;
   const GameArena* m_Game;
-  QByteArray m_SaveEngnData;
 
   int m_Slot = -1;
 
   quint16 m_Level = 0;
   quint32 m_Experience = 0;
   quint32 m_Gold = 0;
+  bool m_HasGold = false;  // false when SAVEENGN ends before the gold field
   quint16 m_BlessingRaw = 0;
   double m_BlessingScaled = 0.0;
 
@@ -1,7 +1,12 @@
 #include "battlespiresavegame.h"
 
+#ifdef XNGINE_HEADLESS
+#include "xngineheadless.h"
+#else
 #include "gamebattlespire.h"
+#endif
 #include "xnginepaletteformat.h"
+#include "xnginesaveview.h"
 
 #include <QDir>
 #include <QFile>
@@ -32,30 +37,6 @@ constexpr bool kLogSaveParsing = false;
 constexpr quint32 kPlayerRecordId = 50000U;  // 0x0000C350
 constexpr quint16 kItemIdGoldPieces = 33;
 
-template <typename T>
-bool readLE(const QByteArray& data, qsizetype offset, T& value)
-{
-  if (offset < 0 || offset + static_cast<qsizetype>(sizeof(T)) > data.size()) {
-    return false;
-  }
-
-  T tmp{};
-  std::memcpy(&tmp, data.constData() + offset, sizeof(T));
-  value = qFromLittleEndian(tmp);
-  return true;
-}
-
-bool readF32LE(const QByteArray& data, qsizetype offset, float& value)
-{
-  quint32 bits = 0;
-  if (!readLE(data, offset, bits)) {
-    return false;
-  }
-  static_assert(sizeof(float) == sizeof(quint32));
-  std::memcpy(&value, &bits, sizeof(float));
-  return true;
-}
-
 bool loadPaletteFromFile(const QString& path, std::array<QColor, 256>& palette)
 {
   XnginePaletteFormat::Document doc;
@@ -165,23 +146,25 @@ QString BattlespireSaveGame::getGameDetails() const
   return lines.join('\n');
 }
 
+XngineSaveGame::Metadata BattlespireSaveGame::metadata() const
+{
+  Metadata meta = XngineSaveGame::metadata();
+  meta.gold = m_Gold;
+  return meta;
+}
+
 std::unique_ptr<XngineSaveGame::DataFields> BattlespireSaveGame::fetchDataFields() const
 {
   auto fields = std::make_unique<DataFields>();
 
-  QFile imageFile(saveFilePath("IMAGE.RAW"));
-  if (!imageFile.open(QIODevice::ReadOnly)) {
-    return fields;
-  }
-
-  QByteArray raw = imageFile.readAll();
+  const XngineSaveView raw(saveFilePath("IMAGE.RAW"));
   if (raw.size() < kImageRawSize8) {
     return fields;
   }
 
   QImage image(static_cast<int>(kImageWidth), static_cast<int>(kImageHeight),
                QImage::Format_RGB32);
-  const auto* ptr = reinterpret_cast<const uchar*>(raw.constData());
+  const uchar* ptr = raw.data();
   if (raw.size() >= kImageRawSize) {
     for (qsizetype y = 0; y < kImageHeight; ++y) {
       for (qsizetype x = 0; x < kImageWidth; ++x) {
@@ -213,22 +196,13 @@ std::unique_ptr<XngineSaveGame::DataFields> BattlespireSaveGame::fetchDataFields
 
 bool BattlespireSaveGame::parseSaveName()
 {
-  QFile saveNameFile(saveFilePath("SAVENAME.DAT"));
-  if (!saveNameFile.open(QIODevice::ReadOnly)) {
+  const XngineSaveView view(saveFilePath("SAVENAME.DAT"));
+  if (view.isEmpty()) {
     return false;
   }
 
-  QByteArray bytes = saveNameFile.read(kSaveNameLength);
-  if (bytes.isEmpty()) {
-    return false;
-  }
-
-  const int nullPos = bytes.indexOf('\0');
-  if (nullPos >= 0) {
-    bytes.truncate(nullPos);
-  }
-
-  const QString saveName = QString::fromLocal8Bit(bytes).trimmed();
+  const QString saveName =
+      view.readFixedString(0, std::min<qsizetype>(view.size(), kSaveNameLength));
   if (!saveName.isEmpty()) {
     m_DisplayName = saveName;
     return true;
@@ -239,23 +213,20 @@ bool BattlespireSaveGame::parseSaveName()
 
 bool BattlespireSaveGame::parseSaveTree()
 {
-  QFile saveTreeFile(saveFilePath("SAVETREE.DAT"));
-  if (!saveTreeFile.open(QIODevice::ReadOnly)) {
-    return false;
-  }
-
-  const QByteArray data = saveTreeFile.readAll();
+  const XngineSaveView data(saveFilePath("SAVETREE.DAT"));
   if (data.size() < 8) {
     return false;
   }
 
-  qsizetype pos = 4;  // 4-byte file version/header
+  XngineSaveView::Cursor cursor = data.cursor(4);  // 4-byte file version/header
   bool foundPlayerRecord = false;
   quint64 goldTotal = 0;
   m_Gold = 0;
-  while (pos + 5 <= data.size()) {
+  while (cursor.remaining() >= 5) {
+    // Record fields below are read at fixed offsets from the record start.
+    const qsizetype pos = cursor.pos();
     quint32 recordLength = 0;
-    if (!readLE(data, pos, recordLength)) {
+    if (!cursor.readLE(recordLength)) {
       break;
     }
     if (recordLength == 0) {
@@ -267,14 +238,14 @@ bool BattlespireSaveGame::parseSaveTree()
       break;
     }
 
-    const quint8 recordType = static_cast<quint8>(data.at(pos + 4));
+    const quint8 recordType = data.data()[pos + 4];
     const qsizetype recordEnd = pos + totalLength;
     auto hasBytes = [recordEnd](qsizetype at, qsizetype size) {
         return at >= 0 && size >= 0 && at + size <= recordEnd;
     };
 
     quint32 recordId = 0;
-    const bool hasRecordId = hasBytes(pos + 33, 4) && readLE(data, pos + 33, recordId);
+    const bool hasRecordId = hasBytes(pos + 33, 4) && data.readLE32U(pos + 33, recordId);
     const bool isPlayerRecordByType = (recordType == kRecordTypePlayer);
     const bool isPlayerRecordById = hasRecordId && (recordId == 50000U);
 
@@ -282,7 +253,7 @@ bool BattlespireSaveGame::parseSaveTree()
       foundPlayerRecord = true;
 
       if (hasBytes(pos + 65, 32)) {
-        const QString name = readFixedString(data, pos + 65, 32);
+        const QString name = data.readFixedString(pos + 65, 32);
         if (!name.isEmpty()) {
           m_PCName = name;
         }
@@ -291,8 +262,8 @@ bool BattlespireSaveGame::parseSaveTree()
       float posX = 0.0F;
       float posY = 0.0F;
       float posZ = 0.0F;
-      if (hasBytes(pos + 11, 12) && readF32LE(data, pos + 11, posX) &&
-          readF32LE(data, pos + 15, posY) && readF32LE(data, pos + 19, posZ) &&
+      if (hasBytes(pos + 11, 12) && data.readF32LE(pos + 11, posX) &&
+          data.readF32LE(pos + 15, posY) && data.readF32LE(pos + 19, posZ) &&
           std::isfinite(posX) && std::isfinite(posY) && std::isfinite(posZ)) {
         m_PositionText = QString("X %1, Y %2, Z %3")
                              .arg(QString::number(posX, 'f', 2))
@@ -301,7 +272,7 @@ bool BattlespireSaveGame::parseSaveTree()
       }
 
       quint32 level = 0;
-      if (hasBytes(pos + 736, 4) && readLE(data, pos + 736, level) && level > 0 &&
+      if (hasBytes(pos + 736, 4) && data.readLE32U(pos + 736, level) && level > 0 &&
           level < 200) {
         m_PCLevel = static_cast<unsigned short>(level);
       }
@@ -310,9 +281,9 @@ bool BattlespireSaveGame::parseSaveTree()
       qint32 woundsMax = 0;
       quint16 sp = 0;
       quint16 spMax = 0;
-      if (hasBytes(pos + 161, 12) && readLE(data, pos + 167, wounds) &&
-          readLE(data, pos + 171, woundsMax) && readLE(data, pos + 161, sp) &&
-          readLE(data, pos + 163, spMax) && woundsMax >= 0) {
+      if (hasBytes(pos + 161, 12) && data.readLE32(pos + 167, wounds) &&
+          data.readLE32(pos + 171, woundsMax) && data.readLE16U(pos + 161, sp) &&
+          data.readLE16U(pos + 163, spMax) && woundsMax >= 0) {
         m_Wounds = wounds;
         m_WoundsMax = woundsMax;
         m_SpellPoints = sp;
@@ -327,14 +298,14 @@ bool BattlespireSaveGame::parseSaveTree()
       quint32 quantity = 0;
       quint32 parentId = 0;
       if (hasBytes(pos + 97, 2) && hasBytes(pos + 127, 4) && hasBytes(pos + 61, 4) &&
-          readLE(data, pos + 97, itemId) && readLE(data, pos + 127, quantity) &&
-          readLE(data, pos + 61, parentId) && itemId == kItemIdGoldPieces &&
+          data.readLE16U(pos + 97, itemId) && data.readLE32U(pos + 127, quantity) &&
+          data.readLE32U(pos + 61, parentId) && itemId == kItemIdGoldPieces &&
           parentId == kPlayerRecordId) {
         goldTotal += quantity;
       }
     }
 
-    pos += totalLength;
+    cursor.seek(pos + totalLength);
   }
 
   m_Gold = static_cast<quint32>(std::min<quint64>(goldTotal, 0xFFFFFFFFULL));
@@ -344,12 +315,7 @@ bool BattlespireSaveGame::parseSaveTree()
 
 bool BattlespireSaveGame::parseSaveVars()
 {
-  QFile saveVarsFile(saveFilePath("SAVEVARS.DAT"));
-  if (!saveVarsFile.open(QIODevice::ReadOnly)) {
-    return false;
-  }
-
-  const QByteArray data = saveVarsFile.readAll();
+  const XngineSaveView data(saveFilePath("SAVEVARS.DAT"));
   if (data.size() < 1072) {
     return false;
   }
@@ -360,8 +326,8 @@ bool BattlespireSaveGame::parseSaveVars()
   // Misc block starts right after the 1052-byte player block.
   quint32 currentLevel = 0;
   qsizetype levelOffset = -1;
-  if (!readLE(data, 1052, currentLevel) || currentLevel == 0 || currentLevel > 100) {
-    if (!readLE(data, 1051, currentLevel)) {
+  if (!data.readLE32U(1052, currentLevel) || currentLevel == 0 || currentLevel > 100) {
+    if (!data.readLE32U(1051, currentLevel)) {
       return false;
     }
     levelOffset = 1051;
@@ -395,7 +361,7 @@ bool BattlespireSaveGame::parseSaveVars()
   return true;
 }
 
-bool BattlespireSaveGame::parsePlayerBlockFromSaveVars(const QByteArray& data)
+bool BattlespireSaveGame::parsePlayerBlockFromSaveVars(const XngineSaveView& data)
 {
   constexpr qsizetype kPlayerBlockSize = 787;
   if (data.size() < kPlayerBlockSize) {
@@ -403,23 +369,23 @@ bool BattlespireSaveGame::parsePlayerBlockFromSaveVars(const QByteArray& data)
   }
 
   // Offsets are SAVETREE player offsets shifted by -65 (header removed).
-  const QString playerName = readFixedString(data, 0, 32);
+  const QString playerName = data.readFixedString(0, 32);
   if (!playerName.isEmpty()) {
     m_PCName = playerName;
   }
 
-  const QString className = readFixedString(data, 378, 24);
+  const QString className = data.readFixedString(378, 24);
   if (!className.isEmpty()) {
     m_ClassName = className;
   }
 
   quint32 level = 0;
-  if (readLE(data, 671, level) && level > 0 && level < 200) {
+  if (data.readLE32U(671, level) && level > 0 && level < 200) {
     m_PCLevel = static_cast<unsigned short>(level);
   }
 
   quint8 race = 0xFF;
-  if (readLE(data, 605, race)) {
+  if (data.readU8(605, race)) {
     m_Race = race;
   }
 
@@ -427,16 +393,16 @@ bool BattlespireSaveGame::parsePlayerBlockFromSaveVars(const QByteArray& data)
   quint16 spMax = 0;
   qint32 wounds = 0;
   qint32 woundsMax = 0;
-  if (readLE(data, 96, sp)) {
+  if (data.readLE16U(96, sp)) {
     m_SpellPoints = sp;
   }
-  if (readLE(data, 98, spMax)) {
+  if (data.readLE16U(98, spMax)) {
     m_SpellPointsMax = spMax;
   }
-  if (readLE(data, 102, wounds)) {
+  if (data.readLE32(102, wounds)) {
     m_Wounds = wounds;
   }
-  if (readLE(data, 106, woundsMax)) {
+  if (data.readLE32(106, woundsMax)) {
     m_WoundsMax = woundsMax;
   }
 
@@ -476,19 +442,3 @@ QString BattlespireSaveGame::levelLocationName(quint32 currentLevel)
     default: return {};
   }
 }
-
-QString BattlespireSaveGame::readFixedString(const QByteArray& data, qsizetype offset,
-                                             qsizetype size)
-{
-  if (offset < 0 || size <= 0 || offset + size > data.size()) {
-    return {};
-  }
-
-  QByteArray bytes = data.mid(offset, size);
-  const int nullPos = bytes.indexOf('\0');
-  if (nullPos >= 0) {
-    bytes.truncate(nullPos);
-  }
-
-  return QString::fromLocal8Bit(bytes).trimmed();
-}
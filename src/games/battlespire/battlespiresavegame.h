@@ -4,6 +4,7 @@
 #include <xnginesavegame.h>
 
 class GameBattlespire;
+class XngineSaveView;
 
 class BattlespireSaveGame : public XngineSaveGame
 {
@@ -12,6 +13,7 @@ public:
   virtual QString getName() const override;
   virtual QString getSaveGroupIdentifier() const override;
   virtual QString getGameDetails() const override;
+  virtual Metadata metadata() const override;
 
 protected:
   virtual std::unique_ptr<DataFields> fetchDataFields() const override;
@@ -20,11 +22,10 @@ private:
   bool parseSaveName();
   bool parseSaveTree();
   bool parseSaveVars();
-  bool parsePlayerBlockFromSaveVars(const QByteArray& data);
+  bool parsePlayerBlockFromSaveVars(const XngineSaveView& data);
   static QString raceName(quint8 raceId);
   static QString levelLocationName(quint32 currentLevel);
   QString saveFilePath(const QString& fileName) const;
-  static QString readFixedString(const QByteArray& data, qsizetype offset, qsizetype size);
 
 private:
   QString m_SaveFolder;
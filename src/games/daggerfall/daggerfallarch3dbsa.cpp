@@ -2,11 +2,16 @@
 #include "daggerfallformatutils.h"
 
 #include "xnginebsaformat.h"
+#include "xngineparallel.h"
 
+#include <algorithm>
+#include <array>
 #include <cmath>
+#include <vector>
 
 namespace {
 
+using Daggerfall::FormatUtil::appendWarning;
 using Daggerfall::FormatUtil::readLE16U;
 using Daggerfall::FormatUtil::readLE32;
 using Daggerfall::FormatUtil::readLE32U;
@@ -68,11 +73,6 @@ struct DVec3
   double z = 0.0;
 };
 
-DVec3 toVec3(const DaggerfallArch3dBsa::Point& p)
-{
-  return {static_cast<double>(p.x), static_cast<double>(p.y), static_cast<double>(p.z)};
-}
-
 DVec3 sub(const DVec3& a, const DVec3& b)
 {
   return {a.x - b.x, a.y - b.y, a.z - b.z};
@@ -83,36 +83,9 @@ double dot(const DVec3& a, const DVec3& b)
   return a.x * b.x + a.y * b.y + a.z * b.z;
 }
 
-bool solvePlaneCoordinates(const DaggerfallArch3dBsa::Point& p0,
-                           const DaggerfallArch3dBsa::Point& p1,
-                           const DaggerfallArch3dBsa::Point& p2,
-                           const DaggerfallArch3dBsa::Point& p,
-                           double& outS, double& outT)
-{
-  const DVec3 a = toVec3(p0);
-  const DVec3 b = toVec3(p1);
-  const DVec3 c = toVec3(p2);
-  const DVec3 q = toVec3(p);
-  const DVec3 e1 = sub(b, a);
-  const DVec3 e2 = sub(c, a);
-  const DVec3 d = sub(q, a);
-
-  const double a11 = dot(e1, e1);
-  const double a12 = dot(e1, e2);
-  const double a22 = dot(e2, e2);
-  const double b1 = dot(d, e1);
-  const double b2 = dot(d, e2);
-  const double det = a11 * a22 - a12 * a12;
-  if (std::abs(det) < 1.0e-12) {
-    return false;
-  }
-
-  outS = (b1 * a22 - b2 * a12) / det;
-  outT = (a11 * b2 - a12 * b1) / det;
-  return true;
-}
-
-bool solveLinear4x4(double a[4][4], double b[4], double x[4])
+// Gauss-Jordan elimination with partial pivoting, applied to both right-hand sides
+// (U and V) at once: the anchor matrix is reduced a single time per plane.
+bool solveLinear4x4(double a[4][4], double b[4][2], double x[4][2])
 {
   for (int col = 0; col < 4; ++col) {
     int pivot = col;
@@ -131,14 +104,16 @@ bool solveLinear4x4(double a[4][4], double b[4], double x[4])
       for (int c = col; c < 4; ++c) {
         std::swap(a[col][c], a[pivot][c]);
       }
-      std::swap(b[col], b[pivot]);
+      std::swap(b[col][0], b[pivot][0]);
+      std::swap(b[col][1], b[pivot][1]);
     }
 
     const double div = a[col][col];
     for (int c = col; c < 4; ++c) {
       a[col][c] /= div;
     }
-    b[col] /= div;
+    b[col][0] /= div;
+    b[col][1] /= div;
 
     for (int r = 0; r < 4; ++r) {
       if (r == col) {
@@ -151,164 +126,275 @@ bool solveLinear4x4(double a[4][4], double b[4], double x[4])
       for (int c = col; c < 4; ++c) {
         a[r][c] -= factor * a[col][c];
       }
-      b[r] -= factor * b[col];
+      b[r][0] -= factor * b[col][0];
+      b[r][1] -= factor * b[col][1];
     }
   }
 
   for (int i = 0; i < 4; ++i) {
-    x[i] = b[i];
+    x[i][0] = b[i][0];
+    x[i][1] = b[i][1];
   }
   return true;
 }
 
-bool solveAffineUvFromFourAnchors(const DaggerfallArch3dBsa::Point& p0,
-                                  const DaggerfallArch3dBsa::Point& p1,
-                                  const DaggerfallArch3dBsa::Point& p2,
-                                  const DaggerfallArch3dBsa::Point& p3,
-                                  double u0, double u1, double u2, double u3,
-                                  double v0, double v1, double v2, double v3,
-                                  double uCoeff[4], double vCoeff[4])
+// u = cu[0] * x + cu[1] * y + cu[2] * z + cu[3], likewise v.
+struct AffineUv
 {
-  double mU[4][4] = {
-      {static_cast<double>(p0.x), static_cast<double>(p0.y), static_cast<double>(p0.z), 1.0},
-      {static_cast<double>(p1.x), static_cast<double>(p1.y), static_cast<double>(p1.z), 1.0},
-      {static_cast<double>(p2.x), static_cast<double>(p2.y), static_cast<double>(p2.z), 1.0},
-      {static_cast<double>(p3.x), static_cast<double>(p3.y), static_cast<double>(p3.z), 1.0},
-  };
-  double rhsU[4] = {u0, u1, u2, u3};
-  if (!solveLinear4x4(mU, rhsU, uCoeff)) {
+  double cu[4] = {};
+  double cv[4] = {};
+};
+
+bool solveAffineUvFromFourAnchors(const DVec3 anchors[4], const double u[4], const double v[4],
+                                  AffineUv& out)
+{
+  double m[4][4];
+  double rhs[4][2];
+  for (int i = 0; i < 4; ++i) {
+    m[i][0] = anchors[i].x;
+    m[i][1] = anchors[i].y;
+    m[i][2] = anchors[i].z;
+    m[i][3] = 1.0;
+    rhs[i][0] = u[i];
+    rhs[i][1] = v[i];
+  }
+  double coeff[4][2];
+  if (!solveLinear4x4(m, rhs, coeff)) {
     return false;
   }
-
-  double mV[4][4] = {
-      {static_cast<double>(p0.x), static_cast<double>(p0.y), static_cast<double>(p0.z), 1.0},
-      {static_cast<double>(p1.x), static_cast<double>(p1.y), static_cast<double>(p1.z), 1.0},
-      {static_cast<double>(p2.x), static_cast<double>(p2.y), static_cast<double>(p2.z), 1.0},
-      {static_cast<double>(p3.x), static_cast<double>(p3.y), static_cast<double>(p3.z), 1.0},
-  };
-  double rhsV[4] = {v0, v1, v2, v3};
-  return solveLinear4x4(mV, rhsV, vCoeff);
+  for (int i = 0; i < 4; ++i) {
+    out.cu[i] = coeff[i][0];
+    out.cv[i] = coeff[i][1];
+  }
+  return true;
 }
 
-void evalAffineUv(const DaggerfallArch3dBsa::Point& p, const double coeff[4],
-                  double& outValue)
+// Fallback frame for planes whose four anchors are degenerate: plane coordinates
+// (s, t) relative to the first triangle, with the 2x2 normal matrix precomputed.
+// Evaluated per point relative to the origin, exactly as before batching: folding it
+// into global affine coefficients rounds differently on half-texel UVs.
+struct TriangleUv
 {
-  outValue = coeff[0] * static_cast<double>(p.x) +
-             coeff[1] * static_cast<double>(p.y) +
-             coeff[2] * static_cast<double>(p.z) + coeff[3];
-}
+  DVec3 origin;
+  DVec3 e1;
+  DVec3 e2;
+  double a11 = 0.0;
+  double a12 = 0.0;
+  double a22 = 0.0;
+  double det = 0.0;
+  double u0 = 0.0;
+  double v0 = 0.0;
+  double du1 = 0.0;
+  double dv1 = 0.0;
+  double du2 = 0.0;
+  double dv2 = 0.0;
+};
 
-void finalizePlaneUv(DaggerfallArch3dBsa::Plane& plane,
-                     const QVector<DaggerfallArch3dBsa::Point>& points,
-                     QString& warning)
+// All Affine4 points of a mesh, in structure-of-arrays form with each point's plane
+// coefficients expanded alongside it, so evaluation is one branch-free loop the
+// compiler can vectorize.
+struct AffineBatch
 {
-  const int count = plane.points.size();
-  if (count <= 0) {
-    return;
+  std::vector<double> x, y, z;
+  std::array<std::vector<double>, 4> cu;
+  std::array<std::vector<double>, 4> cv;
+  std::vector<double> outU, outV;
+  std::vector<DaggerfallArch3dBsa::PlanePoint*> targets;
+
+  void reserve(size_t n)
+  {
+    x.reserve(n);
+    y.reserve(n);
+    z.reserve(n);
+    for (int i = 0; i < 4; ++i) {
+      cu[i].reserve(n);
+      cv[i].reserve(n);
+    }
+    targets.reserve(n);
   }
 
-  // 0: absolute, 1: delta from 0, 2: delta from 1, 3: absolute.
-  plane.points[0].uAbsolute = plane.points[0].u;
-  plane.points[0].vAbsolute = plane.points[0].v;
+  void add(const DVec3& p, const AffineUv& coeff, DaggerfallArch3dBsa::PlanePoint* target)
+  {
+    x.push_back(p.x);
+    y.push_back(p.y);
+    z.push_back(p.z);
+    for (int i = 0; i < 4; ++i) {
+      cu[i].push_back(coeff.cu[i]);
+      cv[i].push_back(coeff.cv[i]);
+    }
+    targets.push_back(target);
+  }
+
+  void evaluate()
+  {
+    const size_t n = targets.size();
+    outU.resize(n);
+    outV.resize(n);
+    const double* __restrict px = x.data();
+    const double* __restrict py = y.data();
+    const double* __restrict pz = z.data();
+    const double* __restrict u0 = cu[0].data();
+    const double* __restrict u1 = cu[1].data();
+    const double* __restrict u2 = cu[2].data();
+    const double* __restrict u3 = cu[3].data();
+    const double* __restrict v0 = cv[0].data();
+    const double* __restrict v1 = cv[1].data();
+    const double* __restrict v2 = cv[2].data();
+    const double* __restrict v3 = cv[3].data();
+    double* __restrict ou = outU.data();
+    double* __restrict ov = outV.data();
+    for (size_t i = 0; i < n; ++i) {
+      ou[i] = u0[i] * px[i] + u1[i] * py[i] + u2[i] * pz[i] + u3[i];
+      ov[i] = v0[i] * px[i] + v1[i] * py[i] + v2[i] * pz[i] + v3[i];
+    }
+    for (size_t i = 0; i < n; ++i) {
+      targets[i]->uAbsolute = static_cast<qint32>(std::llround(ou[i]));
+      targets[i]->vAbsolute = static_cast<qint32>(std::llround(ov[i]));
+      targets[i]->uvReconstructed = true;
+    }
+  }
+};
 
+// 0: absolute, 1: delta from 0, 2: delta from 1, 3: absolute.
+void decodeAnchorUv(DaggerfallArch3dBsa::PlanePoint* pts, int count)
+{
+  pts[0].uAbsolute = pts[0].u;
+  pts[0].vAbsolute = pts[0].v;
   if (count >= 2) {
-    plane.points[1].uAbsolute = static_cast<qint32>(plane.points[0].uAbsolute) + plane.points[1].u;
-    plane.points[1].vAbsolute = static_cast<qint32>(plane.points[0].vAbsolute) + plane.points[1].v;
+    pts[1].uAbsolute = static_cast<qint32>(pts[0].uAbsolute) + pts[1].u;
+    pts[1].vAbsolute = static_cast<qint32>(pts[0].vAbsolute) + pts[1].v;
   }
   if (count >= 3) {
-    plane.points[2].uAbsolute = static_cast<qint32>(plane.points[1].uAbsolute) + plane.points[2].u;
-    plane.points[2].vAbsolute = static_cast<qint32>(plane.points[1].vAbsolute) + plane.points[2].v;
+    pts[2].uAbsolute = static_cast<qint32>(pts[1].uAbsolute) + pts[2].u;
+    pts[2].vAbsolute = static_cast<qint32>(pts[1].vAbsolute) + pts[2].v;
   }
   if (count >= 4) {
-    plane.points[3].uAbsolute = plane.points[3].u;
-    plane.points[3].vAbsolute = plane.points[3].v;
-  }
-
-  // Reconstruct 5+ from first 4 anchors using affine 3D->UV mapping when possible.
-  bool usedAffine = false;
-  if (count >= 5) {
-    const int i0 = plane.points[0].pointIndex;
-    const int i1 = plane.points[1].pointIndex;
-    const int i2 = plane.points[2].pointIndex;
-    const int i3 = plane.points[3].pointIndex;
-    if (i0 >= 0 && i0 < points.size() &&
-        i1 >= 0 && i1 < points.size() &&
-        i2 >= 0 && i2 < points.size() &&
-        i3 >= 0 && i3 < points.size()) {
-      double uCoeff[4] = {};
-      double vCoeff[4] = {};
-      if (solveAffineUvFromFourAnchors(points.at(i0), points.at(i1), points.at(i2), points.at(i3),
-                                       static_cast<double>(plane.points[0].uAbsolute),
-                                       static_cast<double>(plane.points[1].uAbsolute),
-                                       static_cast<double>(plane.points[2].uAbsolute),
-                                       static_cast<double>(plane.points[3].uAbsolute),
-                                       static_cast<double>(plane.points[0].vAbsolute),
-                                       static_cast<double>(plane.points[1].vAbsolute),
-                                       static_cast<double>(plane.points[2].vAbsolute),
-                                       static_cast<double>(plane.points[3].vAbsolute),
-                                       uCoeff, vCoeff)) {
+    pts[3].uAbsolute = pts[3].u;
+    pts[3].vAbsolute = pts[3].v;
+  }
+}
+
+// Reconstructs UVs for every plane of the mesh. Points 5+ of a plane are derived
+// from the first four anchors (affine 3D->UV map) or, when those are degenerate,
+// from the first triangle; point positions are converted to doubles once per mesh
+// and point indices are validated once per plane point.
+void reconstructMeshUv(DaggerfallArch3dBsa::MeshRecord& mesh)
+{
+  const int pointCount = static_cast<int>(mesh.points.size());
+  std::vector<DVec3> positions(static_cast<size_t>(pointCount));
+  for (int i = 0; i < pointCount; ++i) {
+    const auto& p = mesh.points.at(i);
+    positions[static_cast<size_t>(i)] = {static_cast<double>(p.x), static_cast<double>(p.y),
+                                         static_cast<double>(p.z)};
+  }
+  auto validIndex = [pointCount](int index) {
+    return index >= 0 && index < pointCount;
+  };
+
+  mesh.planesUvAffine4 = 0;
+  mesh.planesUvTriangle3 = 0;
+  mesh.planesUvNone = 0;
+
+  // Points 5+ of every plane are the only ones that can need reconstruction; only
+  // Affine4 planes go through the batch, so this is an upper bound.
+  size_t derived = 0;
+  for (const auto& plane : mesh.planes) {
+    derived += static_cast<size_t>(std::max<qsizetype>(0, plane.points.size() - 4));
+  }
+  AffineBatch batch;
+  batch.reserve(derived);
+  for (auto& plane : mesh.planes) {
+    plane.uvMode = DaggerfallArch3dBsa::UvReconstructionMode::None;
+    const int count = static_cast<int>(plane.points.size());
+    DaggerfallArch3dBsa::PlanePoint* pts = count > 0 ? plane.points.data() : nullptr;
+    if (count > 0) {
+      decodeAnchorUv(pts, count);
+    }
+
+    if (count >= 5 && validIndex(pts[0].pointIndex) && validIndex(pts[1].pointIndex) &&
+        validIndex(pts[2].pointIndex)) {
+      const DVec3 anchors[4] = {positions[static_cast<size_t>(pts[0].pointIndex)],
+                                positions[static_cast<size_t>(pts[1].pointIndex)],
+                                positions[static_cast<size_t>(pts[2].pointIndex)],
+                                validIndex(pts[3].pointIndex)
+                                    ? positions[static_cast<size_t>(pts[3].pointIndex)]
+                                    : DVec3{}};
+
+      const double u[4] = {static_cast<double>(pts[0].uAbsolute),
+                           static_cast<double>(pts[1].uAbsolute),
+                           static_cast<double>(pts[2].uAbsolute),
+                           static_cast<double>(pts[3].uAbsolute)};
+      const double v[4] = {static_cast<double>(pts[0].vAbsolute),
+                           static_cast<double>(pts[1].vAbsolute),
+                           static_cast<double>(pts[2].vAbsolute),
+                           static_cast<double>(pts[3].vAbsolute)};
+      AffineUv coeff;
+      if (validIndex(pts[3].pointIndex) && solveAffineUvFromFourAnchors(anchors, u, v, coeff)) {
         for (int i = 4; i < count; ++i) {
-          const int pi = plane.points[i].pointIndex;
-          if (pi < 0 || pi >= points.size()) {
-            continue;
+          if (validIndex(pts[i].pointIndex)) {
+            batch.add(positions[static_cast<size_t>(pts[i].pointIndex)], coeff, &pts[i]);
           }
-          double u = 0.0;
-          double v = 0.0;
-          evalAffineUv(points.at(pi), uCoeff, u);
-          evalAffineUv(points.at(pi), vCoeff, v);
-          plane.points[i].uAbsolute = static_cast<qint32>(std::llround(u));
-          plane.points[i].vAbsolute = static_cast<qint32>(std::llround(v));
-          plane.points[i].uvReconstructed = true;
         }
-        usedAffine = true;
         plane.uvMode = DaggerfallArch3dBsa::UvReconstructionMode::Affine4;
+      } else {
+        TriangleUv tri;
+        tri.origin = anchors[0];
+        tri.e1 = sub(anchors[1], anchors[0]);
+        tri.e2 = sub(anchors[2], anchors[0]);
+        tri.a11 = dot(tri.e1, tri.e1);
+        tri.a12 = dot(tri.e1, tri.e2);
+        tri.a22 = dot(tri.e2, tri.e2);
+        tri.det = tri.a11 * tri.a22 - tri.a12 * tri.a12;
+        tri.u0 = u[0];
+        tri.v0 = v[0];
+        tri.du1 = static_cast<double>(pts[1].uAbsolute - pts[0].uAbsolute);
+        tri.dv1 = static_cast<double>(pts[1].vAbsolute - pts[0].vAbsolute);
+        tri.du2 = static_cast<double>(pts[2].uAbsolute - pts[0].uAbsolute);
+        tri.dv2 = static_cast<double>(pts[2].vAbsolute - pts[0].vAbsolute);
+
+        if (std::abs(tri.det) >= 1.0e-12) {
+          for (int i = 4; i < count; ++i) {
+            if (!validIndex(pts[i].pointIndex)) {
+              continue;
+            }
+            const DVec3 d = sub(positions[static_cast<size_t>(pts[i].pointIndex)], tri.origin);
+            const double b1 = dot(d, tri.e1);
+            const double b2 = dot(d, tri.e2);
+            const double s = (b1 * tri.a22 - b2 * tri.a12) / tri.det;
+            const double t = (tri.a11 * b2 - tri.a12 * b1) / tri.det;
+            pts[i].uAbsolute =
+                static_cast<qint32>(std::llround(tri.u0 + s * tri.du1 + t * tri.du2));
+            pts[i].vAbsolute =
+                static_cast<qint32>(std::llround(tri.v0 + s * tri.dv1 + t * tri.dv2));
+            pts[i].uvReconstructed = true;
+          }
+        }
+        plane.uvMode = DaggerfallArch3dBsa::UvReconstructionMode::Triangle3;
       }
+    } else if (count >= 5 && mesh.warning.isEmpty()) {
+      mesh.warning = "Some plane UVs could not be reconstructed (invalid point index)";
     }
-  }
 
-  // Fallback: reconstruct 5+ from first triangle in model space.
-  if (count >= 5 && !usedAffine) {
-    const int i0 = plane.points[0].pointIndex;
-    const int i1 = plane.points[1].pointIndex;
-    const int i2 = plane.points[2].pointIndex;
-    if (i0 >= 0 && i0 < points.size() &&
-        i1 >= 0 && i1 < points.size() &&
-        i2 >= 0 && i2 < points.size()) {
-      const auto& p0 = points.at(i0);
-      const auto& p1 = points.at(i1);
-      const auto& p2 = points.at(i2);
-      const double u0 = static_cast<double>(plane.points[0].uAbsolute);
-      const double v0 = static_cast<double>(plane.points[0].vAbsolute);
-      const double du1 = static_cast<double>(plane.points[1].uAbsolute - plane.points[0].uAbsolute);
-      const double dv1 = static_cast<double>(plane.points[1].vAbsolute - plane.points[0].vAbsolute);
-      const double du2 = static_cast<double>(plane.points[2].uAbsolute - plane.points[0].uAbsolute);
-      const double dv2 = static_cast<double>(plane.points[2].vAbsolute - plane.points[0].vAbsolute);
-
-      for (int i = 4; i < count; ++i) {
-        const int pi = plane.points[i].pointIndex;
-        if (pi < 0 || pi >= points.size()) {
-          continue;
-        }
-        double s = 0.0;
-        double t = 0.0;
-        if (!solvePlaneCoordinates(p0, p1, p2, points.at(pi), s, t)) {
-          continue;
-        }
-        const double u = u0 + s * du1 + t * du2;
-        const double v = v0 + s * dv1 + t * dv2;
-        plane.points[i].uAbsolute = static_cast<qint32>(std::llround(u));
-        plane.points[i].vAbsolute = static_cast<qint32>(std::llround(v));
-        plane.points[i].uvReconstructed = true;
-      }
-      plane.uvMode = DaggerfallArch3dBsa::UvReconstructionMode::Triangle3;
-    } else if (warning.isEmpty()) {
-      warning = "Some plane UVs could not be reconstructed (invalid point index)";
+    switch (plane.uvMode) {
+      case DaggerfallArch3dBsa::UvReconstructionMode::Affine4:
+        ++mesh.planesUvAffine4;
+        break;
+      case DaggerfallArch3dBsa::UvReconstructionMode::Triangle3:
+        ++mesh.planesUvTriangle3;
+        break;
+      default:
+        ++mesh.planesUvNone;
+        break;
     }
   }
 
-  for (int i = 0; i < count; ++i) {
-    plane.points[i].uPixels = static_cast<double>(plane.points[i].uAbsolute) / 16.0;
-    plane.points[i].vPixels = static_cast<double>(plane.points[i].vAbsolute) / 16.0;
+  batch.evaluate();
+
+  for (auto& plane : mesh.planes) {
+    for (auto& point : plane.points) {
+      point.uPixels = static_cast<double>(point.uAbsolute) / 16.0;
+      point.vPixels = static_cast<double>(point.vAbsolute) / 16.0;
+    }
   }
 }
 
@@ -433,20 +519,9 @@ bool parseMeshRecordData(const QByteArray& data, quint16 recordId,
       planePos += 8;
     }
 
-    finalizePlaneUv(plane, outMesh.points, outMesh.warning);
-    switch (plane.uvMode) {
-      case DaggerfallArch3dBsa::UvReconstructionMode::Affine4:
-        ++outMesh.planesUvAffine4;
-        break;
-      case DaggerfallArch3dBsa::UvReconstructionMode::Triangle3:
-        ++outMesh.planesUvTriangle3;
-        break;
-      default:
-        ++outMesh.planesUvNone;
-        break;
-    }
     outMesh.planes.push_back(plane);
   }
+  reconstructMeshUv(outMesh);
 
   // Variable-size object-data list.
   qsizetype objectPos = static_cast<qsizetype>(outMesh.objectDataOffset);
@@ -505,11 +580,16 @@ bool parseMeshRecordData(const QByteArray& data, quint16 recordId,
 
 }  // namespace
 
-bool DaggerfallArch3dBsa::listRecordIds(const QString& arch3dBsaPath,
-                                        QVector<quint16>& outRecordIds,
-                                        QString* errorMessage)
+void DaggerfallArch3dBsa::reconstructUv(MeshRecord& mesh)
 {
-  outRecordIds.clear();
+  reconstructMeshUv(mesh);
+}
+
+bool DaggerfallArch3dBsa::Reader::open(const QString& arch3dBsaPath, QString* errorMessage)
+{
+  m_Path.clear();
+  m_Archive = {};
+  m_EntryById.clear();
 
   XngineBSAFormat::Archive archive;
   if (!XngineBSAFormat::readArchive(arch3dBsaPath, archive, errorMessage)) {
@@ -519,34 +599,118 @@ bool DaggerfallArch3dBsa::listRecordIds(const QString& arch3dBsaPath,
     return setError(errorMessage, "ARCH3D.BSA is not a NumberRecord archive");
   }
 
-  outRecordIds.reserve(archive.entries.size());
-  for (const auto& e : archive.entries) {
-    outRecordIds.push_back(e.recordId);
+  m_Archive = std::move(archive);
+  m_EntryById.reserve(m_Archive.entries.size());
+  for (int i = 0; i < m_Archive.entries.size(); ++i) {
+    // First entry wins, matching the linear search this replaces.
+    if (!m_EntryById.contains(m_Archive.entries.at(i).recordId)) {
+      m_EntryById.insert(m_Archive.entries.at(i).recordId, i);
+    }
   }
+  m_Path = arch3dBsaPath;
   return true;
 }
 
-bool DaggerfallArch3dBsa::loadMeshRecord(const QString& arch3dBsaPath, quint16 recordId,
-                                         MeshRecord& outMesh, QString* errorMessage)
+QVector<quint16> DaggerfallArch3dBsa::Reader::recordIds() const
 {
-  XngineBSAFormat::Archive archive;
-  if (!XngineBSAFormat::readArchive(arch3dBsaPath, archive, errorMessage)) {
-    return false;
+  QVector<quint16> ids;
+  ids.reserve(m_Archive.entries.size());
+  for (const auto& e : m_Archive.entries) {
+    ids.push_back(e.recordId);
   }
-  if (archive.type != XngineBSAFormat::IndexType::NumberRecord) {
-    return setError(errorMessage, "ARCH3D.BSA is not a NumberRecord archive");
+  return ids;
+}
+
+bool DaggerfallArch3dBsa::Reader::loadMeshRecord(quint16 recordId, MeshRecord& outMesh,
+                                                 QString* errorMessage) const
+{
+  if (!isOpen()) {
+    return setError(errorMessage, "ARCH3D.BSA is not open");
   }
+  const auto it = m_EntryById.constFind(recordId);
+  if (it == m_EntryById.constEnd()) {
+    return setError(errorMessage, QString("ARCH3D record %1 not found").arg(recordId));
+  }
+  const auto& entry = m_Archive.entries.at(it.value());
+  return parseMeshRecordData(entry.data, entry.recordId, outMesh, errorMessage);
+}
 
-  const XngineBSAFormat::Entry* target = nullptr;
-  for (const auto& e : archive.entries) {
-    if (e.recordId == recordId) {
-      target = &e;
-      break;
+bool DaggerfallArch3dBsa::Reader::loadMeshRecords(const QVector<quint16>& recordIds,
+                                                  QVector<MeshRecord>& outMeshes,
+                                                  QString* warning, QString* errorMessage,
+                                                  int maxThreads) const
+{
+  outMeshes.clear();
+  if (warning != nullptr) {
+    warning->clear();
+  }
+  if (!isOpen()) {
+    return setError(errorMessage, "ARCH3D.BSA is not open");
+  }
+
+  // Parse each distinct id once; repeats share the decoded record.
+  QVector<quint16> unique = recordIds;
+  std::sort(unique.begin(), unique.end());
+  unique.erase(std::unique(unique.begin(), unique.end()), unique.end());
+
+  const int count = static_cast<int>(unique.size());
+  QVector<MeshRecord> meshes(count);
+  QVector<QString> errors(count);
+  // Each job owns its slot, so no locking is needed around the results. Raw
+  // pointers are taken up front so workers never touch the containers themselves.
+  MeshRecord* meshSlots = meshes.data();
+  QString* errorSlots = errors.data();
+  XngineParallel::parallelFor(
+      count,
+      [&](int index) {
+        if (!loadMeshRecord(unique.at(index), meshSlots[index], &errorSlots[index])) {
+          meshSlots[index] = {};
+          if (errorSlots[index].isEmpty()) {
+            errorSlots[index] = "Failed parsing record";
+          }
+        }
+      },
+      maxThreads);
+
+  QString collected;
+  for (int i = 0; i < count; ++i) {
+    if (!errors.at(i).isEmpty()) {
+      appendWarning(collected,
+                    QString("ARCH3D record %1: %2").arg(unique.at(i)).arg(errors.at(i)));
     }
   }
-  if (target == nullptr) {
-    return setError(errorMessage, QString("ARCH3D record %1 not found").arg(recordId));
+  if (warning != nullptr) {
+    *warning = collected;
   }
 
-  return parseMeshRecordData(target->data, target->recordId, outMesh, errorMessage);
+  outMeshes.reserve(recordIds.size());
+  for (const quint16 id : recordIds) {
+    const auto slot = std::lower_bound(unique.cbegin(), unique.cend(), id) - unique.cbegin();
+    outMeshes.push_back(meshes.at(slot));
+  }
+  return true;
+}
+
+bool DaggerfallArch3dBsa::listRecordIds(const QString& arch3dBsaPath,
+                                        QVector<quint16>& outRecordIds,
+                                        QString* errorMessage)
+{
+  outRecordIds.clear();
+
+  Reader reader;
+  if (!reader.open(arch3dBsaPath, errorMessage)) {
+    return false;
+  }
+  outRecordIds = reader.recordIds();
+  return true;
+}
+
+bool DaggerfallArch3dBsa::loadMeshRecord(const QString& arch3dBsaPath, quint16 recordId,
+                                         MeshRecord& outMesh, QString* errorMessage)
+{
+  Reader reader;
+  if (!reader.open(arch3dBsaPath, errorMessage)) {
+    return false;
+  }
+  return reader.loadMeshRecord(recordId, outMesh, errorMessage);
 }
@@ -1,7 +1,10 @@
 #ifndef DAGGERFALL_ARCH3DBSA_H
 #define DAGGERFALL_ARCH3DBSA_H
 
+#include "xnginebsaformat.h"
+
 #include <QByteArray>
+#include <QHash>
 #include <QString>
 #include <QVector>
 #include <QtGlobal>
@@ -92,6 +95,40 @@ public:
     bool isValid() const { return !version.isEmpty(); }
   };
 
+  // Recomputes absolute/pixel UVs, uvMode and the planesUv* counters of every plane
+  // from the decoded anchor UVs and point indices. Loading already does this; it is
+  // public so UV reconstruction can be re-run (and timed) on meshes in memory.
+  static void reconstructUv(MeshRecord& mesh);
+
+  // Holds ARCH3D.BSA in memory so any number of meshes can be decoded from a single
+  // archive read. Const members are safe to call from several threads.
+  class Reader
+  {
+  public:
+    bool open(const QString& arch3dBsaPath, QString* errorMessage = nullptr);
+    bool isOpen() const { return !m_Path.isEmpty(); }
+    QString path() const { return m_Path; }
+
+    QVector<quint16> recordIds() const;
+    bool contains(quint16 recordId) const { return m_EntryById.contains(recordId); }
+
+    bool loadMeshRecord(quint16 recordId, MeshRecord& outMesh,
+                        QString* errorMessage = nullptr) const;
+
+    // Decodes the requested records (repeated ids are parsed once) on a thread pool
+    // (maxThreads <= 0 uses QThread::idealThreadCount(), 1 parses inline).
+    // outMeshes follows the order of recordIds; ids that are missing or fail to
+    // parse leave an invalid MeshRecord and are reported through warning.
+    bool loadMeshRecords(const QVector<quint16>& recordIds, QVector<MeshRecord>& outMeshes,
+                         QString* warning = nullptr, QString* errorMessage = nullptr,
+                         int maxThreads = 0) const;
+
+  private:
+    QString m_Path;
+    XngineBSAFormat::Archive m_Archive;
+    QHash<quint16, int> m_EntryById;
+  };
+
   static bool listRecordIds(const QString& arch3dBsaPath, QVector<quint16>& outRecordIds,
                             QString* errorMessage = nullptr);
 
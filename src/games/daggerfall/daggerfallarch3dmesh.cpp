@@ -0,0 +1,274 @@
+#include "daggerfallarch3dmesh.h"
+#include "daggerfallformatutils.h"
+#include "xnginederivedcache.h"
+
+#include <QDebug>
+#include <QHash>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+namespace {
+
+using Daggerfall::FormatUtil::setError;
+using Cache = XngineDerivedCache;
+
+const Cache::Format kFormat = {{'D', 'F', 'C', 'M'}, 1, "ARCH3D mesh cache", "ARCH3D.BSA"};
+constexpr qsizetype kHeaderSize = Cache::kHeaderSize + 2 + 2 + 4 + 4 + 4;
+constexpr qsizetype kSubmeshSize = 20;
+constexpr qsizetype kVertexSize = 32;
+
+// Exact identity of an emitted vertex inside one submesh.
+struct VertexKey
+{
+  int pointIndex = -1;
+  DaggerfallArch3dBsa::Point normal;  // raw plane normal, so coplanar planes share
+  qint32 u = 0;
+  qint32 v = 0;
+
+  bool operator==(const VertexKey& other) const
+  {
+    return pointIndex == other.pointIndex && normal.x == other.normal.x &&
+           normal.y == other.normal.y && normal.z == other.normal.z && u == other.u &&
+           v == other.v;
+  }
+};
+
+size_t qHash(const VertexKey& key, size_t seed = 0)
+{
+  return qHashMulti(seed, key.pointIndex, key.normal.x, key.normal.y, key.normal.z, key.u,
+                    key.v);
+}
+
+void unitNormal(const DaggerfallArch3dBsa::Point& n, float out[3])
+{
+  const double x = n.x;
+  const double y = n.y;
+  const double z = n.z;
+  const double length = std::sqrt(x * x + y * y + z * z);
+  if (length <= 0.0) {
+    out[0] = out[1] = out[2] = 0.0f;
+    return;
+  }
+  out[0] = static_cast<float>(x / length);
+  out[1] = static_cast<float>(y / length);
+  out[2] = static_cast<float>(z / length);
+}
+
+}  // namespace
+
+DaggerfallArch3dMesh DaggerfallArch3dMesh::build(const DaggerfallArch3dBsa::MeshRecord& mesh)
+{
+  DaggerfallArch3dMesh out;
+  out.recordId = mesh.recordId;
+
+  const int planeCount = static_cast<int>(mesh.planes.size());
+  const int pointCount = static_cast<int>(mesh.points.size());
+  std::vector<int> order(static_cast<size_t>(planeCount));
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&mesh](int a, int b) {
+    return mesh.planes.at(a).textureRaw < mesh.planes.at(b).textureRaw;
+  });
+
+  QHash<VertexKey, quint32> vertexByKey;
+  std::vector<quint32> corners;
+  Submesh* current = nullptr;
+  for (const int planeIndex : order) {
+    const auto& plane = mesh.planes.at(planeIndex);
+    if (current == nullptr || current->textureRaw != plane.textureRaw) {
+      if (current != nullptr && current->indexCount == 0) {
+        // No plane of the previous texture produced a triangle; drop its vertices too.
+        out.vertices.resize(current->firstVertex);
+        out.submeshes.removeLast();
+      }
+      Submesh submesh;
+      submesh.textureRaw = plane.textureRaw;
+      submesh.texture = plane.texture;
+      submesh.firstVertex = static_cast<quint32>(out.vertices.size());
+      submesh.firstIndex = static_cast<quint32>(out.indices.size());
+      out.submeshes.push_back(submesh);
+      current = &out.submeshes.last();
+      vertexByKey.clear();
+    }
+
+    DaggerfallArch3dBsa::Point rawNormal;
+    if (planeIndex < mesh.normals.size()) {
+      rawNormal = mesh.normals.at(planeIndex);
+    }
+    float normal[3] = {};
+    unitNormal(rawNormal, normal);
+
+    corners.clear();
+    for (const auto& point : plane.points) {
+      if (point.pointIndex < 0 || point.pointIndex >= pointCount) {
+        continue;
+      }
+      const VertexKey key{point.pointIndex, rawNormal, point.uAbsolute, point.vAbsolute};
+      auto it = vertexByKey.constFind(key);
+      if (it == vertexByKey.constEnd()) {
+        const auto& p = mesh.points.at(point.pointIndex);
+        Vertex vertex;
+        vertex.position[0] = static_cast<float>(p.x);
+        vertex.position[1] = static_cast<float>(p.y);
+        vertex.position[2] = static_cast<float>(p.z);
+        std::copy(std::begin(normal), std::end(normal), vertex.normal);
+        vertex.uv[0] = static_cast<float>(point.uPixels);
+        vertex.uv[1] = static_cast<float>(point.vPixels);
+        it = vertexByKey.insert(key, static_cast<quint32>(out.vertices.size()));
+        out.vertices.push_back(vertex);
+      }
+      corners.push_back(it.value());
+    }
+
+    // Planes are convex polygons, so a fan from the first corner triangulates them.
+    for (size_t i = 2; i < corners.size(); ++i) {
+      out.indices.push_back(corners[0]);
+      out.indices.push_back(corners[i - 1]);
+      out.indices.push_back(corners[i]);
+    }
+    current->vertexCount = static_cast<quint32>(out.vertices.size()) - current->firstVertex;
+    current->indexCount = static_cast<quint32>(out.indices.size()) - current->firstIndex;
+  }
+  if (current != nullptr && current->indexCount == 0) {
+    out.vertices.resize(current->firstVertex);
+    out.submeshes.removeLast();
+  }
+  return out;
+}
+
+QByteArray DaggerfallArch3dMesh::serialize(const QString& sourceHash) const
+{
+  QByteArray out;
+  out.reserve(kHeaderSize + submeshes.size() * kSubmeshSize + vertices.size() * kVertexSize +
+              indices.size() * 4);
+  Cache::appendHeader(out, kFormat, sourceHash);
+  Cache::appendLE<quint16>(out, recordId);
+  Cache::appendLE<quint16>(out, 0);
+  Cache::appendLE<quint32>(out, static_cast<quint32>(submeshes.size()));
+  Cache::appendLE<quint32>(out, static_cast<quint32>(vertices.size()));
+  Cache::appendLE<quint32>(out, static_cast<quint32>(indices.size()));
+
+  for (const auto& submesh : submeshes) {
+    Cache::appendLE<quint16>(out, submesh.textureRaw);
+    Cache::appendLE<quint16>(out, 0);
+    Cache::appendLE<quint32>(out, submesh.firstVertex);
+    Cache::appendLE<quint32>(out, submesh.vertexCount);
+    Cache::appendLE<quint32>(out, submesh.firstIndex);
+    Cache::appendLE<quint32>(out, submesh.indexCount);
+  }
+  for (const auto& vertex : vertices) {
+    for (const float value : vertex.position) {
+      Cache::appendLE<float>(out, value);
+    }
+    for (const float value : vertex.normal) {
+      Cache::appendLE<float>(out, value);
+    }
+    for (const float value : vertex.uv) {
+      Cache::appendLE<float>(out, value);
+    }
+  }
+  for (const quint32 index : indices) {
+    Cache::appendLE<quint32>(out, index);
+  }
+  return out;
+}
+
+bool DaggerfallArch3dMesh::deserialize(const QByteArray& data, const QString& expectedHash,
+                                       DaggerfallArch3dMesh& outMesh, QString* errorMessage)
+{
+  outMesh = {};
+  const auto* bytes = reinterpret_cast<const uchar*>(data.constData());
+  if (!Cache::checkHeader(bytes, data.size(), kFormat, expectedHash, errorMessage)) {
+    return false;
+  }
+  if (data.size() < kHeaderSize) {
+    return setError(errorMessage, "ARCH3D mesh cache is truncated");
+  }
+
+  const uchar* header = bytes + Cache::kHeaderSize;
+  const quint16 recordId = qFromLittleEndian<quint16>(header);
+  const quint32 submeshCount = qFromLittleEndian<quint32>(header + 4);
+  const quint32 vertexCount = qFromLittleEndian<quint32>(header + 8);
+  const quint32 indexCount = qFromLittleEndian<quint32>(header + 12);
+  const qsizetype expected = kHeaderSize + static_cast<qsizetype>(submeshCount) * kSubmeshSize +
+                             static_cast<qsizetype>(vertexCount) * kVertexSize +
+                             static_cast<qsizetype>(indexCount) * 4;
+  if (data.size() != expected) {
+    return setError(errorMessage, "ARCH3D mesh cache is truncated");
+  }
+
+  DaggerfallArch3dMesh mesh;
+  mesh.recordId = recordId;
+  const uchar* pos = bytes + kHeaderSize;
+  mesh.submeshes.resize(submeshCount);
+  for (auto& submesh : mesh.submeshes) {
+    submesh.textureRaw = qFromLittleEndian<quint16>(pos);
+    submesh.texture.imageIndex = static_cast<int>(submesh.textureRaw & 0x7f);
+    submesh.texture.fileIndex = static_cast<int>(submesh.textureRaw >> 7);
+    submesh.firstVertex = qFromLittleEndian<quint32>(pos + 4);
+    submesh.vertexCount = qFromLittleEndian<quint32>(pos + 8);
+    submesh.firstIndex = qFromLittleEndian<quint32>(pos + 12);
+    submesh.indexCount = qFromLittleEndian<quint32>(pos + 16);
+    if (static_cast<quint64>(submesh.firstVertex) + submesh.vertexCount > vertexCount ||
+        static_cast<quint64>(submesh.firstIndex) + submesh.indexCount > indexCount) {
+      return setError(errorMessage, "ARCH3D mesh cache has an out-of-range submesh");
+    }
+    pos += kSubmeshSize;
+  }
+
+  mesh.vertices.resize(vertexCount);
+  qFromLittleEndian<float>(pos, static_cast<qsizetype>(vertexCount) * 8,
+                           mesh.vertices.data());
+  pos += static_cast<qsizetype>(vertexCount) * kVertexSize;
+
+  mesh.indices.resize(indexCount);
+  qFromLittleEndian<quint32>(pos, indexCount, mesh.indices.data());
+  for (const quint32 index : mesh.indices) {
+    if (index >= vertexCount) {
+      return setError(errorMessage, "ARCH3D mesh cache has an out-of-range index");
+    }
+  }
+
+  outMesh = std::move(mesh);
+  return true;
+}
+
+bool DaggerfallArch3dMesh::load(const DaggerfallArch3dBsa::Reader& reader, quint16 recordId,
+                                DaggerfallArch3dMesh& outMesh, QString* errorMessage)
+{
+  outMesh = {};
+  if (!reader.isOpen()) {
+    return setError(errorMessage, "ARCH3D.BSA is not open");
+  }
+
+  const QString hash = XngineDerivedCache::contentHash(reader.path());
+  const QString cachePath =
+      hash.isEmpty() ? QString()
+                     : XngineDerivedCache::pathFor(QString("dfarch3d-%1").arg(recordId), hash,
+                                                   "mesh");
+  if (!cachePath.isEmpty()) {
+    // Decoded straight from the mapping; deserialize copies into the mesh vectors.
+    const XngineSaveView view(cachePath);
+    if (view.isOpen() && deserialize(view.bytes(), hash, outMesh) &&
+        outMesh.recordId == recordId) {
+      return true;
+    }
+  }
+
+  DaggerfallArch3dBsa::MeshRecord record;
+  if (!reader.loadMeshRecord(recordId, record, errorMessage)) {
+    return false;
+  }
+  outMesh = build(record);
+
+  if (!cachePath.isEmpty()) {
+    QString error;
+    if (!XngineDerivedCache::write(cachePath, outMesh.serialize(hash), &error)) {
+      qWarning().noquote() << "[DaggerfallArch3dMesh] mesh cache not written:" << error;
+    }
+  }
+  return true;
+}
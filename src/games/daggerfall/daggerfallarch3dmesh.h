@@ -0,0 +1,69 @@
+#ifndef DAGGERFALL_ARCH3DMESH_H
+#define DAGGERFALL_ARCH3DMESH_H
+
+#include "daggerfallarch3dbsa.h"
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+/**
+ * Renderer-ready form of an ARCH3D mesh: every plane fan-triangulated into one
+ * interleaved vertex buffer and one index buffer, with the ranges grouped by texture.
+ *
+ * Positions are in ARCH3D model units, normals are the plane normals normalized to
+ * unit length, and UVs are in texture pixels (PlanePoint::uPixels/vPixels), so a
+ * renderer divides by the texture size. Vertices are shared inside a submesh when
+ * point, plane normal and UV all match.
+ *
+ * Cached per ARCH3D.BSA content hash and record id as one file (little-endian):
+ *   header    "DFCM", u32 version, char[40] ARCH3D.BSA SHA-1 (hex),
+ *             u16 recordId, u16 reserved, u32 submeshCount, u32 vertexCount,
+ *             u32 indexCount
+ *   submeshes submeshCount x (u16 textureRaw, u16 reserved, u32 firstVertex,
+ *             u32 vertexCount, u32 firstIndex, u32 indexCount)
+ *   vertices  vertexCount x 8 f32 (position xyz, normal xyz, uv)
+ *   indices   indexCount x u32, relative to the start of the vertex buffer
+ */
+class DaggerfallArch3dMesh
+{
+public:
+  struct Vertex
+  {
+    float position[3] = {};
+    float normal[3] = {};
+    float uv[2] = {};
+  };
+  static_assert(sizeof(Vertex) == 32, "Vertex must stay tightly packed");
+
+  struct Submesh
+  {
+    quint16 textureRaw = 0;
+    DaggerfallArch3dBsa::TextureRef texture;
+    quint32 firstVertex = 0;
+    quint32 vertexCount = 0;
+    quint32 firstIndex = 0;
+    quint32 indexCount = 0;
+  };
+
+  quint16 recordId = 0;
+  QVector<Vertex> vertices;
+  QVector<quint32> indices;
+  QVector<Submesh> submeshes;  // ascending textureRaw
+
+  bool isValid() const { return !indices.isEmpty(); }
+
+  static DaggerfallArch3dMesh build(const DaggerfallArch3dBsa::MeshRecord& mesh);
+
+  QByteArray serialize(const QString& sourceHash) const;
+  static bool deserialize(const QByteArray& data, const QString& expectedHash,
+                          DaggerfallArch3dMesh& outMesh, QString* errorMessage = nullptr);
+
+  // Reads the cached export for recordId, or decodes the record through reader,
+  // builds the export and caches it. Cache failures only cost the rebuild.
+  static bool load(const DaggerfallArch3dBsa::Reader& reader, quint16 recordId,
+                   DaggerfallArch3dMesh& outMesh, QString* errorMessage = nullptr);
+};
+
+#endif  // DAGGERFALL_ARCH3DMESH_H
@@ -0,0 +1,360 @@
+#include "daggerfallblockrefindex.h"
+#include "daggerfallblocksbsa.h"
+#include "daggerfallformatutils.h"
+#include "xnginederivedcache.h"
+
+#include <QDebug>
+#include <QFileInfo>
+#include <QtEndian>
+
+#include <algorithm>
+#include <numeric>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+using Daggerfall::FormatUtil::setError;
+using Kind = DaggerfallBlockReferenceIndex::Kind;
+using Cache = XngineDerivedCache;
+
+const Cache::Format kFormat = {{'D', 'F', 'B', 'R'}, 1, "Block reference cache", "BLOCKS.BSA"};
+constexpr qsizetype kHeaderSize = Cache::kHeaderSize + 4 * 4;
+constexpr qsizetype kBlockRecordSize = 8;
+constexpr qsizetype kKeyRecordSize = 16;
+
+struct Reference
+{
+  quint32 kind = 0;
+  quint32 key = 0;
+  quint32 block = 0;
+
+  bool operator<(const Reference& other) const
+  {
+    return std::tie(kind, key, block) < std::tie(other.kind, other.key, other.block);
+  }
+  bool operator==(const Reference& other) const
+  {
+    return kind == other.kind && key == other.key && block == other.block;
+  }
+};
+
+// RDB model references store the ARCH3D id as up to five ASCII digits.
+bool parseModelId(const DaggerfallBlocksBsa::RdbModelReference& ref, quint32& outId)
+{
+  quint32 id = 0;
+  int digits = 0;
+  for (const char c : ref.modelId) {
+    if (c >= '0' && c <= '9') {
+      id = id * 10u + static_cast<quint32>(c - '0');
+      ++digits;
+    } else if (c != ' ' && c != '\0') {
+      return false;
+    }
+  }
+  outId = id;
+  return digits > 0;
+}
+
+void collectRmbData(const DaggerfallBlocksBsa::RmbBlockData& data, quint32 block,
+                    std::vector<Reference>& out)
+{
+  for (const auto& model : data.models) {
+    out.push_back({static_cast<quint32>(Kind::Model), model.arch3dRecordId(), block});
+  }
+  for (const auto& flat : data.flats) {
+    out.push_back({static_cast<quint32>(Kind::FlatTexture), flat.texture.raw, block});
+  }
+  for (const auto& person : data.persons) {
+    out.push_back({static_cast<quint32>(Kind::FlatTexture), person.texture.raw, block});
+  }
+}
+
+void collectReferences(const DaggerfallBlocksBsa::Record& record, quint32 block,
+                       std::vector<Reference>& out)
+{
+  if (record.type == DaggerfallBlocksBsa::RecordType::RMB) {
+    const auto& rmb = record.rmb;
+    for (const auto& subBlock : rmb.blocks) {
+      collectRmbData(subBlock.exterior, block, out);
+      collectRmbData(subBlock.interior, block, out);
+    }
+    for (const auto& model : rmb.modelList) {
+      out.push_back({static_cast<quint32>(Kind::Model), model.arch3dRecordId(), block});
+    }
+    for (const auto& flat : rmb.flatList) {
+      out.push_back({static_cast<quint32>(Kind::FlatTexture), flat.texture.raw, block});
+    }
+    return;
+  }
+
+  if (record.type != DaggerfallBlocksBsa::RecordType::RDB) {
+    return;
+  }
+
+  const auto& rdb = record.rdb;
+  auto modelIdForObject = [&rdb](const DaggerfallBlocksBsa::RdbObject& object, quint32& outId) {
+    if (object.type != 0x01 || object.dataIndex < 0) {
+      return false;
+    }
+    const quint16 modelIndex = rdb.modelObjects.at(object.dataIndex).modelIndex;
+    return modelIndex < rdb.modelReferenceList.size() &&
+           parseModelId(rdb.modelReferenceList.at(modelIndex), outId);
+  };
+
+  for (const auto& object : rdb.objects) {
+    quint32 modelId = 0;
+    if (modelIdForObject(object, modelId)) {
+      out.push_back({static_cast<quint32>(Kind::Model), modelId, block});
+    } else if (object.type == 0x03 && object.dataIndex >= 0) {
+      out.push_back({static_cast<quint32>(Kind::FlatTexture),
+                     rdb.flatObjects.at(object.dataIndex).texture.raw, block});
+    }
+  }
+
+  for (const auto& link : rdb.actionLinks) {
+    if (!link.targetExists) {
+      continue;
+    }
+    const int target = rdb.objectIndex(link.targetObjectOffset);
+    quint32 modelId = 0;
+    if (target >= 0 && modelIdForObject(rdb.objects.at(target), modelId)) {
+      out.push_back({static_cast<quint32>(Kind::ActionTarget), modelId, block});
+    }
+  }
+}
+
+}  // namespace
+
+bool DaggerfallBlockReferenceIndex::build(const QString& blocksBsaPath,
+                                          const QString& sourceHash, QByteArray& outData,
+                                          QString* errorMessage)
+{
+  outData.clear();
+
+  // Records arrive in completion order; references are collected against a
+  // provisional slot and remapped to name order below so the output is stable.
+  QStringList names;
+  std::vector<Reference> references;
+  int failed = 0;
+  const bool ok = DaggerfallBlocksBsa::visitAll(
+      blocksBsaPath,
+      [&](const DaggerfallBlocksBsa::Record& record, const QString& error) {
+        if (!error.isEmpty()) {
+          ++failed;
+          return true;
+        }
+        const auto slot = static_cast<quint32>(names.size());
+        names.push_back(record.name);
+        collectReferences(record, slot, references);
+        return true;
+      },
+      errorMessage);
+  if (!ok) {
+    return false;
+  }
+  if (failed > 0) {
+    qWarning().noquote() << "[DaggerfallBlockReferenceIndex]" << failed
+                         << "BLOCKS.BSA record(s) could not be parsed and are not indexed";
+  }
+
+  std::vector<quint32> order(static_cast<size_t>(names.size()));
+  std::iota(order.begin(), order.end(), 0u);
+  std::sort(order.begin(), order.end(), [&names](quint32 a, quint32 b) {
+    return names.at(a) < names.at(b);
+  });
+  std::vector<quint32> rank(order.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    rank[order[i]] = static_cast<quint32>(i);
+  }
+  for (auto& reference : references) {
+    reference.block = rank[reference.block];
+  }
+  std::sort(references.begin(), references.end());
+  references.erase(std::unique(references.begin(), references.end()), references.end());
+
+  QByteArray blockTable;
+  QByteArray namePool;
+  blockTable.reserve(static_cast<qsizetype>(order.size()) * kBlockRecordSize);
+  for (const quint32 slot : order) {
+    const QByteArray name = names.at(slot).toLatin1();
+    Cache::appendLE<quint32>(blockTable, static_cast<quint32>(namePool.size()));
+    Cache::appendLE<quint32>(blockTable, static_cast<quint32>(name.size()));
+    namePool.append(name);
+  }
+
+  QByteArray keyTable;
+  QByteArray postings;
+  postings.reserve(static_cast<qsizetype>(references.size()) * 4);
+  quint32 keyCount = 0;
+  for (size_t i = 0; i < references.size();) {
+    size_t end = i;
+    while (end < references.size() && references[end].kind == references[i].kind &&
+           references[end].key == references[i].key) {
+      Cache::appendLE<quint32>(postings, references[end].block);
+      ++end;
+    }
+    Cache::appendLE<quint32>(keyTable, references[i].kind);
+    Cache::appendLE<quint32>(keyTable, references[i].key);
+    Cache::appendLE<quint32>(keyTable, static_cast<quint32>(i));
+    Cache::appendLE<quint32>(keyTable, static_cast<quint32>(end - i));
+    ++keyCount;
+    i = end;
+  }
+
+  outData.reserve(kHeaderSize + blockTable.size() + keyTable.size() + postings.size() +
+                  namePool.size());
+  Cache::appendHeader(outData, kFormat, sourceHash);
+  Cache::appendLE<quint32>(outData, static_cast<quint32>(order.size()));
+  Cache::appendLE<quint32>(outData, static_cast<quint32>(namePool.size()));
+  Cache::appendLE<quint32>(outData, keyCount);
+  Cache::appendLE<quint32>(outData, static_cast<quint32>(references.size()));
+  outData.append(blockTable);
+  outData.append(keyTable);
+  outData.append(postings);
+  outData.append(namePool);
+  return true;
+}
+
+DaggerfallBlockReferenceIndex::DaggerfallBlockReferenceIndex() : Table(kFormat) {}
+
+std::shared_ptr<const DaggerfallBlockReferenceIndex>
+DaggerfallBlockReferenceIndex::forArchive(const QString& blocksBsaPath, QString* errorMessage)
+{
+  static XngineDerivedCache::SharedMemo<DaggerfallBlockReferenceIndex> indexByPath;
+
+  const QString path = QFileInfo(blocksBsaPath).absoluteFilePath();
+  const QString hash = XngineDerivedCache::contentHash(path);
+  if (hash.isEmpty()) {
+    setError(errorMessage, QString("Cannot read %1").arg(blocksBsaPath));
+    return nullptr;
+  }
+
+  // Keyed by content hash too, so a replaced archive at the same path is rebuilt.
+  const QString key = path + QLatin1Char('|') + hash;
+  if (auto cached = indexByPath.find(key)) {
+    return cached;
+  }
+
+  auto index = std::make_shared<DaggerfallBlockReferenceIndex>();
+  const bool ok = index->openOrBuild(
+      XngineDerivedCache::pathFor("dfblocks-refs", hash), hash,
+      [&](QByteArray& bytes, QString* error) { return build(path, hash, bytes, error); },
+      errorMessage);
+  if (!ok) {
+    return nullptr;
+  }
+  return indexByPath.publish(key, index);
+}
+
+bool DaggerfallBlockReferenceIndex::attachLayout(const uchar* data, qsizetype size,
+                                                 QString* errorMessage)
+{
+  m_BlockCount = 0;
+  m_NamePoolSize = 0;
+  m_KeyCount = 0;
+  m_PostingCount = 0;
+
+  if (size < kHeaderSize) {
+    return setError(errorMessage, "Block reference cache is truncated");
+  }
+  const uchar* counts = data + XngineDerivedCache::kHeaderSize;
+  const quint32 blockCount = qFromLittleEndian<quint32>(counts);
+  const quint32 namePoolSize = qFromLittleEndian<quint32>(counts + 4);
+  const quint32 keyCount = qFromLittleEndian<quint32>(counts + 8);
+  const quint32 postingCount = qFromLittleEndian<quint32>(counts + 12);
+  const qsizetype expected = kHeaderSize + static_cast<qsizetype>(blockCount) * kBlockRecordSize +
+                             static_cast<qsizetype>(keyCount) * kKeyRecordSize +
+                             static_cast<qsizetype>(postingCount) * 4 +
+                             static_cast<qsizetype>(namePoolSize);
+  if (size != expected) {
+    return setError(errorMessage, "Block reference cache is truncated");
+  }
+
+  m_BlockCount = blockCount;
+  m_NamePoolSize = namePoolSize;
+  m_KeyCount = keyCount;
+  m_PostingCount = postingCount;
+  return true;
+}
+
+QString DaggerfallBlockReferenceIndex::blockName(qsizetype index) const
+{
+  if (tableData() == nullptr || index < 0 || index >= m_BlockCount) {
+    return {};
+  }
+  const uchar* rec = tableData() + kHeaderSize + index * kBlockRecordSize;
+  const quint32 offset = qFromLittleEndian<quint32>(rec);
+  const quint32 length = qFromLittleEndian<quint32>(rec + 4);
+  if (static_cast<quint64>(offset) + length > m_NamePoolSize) {
+    return {};
+  }
+  const uchar* pool = tableData() + kHeaderSize +
+                      static_cast<qsizetype>(m_BlockCount) * kBlockRecordSize +
+                      static_cast<qsizetype>(m_KeyCount) * kKeyRecordSize +
+                      static_cast<qsizetype>(m_PostingCount) * 4;
+  return QString::fromLatin1(reinterpret_cast<const char*>(pool + offset),
+                             static_cast<qsizetype>(length));
+}
+
+qsizetype DaggerfallBlockReferenceIndex::findKey(Kind kind, quint32 key) const
+{
+  if (tableData() == nullptr) {
+    return -1;
+  }
+  const uchar* keys =
+      tableData() + kHeaderSize + static_cast<qsizetype>(m_BlockCount) * kBlockRecordSize;
+  const quint64 wanted = (static_cast<quint64>(kind) << 32) | key;
+  qsizetype lo = 0;
+  qsizetype hi = m_KeyCount;
+  while (lo < hi) {
+    const qsizetype mid = lo + (hi - lo) / 2;
+    const uchar* rec = keys + mid * kKeyRecordSize;
+    const quint64 probe = (static_cast<quint64>(qFromLittleEndian<quint32>(rec)) << 32) |
+                          qFromLittleEndian<quint32>(rec + 4);
+    if (probe < wanted) {
+      lo = mid + 1;
+    } else if (probe > wanted) {
+      hi = mid;
+    } else {
+      return mid;
+    }
+  }
+  return -1;
+}
+
+qsizetype DaggerfallBlockReferenceIndex::referenceCount(Kind kind, quint32 key) const
+{
+  const qsizetype slot = findKey(kind, key);
+  if (slot < 0) {
+    return 0;
+  }
+  const uchar* rec = tableData() + kHeaderSize +
+                     static_cast<qsizetype>(m_BlockCount) * kBlockRecordSize +
+                     slot * kKeyRecordSize;
+  return qFromLittleEndian<quint32>(rec + 12);
+}
+
+QStringList DaggerfallBlockReferenceIndex::blocksReferencing(Kind kind, quint32 key) const
+{
+  QStringList names;
+  const qsizetype slot = findKey(kind, key);
+  if (slot < 0) {
+    return names;
+  }
+  const uchar* keys =
+      tableData() + kHeaderSize + static_cast<qsizetype>(m_BlockCount) * kBlockRecordSize;
+  const uchar* rec = keys + slot * kKeyRecordSize;
+  const quint32 first = qFromLittleEndian<quint32>(rec + 8);
+  const quint32 count = qFromLittleEndian<quint32>(rec + 12);
+  if (static_cast<quint64>(first) + count > m_PostingCount) {
+    return names;
+  }
+
+  const uchar* postings = keys + static_cast<qsizetype>(m_KeyCount) * kKeyRecordSize;
+  names.reserve(count);
+  for (quint32 i = 0; i < count; ++i) {
+    names.push_back(blockName(qFromLittleEndian<quint32>(postings + (first + i) * 4)));
+  }
+  return names;
+}
@@ -0,0 +1,73 @@
+#ifndef DAGGERFALL_BLOCKREFINDEX_H
+#define DAGGERFALL_BLOCKREFINDEX_H
+
+#include "xnginederivedcache.h"
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <QtGlobal>
+
+#include <memory>
+
+/**
+ * Inverted index from BLOCKS.BSA references to the blocks that contain them:
+ * ARCH3D model IDs (RMB models and RDB model objects), flat textures (RMB
+ * flats/people and RDB flats) and the models targeted by RDB actions.
+ *
+ * Built once per BLOCKS.BSA content hash with DaggerfallBlocksBsa::visitAll and
+ * stored as a derived cache file:
+ *   header    "DFBR", u32 version, char[40] BLOCKS.BSA SHA-1 (hex),
+ *             u32 blockCount, u32 namePoolSize, u32 keyCount, u32 postingCount
+ *   blocks    blockCount x (u32 nameOffset, u32 nameLength), sorted by name
+ *   keys      keyCount x (u32 kind, u32 key, u32 firstPosting, u32 postingCount),
+ *             sorted by (kind, key)
+ *   postings  postingCount x u32 block index
+ *   names     Latin-1 block names
+ * Queries are a binary search over the key table.
+ */
+class DaggerfallBlockReferenceIndex : public XngineDerivedCache::Table
+{
+public:
+  enum class Kind : quint32
+  {
+    Model = 1,         // ARCH3D record id (modelId1 * 100 + modelId2 for RMB)
+    FlatTexture = 2,   // TextureRef::raw, i.e. (fileIndex << 7) | imageIndex
+    ActionTarget = 3,  // ARCH3D record id of a model an RDB action acts on
+  };
+
+  static quint32 flatTextureKey(int fileIndex, int imageIndex)
+  {
+    return (static_cast<quint32>(fileIndex) << 7) | (static_cast<quint32>(imageIndex) & 0x7f);
+  }
+
+  // Shared index for this archive: mapped from the cache when it matches the
+  // archive contents, otherwise built (and cached) first. Null on failure.
+  static std::shared_ptr<const DaggerfallBlockReferenceIndex>
+  forArchive(const QString& blocksBsaPath, QString* errorMessage = nullptr);
+
+  static bool build(const QString& blocksBsaPath, const QString& sourceHash,
+                    QByteArray& outData, QString* errorMessage = nullptr);
+
+  DaggerfallBlockReferenceIndex();
+
+  qsizetype blockCount() const { return m_BlockCount; }
+  QString blockName(qsizetype index) const;
+
+  QStringList blocksReferencing(Kind kind, quint32 key) const;
+  qsizetype referenceCount(Kind kind, quint32 key) const;
+
+protected:
+  bool attachLayout(const uchar* data, qsizetype size, QString* errorMessage) override;
+
+private:
+  // Index into the key table, or -1.
+  qsizetype findKey(Kind kind, quint32 key) const;
+
+  quint32 m_BlockCount = 0;
+  quint32 m_NamePoolSize = 0;
+  quint32 m_KeyCount = 0;
+  quint32 m_PostingCount = 0;
+};
+
+#endif  // DAGGERFALL_BLOCKREFINDEX_H
@@ -3,8 +3,21 @@
 
 #include "daggerfallcommon.h"
 #include "xnginebsaformat.h"
+#include "xngineparallel.h"
+
+#include <QDateTime>
+#include <QFileInfo>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QStringView>
+#include <QtEndian>
 
 #include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <vector>
 
 namespace {
 
@@ -58,25 +71,47 @@ DaggerfallBlocksBsa::TextureRef decodeTexture(quint16 raw)
   return t;
 }
 
-bool decodeActionData(const QByteArray& rawData, DaggerfallBlocksBsa::RdbAction& action)
+void decodeActionData(DaggerfallBlocksBsa::RdbAction& action)
 {
-  if (rawData.size() < 5) {
-    return false;
-  }
-  action.axis = static_cast<DaggerfallBlocksBsa::RdbAction::Axis>(
-      static_cast<quint8>(rawData.at(0)));
-
-  quint16 duration = 0;
-  quint16 magnitude = 0;
-  if (!readLE16U(rawData, 1, duration) || !readLE16U(rawData, 3, magnitude)) {
-    return false;
-  }
-  action.duration = duration;
-  action.magnitude = magnitude;
+  const auto& rawData = action.rawData;
+  action.axis = static_cast<DaggerfallBlocksBsa::RdbAction::Axis>(rawData[0]);
+  action.duration = qFromLittleEndian<quint16>(rawData.data() + 1);
+  action.magnitude = qFromLittleEndian<quint16>(rawData.data() + 3);
 
   const quint8 t = static_cast<quint8>(action.type);
   action.hasAxisData = (t == 0x01 || t == 0x08 || t == 0x09);
-  return true;
+}
+
+template <typename T>
+int findByOffset(const QVector<T>& sorted, qint32 offset)
+{
+  const auto it = std::lower_bound(sorted.cbegin(), sorted.cend(), offset,
+                                   [](const T& entry, qint32 value) {
+                                     return entry.offset < value;
+                                   });
+  if (it == sorted.cend() || it->offset != offset) {
+    return -1;
+  }
+  return static_cast<int>(it - sorted.cbegin());
+}
+
+// Turns (key, value) pairs into CSR form: values of key k are
+// values[start[k] .. start[k + 1]).
+void buildCsr(int keyCount, const QVector<QPair<int, int>>& pairs, QVector<int>& start,
+              QVector<int>& values)
+{
+  start.fill(0, keyCount + 1);
+  for (const auto& pair : pairs) {
+    ++start[pair.first + 1];
+  }
+  for (int k = 0; k < keyCount; ++k) {
+    start[k + 1] += start[k];
+  }
+  values.resize(pairs.size());
+  QVector<int> cursor(start.cbegin(), start.cend() - 1);
+  for (const auto& pair : pairs) {
+    values[cursor[pair.first]++] = pair.second;
+  }
 }
 
 void fillRdiStats(const QByteArray& data, DaggerfallBlocksBsa::RdiStats& outStats)
@@ -456,22 +491,18 @@ bool parseRdb(const QByteArray& data, DaggerfallBlocksBsa::RdbRecord& outRdb, QS
   }
   cursor += 20;
 
-  outRdb.modelReferenceList.reserve(kRdbModelRefCount);
-  for (int i = 0; i < kRdbModelRefCount; ++i) {
-    DaggerfallBlocksBsa::RdbModelReference ref;
-    ref.modelIdText = QString::fromLatin1(data.constData() + cursor + 0, 5).trimmed();
-    ref.descriptionText = QString::fromLatin1(data.constData() + cursor + 5, 3).trimmed();
-    outRdb.modelReferenceList.push_back(ref);
+  outRdb.modelReferenceList.resize(kRdbModelRefCount);
+  for (auto& ref : outRdb.modelReferenceList) {
+    std::memcpy(ref.modelId.data(), data.constData() + cursor + 0, ref.modelId.size());
+    std::memcpy(ref.description.data(), data.constData() + cursor + 5, ref.description.size());
     cursor += 8;
   }
 
-  outRdb.modelDataList.reserve(kRdbModelRefCount);
+  outRdb.modelDataList.resize(kRdbModelRefCount);
   for (int i = 0; i < kRdbModelRefCount; ++i) {
-    quint32 v = 0;
-    if (!readLE32U(data, cursor, v)) {
+    if (!readLE32U(data, cursor, outRdb.modelDataList[i])) {
       return setError(errorMessage, "Failed parsing RDB model data list");
     }
-    outRdb.modelDataList.push_back(v);
     cursor += 4;
   }
 
@@ -511,29 +542,29 @@ bool parseRdb(const QByteArray& data, DaggerfallBlocksBsa::RdbRecord& outRdb, QS
     return setError(errorMessage, "RDB object root list exceeds record");
   }
 
-  outRdb.objectRootList.reserve(rootCount);
+  outRdb.objectRootList.resize(rootCount);
   for (qsizetype i = 0; i < rootCount; ++i) {
-    qint32 off = -1;
-    if (!readLE32(data, rootListOffset + i * 4, off)) {
+    if (!readLE32(data, rootListOffset + i * 4, outRdb.objectRootList[i])) {
       return setError(errorMessage, "Failed parsing RDB object root list entry");
     }
-    outRdb.objectRootList.push_back(off);
   }
 
-  // Walk linked object lists from every root.
-  QHash<qint32, bool> visited;
+  // Walk linked object lists from every root. Object offsets index into the record,
+  // so the visited set is a bitmap rather than a hash.
+  std::vector<bool> visited(static_cast<size_t>(data.size()), false);
+  QVector<qint32> actionOffsets;
   for (qint32 root : outRdb.objectRootList) {
     qint32 current = root;
     while (current >= 0) {
-      if (visited.contains(current)) {
+      if (current < data.size() && visited[static_cast<size_t>(current)]) {
         break;
       }
-      visited.insert(current, true);
 
       if (current + 25 > data.size()) {
         outRdb.warning = "At least one RDB object points outside record";
         break;
       }
+      visited[static_cast<size_t>(current)] = true;
 
       DaggerfallBlocksBsa::RdbObject obj;
       obj.offset = current;
@@ -545,7 +576,6 @@ bool parseRdb(const QByteArray& data, DaggerfallBlocksBsa::RdbRecord& outRdb, QS
         break;
       }
       obj.type = static_cast<quint8>(data.at(current + 20));
-      outRdb.objects.push_back(obj);
       if (obj.nextOffset >= 0 &&
           static_cast<qsizetype>(obj.nextOffset) + 25 > data.size()) {
         appendWarning(outRdb.warning, "RDB object Next pointer targets invalid offset");
@@ -563,19 +593,13 @@ bool parseRdb(const QByteArray& data, DaggerfallBlocksBsa::RdbRecord& outRdb, QS
             readLE32U(data, dOff + 14, md.triggerFlagStartingLock)) {
           md.soundIndex = static_cast<quint8>(data.at(dOff + 18));
           readLE32(data, dOff + 19, md.actionOffset);
-          outRdb.modelObjects.insert(obj.offset, md);
-          outRdb.objects.back().hasValidData = true;
+          obj.dataIndex = outRdb.modelObjects.size();
+          obj.hasValidData = true;
+          outRdb.modelObjects.push_back(md);
 
           if (md.actionOffset >= 0 &&
               static_cast<qsizetype>(md.actionOffset) + 10 <= data.size()) {
-            DaggerfallBlocksBsa::RdbAction action;
-            const qsizetype aOff = static_cast<qsizetype>(md.actionOffset);
-            action.rawData = data.mid(aOff, 5);
-            readLE32(data, aOff + 5, action.targetOffset);
-            action.type = static_cast<quint8>(data.at(aOff + 9));
-            action.typed = static_cast<DaggerfallBlocksBsa::RdbAction::ActionType>(action.type);
-            decodeActionData(action.rawData, action);
-            outRdb.actions.insert(md.actionOffset, action);
+            actionOffsets.push_back(md.actionOffset);
           }
         }
       } else if (obj.type == 0x02 && dOff + 10 <= data.size()) {
@@ -583,8 +607,9 @@ bool parseRdb(const QByteArray& data, DaggerfallBlocksBsa::RdbRecord& outRdb, QS
         if (readLE32U(data, dOff + 0, ld.unknown1) &&
             readLE32U(data, dOff + 4, ld.unknown2) &&
             readLE16U(data, dOff + 8, ld.unknown3)) {
-          outRdb.lightObjects.insert(obj.offset, ld);
-          outRdb.objects.back().hasValidData = true;
+          obj.dataIndex = outRdb.lightObjects.size();
+          obj.hasValidData = true;
+          outRdb.lightObjects.push_back(ld);
         }
       } else if (obj.type == 0x03 && dOff + 11 <= data.size()) {
         DaggerfallBlocksBsa::RdbFlatData fd;
@@ -593,56 +618,78 @@ bool parseRdb(const QByteArray& data, DaggerfallBlocksBsa::RdbRecord& outRdb, QS
             readLE16U(data, dOff + 2, fd.gender) &&
             readLE16U(data, dOff + 4, fd.factionId)) {
           fd.texture = decodeTexture(tex);
-          fd.unknown = data.mid(dOff + 6, 5);
-          outRdb.flatObjects.insert(obj.offset, fd);
-          outRdb.objects.back().hasValidData = true;
+          std::memcpy(fd.unknown.data(), data.constData() + dOff + 6, fd.unknown.size());
+          obj.dataIndex = outRdb.flatObjects.size();
+          obj.hasValidData = true;
+          outRdb.flatObjects.push_back(fd);
         }
       }
 
+      outRdb.objects.push_back(obj);
       current = obj.nextOffset;
     }
   }
 
+  // Actions shared by several models are decoded once, in offset order.
+  std::sort(actionOffsets.begin(), actionOffsets.end());
+  actionOffsets.erase(std::unique(actionOffsets.begin(), actionOffsets.end()),
+                      actionOffsets.end());
+  outRdb.actions.reserve(actionOffsets.size());
+  for (const qint32 actionOffset : actionOffsets) {
+    DaggerfallBlocksBsa::RdbAction action;
+    const qsizetype aOff = static_cast<qsizetype>(actionOffset);
+    action.offset = actionOffset;
+    std::memcpy(action.rawData.data(), data.constData() + aOff, action.rawData.size());
+    readLE32(data, aOff + 5, action.targetOffset);
+    action.type = static_cast<quint8>(data.at(aOff + 9));
+    action.typed = static_cast<DaggerfallBlocksBsa::RdbAction::ActionType>(action.type);
+    decodeActionData(action);
+    outRdb.actions.push_back(action);
+  }
+
   // Build resolved object index and action graph links.
-  outRdb.objectIndexByOffset.clear();
-  outRdb.objectIndexByOffset.reserve(outRdb.objects.size());
-  for (int i = 0; i < outRdb.objects.size(); ++i) {
-    outRdb.objectIndexByOffset.insert(outRdb.objects.at(i).offset, i);
+  const int objectCount = outRdb.objects.size();
+  outRdb.objectIndexByOffset.resize(objectCount);
+  for (int i = 0; i < objectCount; ++i) {
+    outRdb.objectIndexByOffset[i] = {outRdb.objects.at(i).offset, i};
   }
+  std::sort(outRdb.objectIndexByOffset.begin(), outRdb.objectIndexByOffset.end(),
+            [](const auto& a, const auto& b) {
+              return a.offset < b.offset;
+            });
 
-  outRdb.actionLinks.clear();
-  outRdb.outgoingActionLinksByObject.clear();
-  outRdb.incomingActionLinksByObject.clear();
   int unresolvedActions = 0;
   int unresolvedTargets = 0;
-
-  for (auto it = outRdb.modelObjects.constBegin(); it != outRdb.modelObjects.constEnd(); ++it) {
-    const qint32 sourceOffset = it.key();
-    const auto& md = it.value();
+  QVector<QPair<int, int>> outgoing;
+  QVector<QPair<int, int>> incoming;
+  outgoing.reserve(outRdb.modelObjects.size());
+  incoming.reserve(outRdb.modelObjects.size());
+
+  for (int srcIdx = 0; srcIdx < objectCount; ++srcIdx) {
+    const auto& source = outRdb.objects.at(srcIdx);
+    if (source.type != 0x01 || source.dataIndex < 0) {
+      continue;
+    }
+    const auto& md = outRdb.modelObjects.at(source.dataIndex);
     if (md.actionOffset < 0) {
       continue;
     }
 
     DaggerfallBlocksBsa::RdbRecord::ActionLink link;
-    link.sourceObjectOffset = sourceOffset;
+    link.sourceObjectOffset = source.offset;
+    link.sourceObjectType = source.type;
     link.actionOffset = md.actionOffset;
 
-    const int srcIdx = outRdb.objectIndexByOffset.value(sourceOffset, -1);
-    if (srcIdx >= 0 && srcIdx < outRdb.objects.size()) {
-      link.sourceObjectType = outRdb.objects.at(srcIdx).type;
-    }
-
-    const auto actionIt = outRdb.actions.constFind(md.actionOffset);
-    if (actionIt != outRdb.actions.constEnd()) {
+    if (const auto* action = outRdb.action(md.actionOffset)) {
       link.actionDecoded = true;
-      link.actionType = actionIt.value().type;
-      link.targetObjectOffset = actionIt.value().targetOffset;
+      link.actionType = action->type;
+      link.targetObjectOffset = action->targetOffset;
     } else {
       ++unresolvedActions;
     }
 
-    const int tgtIdx = outRdb.objectIndexByOffset.value(link.targetObjectOffset, -1);
-    if (tgtIdx >= 0 && tgtIdx < outRdb.objects.size()) {
+    const int tgtIdx = outRdb.objectIndex(link.targetObjectOffset);
+    if (tgtIdx >= 0) {
       link.targetExists = true;
       link.targetObjectType = outRdb.objects.at(tgtIdx).type;
     } else if (link.actionDecoded && link.targetObjectOffset >= 0) {
@@ -651,11 +698,14 @@ bool parseRdb(const QByteArray& data, DaggerfallBlocksBsa::RdbRecord& outRdb, QS
 
     const int linkIndex = outRdb.actionLinks.size();
     outRdb.actionLinks.push_back(link);
-    outRdb.outgoingActionLinksByObject[sourceOffset].push_back(linkIndex);
-    if (link.targetExists) {
-      outRdb.incomingActionLinksByObject[link.targetObjectOffset].push_back(linkIndex);
+    outgoing.push_back({srcIdx, linkIndex});
+    if (tgtIdx >= 0) {
+      incoming.push_back({tgtIdx, linkIndex});
     }
   }
+  buildCsr(objectCount, outgoing, outRdb.outgoingLinkStart, outRdb.outgoingLinks);
+  buildCsr(objectCount, incoming, outRdb.incomingLinkStart, outRdb.incomingLinks);
+
   if (unresolvedActions > 0) {
     appendWarning(outRdb.warning,
                   QString("RDB has %1 model action offsets without decodable action records")
@@ -675,20 +725,282 @@ QString rmbPrefixForIndex(quint8 blockIndex)
   return Daggerfall::Data::rmbPrefixForBlockIndex(blockIndex);
 }
 
+bool readBlocksArchive(const QString& blocksBsaPath, XngineBSAFormat::Archive& archive,
+                       QString* errorMessage)
+{
+  if (!XngineBSAFormat::readArchive(blocksBsaPath, archive, errorMessage)) {
+    return false;
+  }
+  if (archive.type != XngineBSAFormat::IndexType::NameRecord) {
+    return setError(errorMessage, "BLOCKS.BSA is not a NameRecord archive");
+  }
+  return true;
+}
+
+bool parseEntry(const XngineBSAFormat::Entry& entry, DaggerfallBlocksBsa::Record& outRecord,
+                QString* errorMessage)
+{
+  using RecordType = DaggerfallBlocksBsa::RecordType;
+
+  outRecord = {};
+  outRecord.name = entry.name;
+  outRecord.type = DaggerfallBlocksBsa::detectType(entry.name);
+  outRecord.raw = entry.data;
+
+  if (outRecord.type == RecordType::RMB) {
+    if (!parseRmb(entry.data, outRecord.rmb, errorMessage)) {
+      return false;
+    }
+  } else if (outRecord.type == RecordType::RDB) {
+    if (!parseRdb(entry.data, outRecord.rdb, errorMessage)) {
+      return false;
+    }
+  } else if (outRecord.type == RecordType::RDI) {
+    outRecord.rdi = entry.data;
+    if (outRecord.rdi.size() != kRdiSize) {
+      return setError(errorMessage,
+                      QString("RDI record size is %1, expected 512").arg(outRecord.rdi.size()));
+    }
+    fillRdiStats(outRecord.rdi, outRecord.rdiStats);
+  }
+
+  return true;
+}
+
+// Parses every entry through XngineParallel::parallelFor. Sink calls are
+// serialized, arrive in completion order and can stop the run by returning false.
+void parseEntriesInParallel(
+    const XngineBSAFormat::Archive& archive, int maxThreads,
+    const std::function<bool(int, const DaggerfallBlocksBsa::Record&, const QString&)>& sink)
+{
+  std::atomic<bool> stop{false};
+  QMutex sinkMutex;
+  XngineParallel::parallelFor(
+      static_cast<int>(archive.entries.size()),
+      [&](int index) {
+        if (stop.load(std::memory_order_relaxed)) {
+          return;
+        }
+        DaggerfallBlocksBsa::Record record;
+        QString error;
+        if (!parseEntry(archive.entries.at(index), record, &error) && error.isEmpty()) {
+          error = "Failed parsing record";
+        }
+
+        QMutexLocker lock(&sinkMutex);
+        if (stop.load(std::memory_order_relaxed)) {
+          return;
+        }
+        if (!sink(index, record, error)) {
+          stop.store(true, std::memory_order_relaxed);
+        }
+      },
+      maxThreads);
+}
+
+// Packs up to 16 ASCII characters, upper-cased, into two words so RMB names can be
+// hashed and compared without building temporary QStrings.
+struct PackedName
+{
+  quint64 lo = 0;
+  quint64 hi = 0;
+
+  bool operator==(const PackedName& other) const { return lo == other.lo && hi == other.hi; }
+};
+
+size_t qHash(const PackedName& key, size_t seed = 0)
+{
+  return ::qHash(key.lo, seed) ^ (::qHash(key.hi, seed) << 1);
+}
+
+bool packUpper(QStringView text, PackedName& out)
+{
+  if (text.size() > 16) {
+    return false;
+  }
+  out = {};
+  for (qsizetype i = 0; i < text.size(); ++i) {
+    const char16_t c = text[i].unicode();
+    if (c == 0 || c > 0x7f) {
+      return false;
+    }
+    const quint64 upper = (c >= 'a' && c <= 'z') ? c - ('a' - 'A') : c;
+    quint64& word = i < 8 ? out.lo : out.hi;
+    word |= upper << ((i % 8) * 8);
+  }
+  return true;
+}
+
+// The fallback match used by resolveExistingRmbName: first four characters and last
+// two characters of the stem (the name without ".RMB").
+bool packStemKey(QStringView stem, PackedName& out)
+{
+  if (stem.size() < 4) {
+    return false;
+  }
+  PackedName prefix;
+  PackedName suffix;
+  if (!packUpper(stem.first(4), prefix) || !packUpper(stem.last(2), suffix)) {
+    return false;
+  }
+  out.lo = prefix.lo | (suffix.lo << 32);
+  out.hi = 0;
+  return true;
+}
+
+bool hasRmbExtension(QStringView name)
+{
+  return name.size() > 4 && name.last(4).compare(u".RMB", Qt::CaseInsensitive) == 0;
+}
+
+// RMB names of one BLOCKS.BSA, built once per archive so block-name resolution is a
+// pair of hash lookups instead of a full archive read and scan per call.
+class RmbNameIndex
+{
+public:
+  explicit RmbNameIndex(const QVector<QString>& names)
+  {
+    for (const auto& name : names) {
+      if (!hasRmbExtension(name)) {
+        continue;
+      }
+      const QString upper = name.toUpper();
+      // Exact matches were case-sensitive against the upper-cased request.
+      PackedName key;
+      if (name == upper && packUpper(name, key)) {
+        m_Exact.insert(key, name);
+      }
+
+      PackedName stemKey;
+      if (!packStemKey(QStringView(upper).chopped(4), stemKey)) {
+        continue;
+      }
+      auto it = m_ByStem.find(stemKey);
+      if (it == m_ByStem.end()) {
+        m_ByStem.insert(stemKey, upper);
+      } else if (upper < it.value()) {
+        it.value() = upper;
+      }
+    }
+  }
+
+  QString resolve(QStringView preferred) const
+  {
+    PackedName key;
+    if (!packUpper(preferred, key)) {
+      return {};
+    }
+    const auto exact = m_Exact.constFind(key);
+    if (exact != m_Exact.constEnd()) {
+      return exact.value();
+    }
+
+    if (preferred.size() < 8 || !preferred.endsWith(u".RMB", Qt::CaseInsensitive)) {
+      return {};
+    }
+    PackedName stemKey;
+    if (!packStemKey(preferred.chopped(4), stemKey)) {
+      return {};
+    }
+    return m_ByStem.value(stemKey);
+  }
+
+private:
+  QHash<PackedName, QString> m_Exact;
+  QHash<PackedName, QString> m_ByStem;
+};
+
+struct RmbNameIndexEntry
+{
+  qint64 size = -1;
+  QDateTime modified;
+  std::shared_ptr<const RmbNameIndex> index;
+};
+
 }  // namespace
 
+QString DaggerfallBlocksBsa::RdbModelReference::modelIdText() const
+{
+  return QString::fromLatin1(modelId.data(), modelId.size()).trimmed();
+}
+
+QString DaggerfallBlocksBsa::RdbModelReference::descriptionText() const
+{
+  return QString::fromLatin1(description.data(), description.size()).trimmed();
+}
+
+int DaggerfallBlocksBsa::RdbRecord::objectIndex(qint32 objectOffset) const
+{
+  const int slot = findByOffset(objectIndexByOffset, objectOffset);
+  return slot >= 0 ? objectIndexByOffset.at(slot).index : -1;
+}
+
+const DaggerfallBlocksBsa::RdbModelData*
+DaggerfallBlocksBsa::RdbRecord::modelData(qint32 objectOffset) const
+{
+  const int i = objectIndex(objectOffset);
+  if (i < 0 || objects.at(i).type != 0x01 || objects.at(i).dataIndex < 0) {
+    return nullptr;
+  }
+  return &modelObjects.at(objects.at(i).dataIndex);
+}
+
+const DaggerfallBlocksBsa::RdbLightData*
+DaggerfallBlocksBsa::RdbRecord::lightData(qint32 objectOffset) const
+{
+  const int i = objectIndex(objectOffset);
+  if (i < 0 || objects.at(i).type != 0x02 || objects.at(i).dataIndex < 0) {
+    return nullptr;
+  }
+  return &lightObjects.at(objects.at(i).dataIndex);
+}
+
+const DaggerfallBlocksBsa::RdbFlatData*
+DaggerfallBlocksBsa::RdbRecord::flatData(qint32 objectOffset) const
+{
+  const int i = objectIndex(objectOffset);
+  if (i < 0 || objects.at(i).type != 0x03 || objects.at(i).dataIndex < 0) {
+    return nullptr;
+  }
+  return &flatObjects.at(objects.at(i).dataIndex);
+}
+
+const DaggerfallBlocksBsa::RdbAction*
+DaggerfallBlocksBsa::RdbRecord::action(qint32 actionOffset) const
+{
+  const int i = findByOffset(actions, actionOffset);
+  return i >= 0 ? &actions.at(i) : nullptr;
+}
+
+std::span<const int> DaggerfallBlocksBsa::RdbRecord::outgoingActionLinks(int objectIndex) const
+{
+  if (objectIndex < 0 || objectIndex + 1 >= outgoingLinkStart.size()) {
+    return {};
+  }
+  return std::span<const int>(outgoingLinks.constData() + outgoingLinkStart.at(objectIndex),
+                              outgoingLinkStart.at(objectIndex + 1) -
+                                  outgoingLinkStart.at(objectIndex));
+}
+
+std::span<const int> DaggerfallBlocksBsa::RdbRecord::incomingActionLinks(int objectIndex) const
+{
+  if (objectIndex < 0 || objectIndex + 1 >= incomingLinkStart.size()) {
+    return {};
+  }
+  return std::span<const int>(incomingLinks.constData() + incomingLinkStart.at(objectIndex),
+                              incomingLinkStart.at(objectIndex + 1) -
+                                  incomingLinkStart.at(objectIndex));
+}
+
 bool DaggerfallBlocksBsa::listRecordNames(const QString& blocksBsaPath,
                                           QVector<QString>& outNames,
                                           QString* errorMessage)
 {
   outNames.clear();
   XngineBSAFormat::Archive archive;
-  if (!XngineBSAFormat::readArchive(blocksBsaPath, archive, errorMessage)) {
+  if (!readBlocksArchive(blocksBsaPath, archive, errorMessage)) {
     return false;
   }
-  if (archive.type != XngineBSAFormat::IndexType::NameRecord) {
-    return setError(errorMessage, "BLOCKS.BSA is not a NameRecord archive");
-  }
 
   outNames.reserve(archive.entries.size());
   for (const auto& e : archive.entries) {
@@ -705,12 +1017,9 @@ bool DaggerfallBlocksBsa::loadRecord(const QString& blocksBsaPath,
   outRecord = {};
 
   XngineBSAFormat::Archive archive;
-  if (!XngineBSAFormat::readArchive(blocksBsaPath, archive, errorMessage)) {
+  if (!readBlocksArchive(blocksBsaPath, archive, errorMessage)) {
     return false;
   }
-  if (archive.type != XngineBSAFormat::IndexType::NameRecord) {
-    return setError(errorMessage, "BLOCKS.BSA is not a NameRecord archive");
-  }
 
   const QString wanted = recordName.toUpper();
   const XngineBSAFormat::Entry* found = nullptr;
@@ -724,27 +1033,59 @@ bool DaggerfallBlocksBsa::loadRecord(const QString& blocksBsaPath,
     return setError(errorMessage, QString("BLOCKS record not found: %1").arg(recordName));
   }
 
-  outRecord.name = found->name;
-  outRecord.type = detectType(found->name);
-  outRecord.raw = found->data;
+  return parseEntry(*found, outRecord, errorMessage);
+}
 
-  if (outRecord.type == RecordType::RMB) {
-    if (!parseRmb(found->data, outRecord.rmb, errorMessage)) {
-      return false;
-    }
-  } else if (outRecord.type == RecordType::RDB) {
-    if (!parseRdb(found->data, outRecord.rdb, errorMessage)) {
-      return false;
-    }
-  } else if (outRecord.type == RecordType::RDI) {
-    outRecord.rdi = found->data;
-    if (outRecord.rdi.size() != kRdiSize) {
-      return setError(errorMessage,
-                      QString("RDI record size is %1, expected 512").arg(outRecord.rdi.size()));
-    }
-    fillRdiStats(outRecord.rdi, outRecord.rdiStats);
+bool DaggerfallBlocksBsa::visitAll(const QString& blocksBsaPath, const RecordVisitor& visitor,
+                                   QString* errorMessage, int maxThreads)
+{
+  XngineBSAFormat::Archive archive;
+  if (!readBlocksArchive(blocksBsaPath, archive, errorMessage)) {
+    return false;
   }
 
+  parseEntriesInParallel(archive, maxThreads,
+                         [&visitor](int, const Record& record, const QString& error) {
+                           return visitor(record, error);
+                         });
+  return true;
+}
+
+bool DaggerfallBlocksBsa::loadAll(const QString& blocksBsaPath, QVector<Record>& outRecords,
+                                  QString* warning, QString* errorMessage, int maxThreads)
+{
+  outRecords.clear();
+
+  XngineBSAFormat::Archive archive;
+  if (!readBlocksArchive(blocksBsaPath, archive, errorMessage)) {
+    return false;
+  }
+
+  // Collect by archive index so the result keeps archive order regardless of which
+  // worker finished first; failed records are dropped and reported as warnings.
+  QVector<Record> byIndex(archive.entries.size());
+  QVector<QString> errors(archive.entries.size());
+  parseEntriesInParallel(archive, maxThreads,
+                         [&](int index, const Record& record, const QString& error) {
+                           if (error.isEmpty()) {
+                             byIndex[index] = record;
+                           } else {
+                             errors[index] = error;
+                           }
+                           return true;
+                         });
+
+  outRecords.reserve(byIndex.size());
+  for (int i = 0; i < byIndex.size(); ++i) {
+    if (!errors.at(i).isEmpty()) {
+      if (warning != nullptr) {
+        appendWarning(*warning,
+                      QString("%1: %2").arg(archive.entries.at(i).name, errors.at(i)));
+      }
+      continue;
+    }
+    outRecords.push_back(std::move(byIndex[i]));
+  }
   return true;
 }
 
@@ -881,41 +1222,27 @@ QString DaggerfallBlocksBsa::resolveExistingRmbName(const QString& blocksBsaPath
                                                     const QString& preferredRmbName,
                                                     QString* errorMessage)
 {
-  QVector<QString> names;
-  if (!listRecordNames(blocksBsaPath, names, errorMessage)) {
-    return {};
-  }
-
-  const QString preferred = preferredRmbName.toUpper();
-  if (std::find(names.begin(), names.end(), preferred) != names.end()) {
-    return preferred;
-  }
-
-  if (!preferred.endsWith(".RMB") || preferred.size() < 8) {
-    return {};
-  }
-  const QString stem = preferred.left(preferred.size() - 4);
-  const QString prefix = stem.left(4);
-  QString suffix;
-  if (stem.size() >= 2) {
-    suffix = stem.right(2);
-  }
-
-  QStringList candidates;
-  for (const auto& name : names) {
-    const QString upper = name.toUpper();
-    if (!upper.endsWith(".RMB")) {
-      continue;
-    }
-    const QString nStem = upper.left(upper.size() - 4);
-    if (nStem.startsWith(prefix) && nStem.endsWith(suffix)) {
-      candidates.push_back(upper);
+  static QMutex cacheMutex;
+  static QHash<QString, RmbNameIndexEntry> indexByPath;
+
+  const QFileInfo info(blocksBsaPath);
+  std::shared_ptr<const RmbNameIndex> index;
+  {
+    QMutexLocker lock(&cacheMutex);
+    auto& entry = indexByPath[blocksBsaPath];
+    if (!entry.index || entry.size != info.size() || entry.modified != info.lastModified()) {
+      QVector<QString> names;
+      if (!listRecordNames(blocksBsaPath, names, errorMessage)) {
+        indexByPath.remove(blocksBsaPath);
+        return {};
+      }
+      entry.size = info.size();
+      entry.modified = info.lastModified();
+      entry.index = std::make_shared<const RmbNameIndex>(names);
     }
+    index = entry.index;
   }
 
-  if (candidates.isEmpty()) {
-    return {};
-  }
-  std::sort(candidates.begin(), candidates.end());
-  return candidates.front();
+  // Names are matched case-insensitively, so the request is not upper-cased first.
+  return index->resolve(preferredRmbName);
 }
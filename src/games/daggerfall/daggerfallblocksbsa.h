@@ -8,6 +8,10 @@
 #include <QVector>
 #include <QtGlobal>
 
+#include <array>
+#include <functional>
+#include <span>
+
 class DaggerfallBlocksBsa
 {
 public:
@@ -166,8 +170,11 @@ public:
 
   struct RdbModelReference
   {
-    QString modelIdText;      // 5 chars
-    QString descriptionText;  // 3 chars
+    std::array<char, 5> modelId{};
+    std::array<char, 3> description{};
+
+    QString modelIdText() const;
+    QString descriptionText() const;
   };
 
   struct RdbObject
@@ -179,6 +186,8 @@ public:
     quint8 type = 0;
     quint32 dataOffset = 0;
     bool hasValidData = false;
+    // Index into RdbRecord::modelObjects/lightObjects/flatObjects, chosen by type.
+    int dataIndex = -1;
   };
 
   struct RdbModelData
@@ -202,7 +211,7 @@ public:
     TextureRef texture;
     quint16 gender = 0;
     quint16 factionId = 0;
-    QByteArray unknown;  // 5 bytes
+    std::array<quint8, 5> unknown{};
   };
 
   struct RdbAction
@@ -247,7 +256,8 @@ public:
       PositiveZ = 0x06
     };
 
-    QByteArray rawData;  // 5 bytes
+    qint32 offset = -1;
+    std::array<quint8, 5> rawData{};
     qint32 targetOffset = -1;
     quint8 type = 0;
     ActionType typed = ActionType::None;
@@ -271,6 +281,15 @@ public:
       bool targetExists = false;
     };
 
+    struct OffsetIndex
+    {
+      qint32 offset = -1;
+      int index = -1;
+    };
+
+    // Flat layout: objects in traversal order, per-kind payloads addressed by
+    // RdbObject::dataIndex, actions sorted by offset, and the action graph as CSR
+    // adjacency (link indices of object i are [start[i], start[i + 1])).
     RdbHeader header;
     QVector<RdbModelReference> modelReferenceList;  // 750
     QVector<quint32> modelDataList;                 // 750
@@ -279,16 +298,29 @@ public:
     QByteArray objectHeaderRaw;                     // 512
     QVector<qint32> objectRootList;                 // width*height
     QVector<RdbObject> objects;
-    QHash<qint32, int> objectIndexByOffset;
-    QHash<qint32, RdbModelData> modelObjects;
-    QHash<qint32, RdbLightData> lightObjects;
-    QHash<qint32, RdbFlatData> flatObjects;
-    QHash<qint32, RdbAction> actions;
+    QVector<OffsetIndex> objectIndexByOffset;  // sorted by offset
+    QVector<RdbModelData> modelObjects;
+    QVector<RdbLightData> lightObjects;
+    QVector<RdbFlatData> flatObjects;
+    QVector<RdbAction> actions;                // sorted by offset
     QVector<ActionLink> actionLinks;
-    QHash<qint32, QVector<int>> outgoingActionLinksByObject;
-    QHash<qint32, QVector<int>> incomingActionLinksByObject;
+    QVector<int> outgoingLinkStart;            // objects.size() + 1 entries
+    QVector<int> outgoingLinks;
+    QVector<int> incomingLinkStart;            // objects.size() + 1 entries
+    QVector<int> incomingLinks;
     QByteArray raw;
     QString warning;
+
+    // Offset lookups are binary searches; -1 / nullptr when absent.
+    int objectIndex(qint32 objectOffset) const;
+    const RdbModelData* modelData(qint32 objectOffset) const;
+    const RdbLightData* lightData(qint32 objectOffset) const;
+    const RdbFlatData* flatData(qint32 objectOffset) const;
+    const RdbAction* action(qint32 actionOffset) const;
+
+    // Indices into actionLinks for the object at objectIndex.
+    std::span<const int> outgoingActionLinks(int objectIndex) const;
+    std::span<const int> incomingActionLinks(int objectIndex) const;
   };
 
   struct RdiStats
@@ -318,6 +350,19 @@ public:
   static bool loadRecord(const QString& blocksBsaPath, const QString& recordName,
                          Record& outRecord, QString* errorMessage = nullptr);
 
+  // Whole-archive parsing: BLOCKS.BSA is read once and records are decoded on a
+  // thread pool (maxThreads <= 0 uses QThread::idealThreadCount()).
+  //
+  // The visitor is never called concurrently, but records arrive in completion
+  // order. errorMessage is empty for records that parsed; return false to stop.
+  using RecordVisitor = std::function<bool(const Record& record, const QString& errorMessage)>;
+  static bool visitAll(const QString& blocksBsaPath, const RecordVisitor& visitor,
+                       QString* errorMessage = nullptr, int maxThreads = 0);
+  // Collects every record that parsed, in archive order; the rest go to warning.
+  static bool loadAll(const QString& blocksBsaPath, QVector<Record>& outRecords,
+                      QString* warning = nullptr, QString* errorMessage = nullptr,
+                      int maxThreads = 0);
+
   static RecordType detectType(const QString& recordName);
   static QString typeName(RecordType type);
   static QString rdbActionTypeName(quint8 actionType);
@@ -6,15 +6,16 @@
 #include <QFile>
 
 #include <algorithm>
+#include <cstring>
 
 namespace {
 
 constexpr int kRows = 500;
 constexpr int kRowWidth = 1001;
+constexpr char kPadValue = static_cast<char>(223);  // fills rows that decode short
 
-}  // namespace
-
-bool DaggerfallClimatePak::load(const QString& filePath, Data& outData, QString* errorMessage)
+bool loadRows(const QString& filePath, DaggerfallClimatePak::Data& outData, bool expand,
+              QString* errorMessage)
 {
   outData = {};
   outData.width = kRowWidth;
@@ -43,8 +44,12 @@ bool DaggerfallClimatePak::load(const QString& filePath, Data& outData, QString*
   QVector<quint32> sorted = outData.offsets;
   std::sort(sorted.begin(), sorted.end());
 
-  outData.rows.resize(kRows);
-  outData.bitmap.reserve(kRows * kRowWidth);
+  if (expand) {
+    outData.rows.resize(kRows);
+    outData.bitmap = QByteArray(static_cast<qsizetype>(kRows) * kRowWidth, Qt::Uninitialized);
+  } else {
+    outData.rowRuns.resize(kRows);
+  }
   for (int row = 0; row < kRows; ++row) {
     const quint32 relStart = outData.offsets.at(row);
     const qsizetype start = dataStart + static_cast<qsizetype>(relStart);
@@ -53,54 +58,70 @@ bool DaggerfallClimatePak::load(const QString& filePath, Data& outData, QString*
                                               QString("CLIMATE.PAK row %1 has invalid offset").arg(row));
     }
 
-    qsizetype end = bytes.size();
-    for (quint32 candidate : sorted) {
-      if (candidate > relStart) {
-        end = dataStart + static_cast<qsizetype>(candidate);
-        break;
-      }
-    }
+    const auto next = std::upper_bound(sorted.cbegin(), sorted.cend(), relStart);
+    const qsizetype end =
+        next != sorted.cend() ? dataStart + static_cast<qsizetype>(*next) : bytes.size();
     if (end <= start || end > bytes.size()) {
       return Daggerfall::FormatUtil::setError(
           errorMessage, QString("CLIMATE.PAK row %1 has invalid run bounds").arg(row));
     }
 
-    const QByteArray packedRow = bytes.mid(start, end - start);
-    QByteArray unpacked;
+    const QByteArrayView packedRow(bytes.constData() + start, end - start);
     QString pakError;
-    if (!DaggerfallPak::decompress(packedRow, unpacked, &pakError)) {
+    const qsizetype unpackedSize = DaggerfallPak::unpackedSize(packedRow, &pakError);
+    if (unpackedSize < 0) {
       return Daggerfall::FormatUtil::setError(errorMessage,
                                               QString("CLIMATE.PAK row %1: %2").arg(row).arg(pakError));
     }
-
-    if (unpacked.size() != kRowWidth) {
+    if (unpackedSize != kRowWidth) {
       Daggerfall::FormatUtil::appendWarning(
           outData.warning, QString("row %1 decompresses to %2 bytes (expected %3)")
-                               .arg(row).arg(unpacked.size()).arg(kRowWidth));
-      if (unpacked.size() < kRowWidth) {
-        unpacked.append(QByteArray(kRowWidth - unpacked.size(), static_cast<char>(223)));
-      } else if (unpacked.size() > kRowWidth) {
-        unpacked.truncate(kRowWidth);
-      }
+                               .arg(row).arg(unpackedSize).arg(kRowWidth));
     }
 
-    outData.rows[row] = unpacked;
-    outData.bitmap.append(unpacked);
+    if (!expand) {
+      DaggerfallPak::RunIndex::build(packedRow, outData.rowRuns[row]);
+      continue;
+    }
+    // Short rows are padded, long rows truncated to the map width.
+    char* dest = outData.bitmap.data() + static_cast<qsizetype>(row) * kRowWidth;
+    if (unpackedSize < kRowWidth) {
+      std::memset(dest + unpackedSize, kPadValue, static_cast<size_t>(kRowWidth - unpackedSize));
+    }
+    DaggerfallPak::decompressInto(packedRow, dest, kRowWidth);
+    outData.rows[row] = QByteArray(dest, kRowWidth);
   }
 
   return true;
 }
 
+}  // namespace
+
+bool DaggerfallClimatePak::load(const QString& filePath, Data& outData, QString* errorMessage)
+{
+  return loadRows(filePath, outData, true, errorMessage);
+}
+
+bool DaggerfallClimatePak::loadRunIndex(const QString& filePath, Data& outData,
+                                        QString* errorMessage)
+{
+  return loadRows(filePath, outData, false, errorMessage);
+}
+
 int DaggerfallClimatePak::valueAt(const Data& data, int x, int y)
 {
-  if (x < 0 || y < 0 || y >= data.rows.size()) {
+  if (x < 0 || y < 0 || x >= data.width) {
     return -1;
   }
-  const QByteArray& row = data.rows.at(y);
-  if (x >= row.size()) {
-    return -1;
+  if (y < data.rows.size()) {
+    const QByteArray& row = data.rows.at(y);
+    return x < row.size() ? static_cast<quint8>(row.at(x)) : -1;
+  }
+  if (y < data.rowRuns.size()) {
+    const int value = data.rowRuns.at(y).valueAt(x);
+    return value >= 0 ? value : static_cast<quint8>(kPadValue);
   }
-  return static_cast<quint8>(row.at(x));
+  return -1;
 }
 
 DaggerfallClimatePak::TextureMapping DaggerfallClimatePak::mappingForValue(int value)
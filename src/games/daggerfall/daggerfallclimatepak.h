@@ -1,6 +1,8 @@
 #ifndef DAGGERFALL_CLIMATEPAK_H
 #define DAGGERFALL_CLIMATEPAK_H
 
+#include "daggerfallpak.h"
+
 #include <QByteArray>
 #include <QString>
 #include <QVector>
@@ -23,11 +25,16 @@ public:
     QVector<quint32> offsets;  // 500 entries
     QVector<QByteArray> rows;  // decompressed rows (1001 bytes each)
     QByteArray bitmap;         // rows concatenated
+    QVector<DaggerfallPak::RunIndex> rowRuns;  // loadRunIndex only, instead of rows/bitmap
     QString warning;
   };
 
   static bool load(const QString& filePath, Data& outData,
                    QString* errorMessage = nullptr);
+  // Keeps each row as a run index instead of expanding the 1001x500 map; valueAt
+  // works on either.
+  static bool loadRunIndex(const QString& filePath, Data& outData,
+                           QString* errorMessage = nullptr);
 
   static int valueAt(const Data& data, int x, int y);
   static TextureMapping mappingForValue(int value);
@@ -34,42 +34,200 @@ bool readLE64U(const QByteArray& data, qsizetype off, quint64& value)
   return true;
 }
 
-bool decodeRleCompressed(const QByteArray& src, int expectedSize, QByteArray& out,
-                         QString* errorMessage)
+// Write cursor over width-wide rows spaced stride bytes apart. Contiguous rows are
+// treated as one long row, so most runs are a single memset/memcpy.
+class RowCursor
 {
-  out.clear();
-  out.reserve(expectedSize);
+public:
+  RowCursor(uchar* dest, int width, int height, qsizetype stride) : m_Row(dest), m_Stride(stride)
+  {
+    if (width <= 0 || height <= 0) {
+      return;
+    }
+    if (stride == width) {
+      m_Width = static_cast<qsizetype>(width) * height;
+      m_Rows = 1;
+    } else {
+      m_Width = width;
+      m_Rows = height;
+    }
+  }
 
-  qsizetype p = 0;
-  while (p < src.size() && out.size() < expectedSize) {
-    const quint8 count = static_cast<quint8>(src.at(p++));
-    if (count == 0xFF) {
-      return setError(errorMessage, "Invalid IMG RLE count value 0xFF");
+  bool done() const { return m_Rows == 0; }
+  qsizetype written() const { return m_Written; }
+  // Drops the next count bytes written, for streams that start mid-run.
+  void skip(qsizetype count) { m_Skip = count; }
+
+  void fill(uchar value, qsizetype count)
+  {
+    const qsizetype dropped = std::min(count, m_Skip);
+    m_Skip -= dropped;
+    count -= dropped;
+    while (count > 0 && m_Rows > 0) {
+      const qsizetype n = std::min(count, m_Width - m_X);
+      std::memset(m_Row + m_X, value, static_cast<size_t>(n));
+      count -= n;
+      advance(n);
+    }
+  }
+
+  void copy(const uchar* from, qsizetype count)
+  {
+    const qsizetype dropped = std::min(count, m_Skip);
+    m_Skip -= dropped;
+    from += dropped;
+    count -= dropped;
+    while (count > 0 && m_Rows > 0) {
+      const qsizetype n = std::min(count, m_Width - m_X);
+      std::memcpy(m_Row + m_X, from, static_cast<size_t>(n));
+      from += n;
+      count -= n;
+      advance(n);
     }
-    if (count > 0x7F) {
-      if (p >= src.size()) {
-        return setError(errorMessage, "Truncated IMG RLE compressed run");
+  }
+
+private:
+  void advance(qsizetype n)
+  {
+    m_X += n;
+    m_Written += n;
+    if (m_X == m_Width) {
+      m_X = 0;
+      if (--m_Rows > 0) {
+        m_Row += m_Stride;
       }
-      const char v = src.at(p++);
-      const int run = static_cast<int>(count) - 127;
-      out.append(QByteArray(run, v));
+    }
+  }
+
+  uchar* m_Row = nullptr;
+  qsizetype m_Stride = 0;
+  qsizetype m_Width = 0;
+  qsizetype m_X = 0;
+  int m_Rows = 0;
+  qsizetype m_Written = 0;
+  qsizetype m_Skip = 0;
+};
+
+struct RleRun
+{
+  bool repeat = false;
+  qsizetype length = 0;
+  const uchar* data = nullptr;  // the repeated byte, or the literal bytes
+};
+
+// Parses the run at p and advances p past it.
+bool nextRleRun(const uchar* src, qsizetype srcSize, qsizetype& p, RleRun& run,
+                QString* errorMessage)
+{
+  const quint8 count = src[p++];
+  if (count == 0xFF) {
+    return setError(errorMessage, "Invalid IMG RLE count value 0xFF");
+  }
+  if (count > 0x7F) {
+    if (p >= srcSize) {
+      return setError(errorMessage, "Truncated IMG RLE compressed run");
+    }
+    run = {true, static_cast<qsizetype>(count) - 127, src + p};
+    p += 1;
+  } else {
+    run = {false, static_cast<qsizetype>(count) + 1, src + p};
+    if (p + run.length > srcSize) {
+      return setError(errorMessage, "Truncated IMG RLE literal run");
+    }
+    p += run.length;
+  }
+  return true;
+}
+
+bool decodeRleSkipping(const char* src, qsizetype srcSize, qsizetype skip, uchar* dest,
+                       int width, int height, qsizetype stride, qsizetype* consumed,
+                       QString* errorMessage)
+{
+  if (consumed != nullptr) {
+    *consumed = 0;
+  }
+  if (width > 0 && height > 0 && stride < width) {
+    return setError(errorMessage, "RLE destination stride is smaller than the row width");
+  }
+
+  RowCursor cursor(dest, width, height, stride);
+  cursor.skip(skip);
+  const auto* s = reinterpret_cast<const uchar*>(src);
+  qsizetype p = 0;
+  RleRun run;
+  while (!cursor.done() && p < srcSize) {
+    if (!nextRleRun(s, srcSize, p, run, errorMessage)) {
+      return false;
+    }
+    if (run.repeat) {
+      cursor.fill(*run.data, run.length);
     } else {
-      const int run = static_cast<int>(count) + 1;
-      if (p + run > src.size()) {
-        return setError(errorMessage, "Truncated IMG RLE literal run");
-      }
-      out.append(src.mid(p, run));
-      p += run;
+      cursor.copy(run.data, run.length);
     }
   }
 
-  if (out.size() < expectedSize) {
+  if (consumed != nullptr) {
+    *consumed = p;
+  }
+  if (!cursor.done()) {
+    const qsizetype expected = static_cast<qsizetype>(width) * height;
     return setError(errorMessage, QString("Decoded %1 bytes, expected %2")
-                                      .arg(out.size())
-                                      .arg(expectedSize));
+                                      .arg(cursor.written())
+                                      .arg(expected));
+  }
+  return true;
+}
+
+bool parseSkyPalette(const QByteArray& bytes, PaletteFile& pal, QString* errorMessage)
+{
+  XnginePaletteFormat::Document palDoc;
+  XnginePaletteFormat::Traits palTraits;
+  palTraits.variant = XnginePaletteFormat::Variant::HeaderedRgb256;
+  palTraits.strictValidation = false;
+  palTraits.allowTrailingPaletteData = false;
+  if (!XnginePaletteFormat::parseBytes(bytes, palDoc, errorMessage, palTraits)) {
+    return false;
+  }
+  pal.isColFile = (palDoc.variant == XnginePaletteFormat::Variant::HeaderedRgb256);
+  pal.colLength = palDoc.headered.length;
+  pal.colMajor = palDoc.headered.major;
+  pal.colMinor = palDoc.headered.minor;
+  pal.colors = palDoc.palette.colors;
+  if (pal.colors.size() > 0) {
+    pal.colors[0].setAlpha(0);
+    for (int c = 1; c < pal.colors.size(); ++c) {
+      pal.colors[c].setAlpha(255);
+    }
   }
-  if (out.size() > expectedSize) {
-    out.truncate(expectedSize);
+  return true;
+}
+
+bool decodeRleCompressed(const QByteArray& src, int expectedSize, QByteArray& out,
+                         QString* errorMessage)
+{
+  out = QByteArray(std::max(0, expectedSize), Qt::Uninitialized);
+  return decodeRle(src.constData(), src.size(), reinterpret_cast<uchar*>(out.data()),
+                   static_cast<int>(out.size()), 1, out.size(), nullptr, errorMessage);
+}
+
+bool parseCfaHeader(const QByteArray& data, CfaFile& out, QString* errorMessage)
+{
+  if (data.size() < 14) {
+    return setError(errorMessage, "CFA file too small");
+  }
+
+  if (!readLE16U(data, 0, out.widthUncompressed) || !readLE16U(data, 2, out.height) ||
+      !readLE16U(data, 4, out.widthCompressed) || !readLE16U(data, 6, out.unknown1) ||
+      !readLE16U(data, 8, out.unknown2)) {
+    return setError(errorMessage, "Failed reading CFA header");
+  }
+  out.bitsPerPixel = static_cast<quint8>(data.at(10));
+  out.frameCount = static_cast<quint8>(data.at(11));
+  if (!readLE16U(data, 12, out.headerSize)) {
+    return setError(errorMessage, "Failed reading CFA header size");
+  }
+  if (out.headerSize >= data.size()) {
+    return setError(errorMessage, "CFA header size exceeds file size");
   }
   return true;
 }
@@ -88,24 +246,76 @@ QByteArray readData(const QString& path, QString* errorMessage)
 
 }  // namespace
 
+bool decodeRle(const char* src, qsizetype srcSize, uchar* dest, int width, int height,
+               qsizetype stride, qsizetype* consumed, QString* errorMessage)
+{
+  return decodeRleSkipping(src, srcSize, 0, dest, width, height, stride, consumed,
+                           errorMessage);
+}
+
+QVector<QRgb> argbColorTable(const PaletteFile& palette)
+{
+  QVector<QRgb> table(256, 0);
+  const int count = static_cast<int>(std::min<qsizetype>(palette.colors.size(), 256));
+  for (int i = 0; i < count; ++i) {
+    const QRgb rgb = palette.colors.at(i).rgb();
+    // Index 0 is the transparent key colour.
+    table[i] = qRgba(qRed(rgb), qGreen(rgb), qBlue(rgb), i == 0 ? 0 : 255);
+  }
+  return table;
+}
+
 QImage toImage(const QByteArray& indexedPixels, int width, int height, const PaletteFile& palette)
 {
-  QImage image(width, height, QImage::Format_ARGB32);
   if (width <= 0 || height <= 0 || palette.colors.size() < 256) {
+    return QImage(width, height, QImage::Format_ARGB32);
+  }
+  return toImage(indexedPixels, width, height, argbColorTable(palette));
+}
+
+QImage toImage(const QByteArray& indexedPixels, int width, int height,
+               const QVector<QRgb>& colorTable)
+{
+  QImage image(width, height, QImage::Format_ARGB32);
+  if (width <= 0 || height <= 0 || colorTable.size() < 256 || image.isNull()) {
     return image;
   }
-  const int pxCount = width * height;
-  for (int i = 0; i < pxCount && i < indexedPixels.size(); ++i) {
-    const int x = i % width;
-    const int y = i / width;
-    const int idx = static_cast<quint8>(indexedPixels.at(i));
-    QColor c = palette.colors.at(idx);
-    if (idx == 0) {
-      c.setAlpha(0);
-    } else {
-      c.setAlpha(255);
+
+  const QRgb* lut = colorTable.constData();
+  const auto* src = reinterpret_cast<const quint8*>(indexedPixels.constData());
+  qsizetype available = indexedPixels.size();
+  for (int y = 0; y < height; ++y) {
+    auto* dst = reinterpret_cast<QRgb*>(image.scanLine(y));
+    const int count = static_cast<int>(std::clamp<qsizetype>(available, 0, width));
+    for (int x = 0; x < count; ++x) {
+      dst[x] = lut[src[x]];
     }
-    image.setPixelColor(x, y, c);
+    // Rows past the end of a short buffer are left transparent.
+    std::fill(dst + count, dst + width, QRgb(0));
+    src += count;
+    available -= count;
+  }
+  return image;
+}
+
+QImage toIndexedImage(const QByteArray& indexedPixels, int width, int height,
+                      const QVector<QRgb>& colorTable)
+{
+  QImage image(width, height, QImage::Format_Indexed8);
+  if (width <= 0 || height <= 0 || image.isNull()) {
+    return image;
+  }
+  image.setColorTable(colorTable.size() >= 256 ? colorTable : QVector<QRgb>(256, 0));
+
+  const char* src = indexedPixels.constData();
+  qsizetype available = indexedPixels.size();
+  for (int y = 0; y < height; ++y) {
+    uchar* dst = image.scanLine(y);
+    const int count = static_cast<int>(std::clamp<qsizetype>(available, 0, width));
+    std::memcpy(dst, src, static_cast<size_t>(count));
+    std::memset(dst + count, 0, static_cast<size_t>(width - count));
+    src += count;
+    available -= count;
   }
   return image;
 }
@@ -115,10 +325,27 @@ QByteArray applyColourTranslation(const QByteArray& indexedPixels, const QByteAr
   if (xlat256.size() < 256) {
     return indexedPixels;
   }
-  QByteArray out = indexedPixels;
-  for (qsizetype i = 0; i < out.size(); ++i) {
-    const quint8 idx = static_cast<quint8>(out.at(i));
-    out[i] = xlat256.at(idx);
+  QByteArray out(indexedPixels.size(), Qt::Uninitialized);
+  const auto* table = reinterpret_cast<const quint8*>(xlat256.constData());
+  const auto* src = reinterpret_cast<const quint8*>(indexedPixels.constData());
+  auto* dst = reinterpret_cast<quint8*>(out.data());
+  const qsizetype size = indexedPixels.size();
+
+  // Byte gathers have no useful SIMD form below AVX-512 VBMI, so the lookup is
+  // unrolled over raw pointers instead: one detach, no per-byte bounds checks.
+  qsizetype i = 0;
+  for (; i + 8 <= size; i += 8) {
+    dst[i + 0] = table[src[i + 0]];
+    dst[i + 1] = table[src[i + 1]];
+    dst[i + 2] = table[src[i + 2]];
+    dst[i + 3] = table[src[i + 3]];
+    dst[i + 4] = table[src[i + 4]];
+    dst[i + 5] = table[src[i + 5]];
+    dst[i + 6] = table[src[i + 6]];
+    dst[i + 7] = table[src[i + 7]];
+  }
+  for (; i < size; ++i) {
+    dst[i] = table[src[i]];
   }
   return out;
 }
@@ -272,12 +499,12 @@ bool loadSkyFile(const QString& path, SkyFile& out, QString* errorMessage)
     return false;
   }
 
-  constexpr qsizetype kPalCount = 32;
-  constexpr qsizetype kPalBytes = 776;
-  constexpr qsizetype kXlatCount = 32;
-  constexpr qsizetype kXlatBytes = 64 * 256;
-  constexpr qsizetype kImgCount = 64;
-  constexpr qsizetype kImgBytes = 512 * 220;
+  constexpr qsizetype kPalCount = SkyStream::kPaletteCount;
+  constexpr qsizetype kPalBytes = SkyStream::kPaletteBytes;
+  constexpr qsizetype kXlatCount = SkyStream::kTranslationCount;
+  constexpr qsizetype kXlatBytes = SkyStream::kTablesPerTranslation * 256;
+  constexpr qsizetype kImgCount = SkyStream::kFrameCount;
+  constexpr qsizetype kImgBytes = SkyStream::kFrameWidth * SkyStream::kFrameHeight;
 
   const qsizetype need = (kPalCount * kPalBytes) + (kXlatCount * kXlatBytes) +
                          (kImgCount * kImgBytes);
@@ -291,27 +518,10 @@ bool loadSkyFile(const QString& path, SkyFile& out, QString* errorMessage)
   out.palettes.reserve(kPalCount);
   for (int i = 0; i < kPalCount; ++i) {
     PaletteFile pal;
-    QByteArray palBytes = data.mid(p, kPalBytes);
-    p += kPalBytes;
-    XnginePaletteFormat::Document palDoc;
-    XnginePaletteFormat::Traits palTraits;
-    palTraits.variant = XnginePaletteFormat::Variant::HeaderedRgb256;
-    palTraits.strictValidation = false;
-    palTraits.allowTrailingPaletteData = false;
-    if (!XnginePaletteFormat::parseBytes(palBytes, palDoc, errorMessage, palTraits)) {
+    if (!parseSkyPalette(data.mid(p, kPalBytes), pal, errorMessage)) {
       return false;
     }
-    pal.isColFile = (palDoc.variant == XnginePaletteFormat::Variant::HeaderedRgb256);
-    pal.colLength = palDoc.headered.length;
-    pal.colMajor = palDoc.headered.major;
-    pal.colMinor = palDoc.headered.minor;
-    pal.colors = palDoc.palette.colors;
-    if (pal.colors.size() > 0) {
-      pal.colors[0].setAlpha(0);
-      for (int c = 1; c < pal.colors.size(); ++c) {
-        pal.colors[c].setAlpha(255);
-      }
-    }
+    p += kPalBytes;
     out.palettes.push_back(pal);
   }
 
@@ -342,30 +552,17 @@ bool loadCfaFile(const QString& path, CfaFile& out, QString* errorMessage)
 {
   out = {};
   const QByteArray data = readData(path, errorMessage);
-  if (data.size() < 14) {
-    return setError(errorMessage, "CFA file too small");
-  }
-
-  if (!readLE16U(data, 0, out.widthUncompressed) || !readLE16U(data, 2, out.height) ||
-      !readLE16U(data, 4, out.widthCompressed) || !readLE16U(data, 6, out.unknown1) ||
-      !readLE16U(data, 8, out.unknown2)) {
-    return setError(errorMessage, "Failed reading CFA header");
-  }
-  out.bitsPerPixel = static_cast<quint8>(data.at(10));
-  out.frameCount = static_cast<quint8>(data.at(11));
-  if (!readLE16U(data, 12, out.headerSize)) {
-    return setError(errorMessage, "Failed reading CFA header size");
-  }
-  if (out.headerSize >= data.size()) {
-    return setError(errorMessage, "CFA header size exceeds file size");
+  if (!parseCfaHeader(data, out, errorMessage)) {
+    return false;
   }
 
-  const QByteArray compressed = data.mid(out.headerSize);
   const int framePixels = static_cast<int>(out.widthUncompressed) * static_cast<int>(out.height);
   const int expectedTotal = framePixels * static_cast<int>(out.frameCount);
-  QByteArray decoded;
+  QByteArray decoded(expectedTotal, Qt::Uninitialized);
   QString decErr;
-  if (!decodeRleCompressed(compressed, expectedTotal, decoded, &decErr)) {
+  if (!decodeRle(data.constData() + out.headerSize, data.size() - out.headerSize,
+                 reinterpret_cast<uchar*>(decoded.data()), expectedTotal, 1, expectedTotal,
+                 nullptr, &decErr)) {
     return setError(errorMessage, QString("CFA RLE decode failed: %1").arg(decErr));
   }
 
@@ -376,6 +573,167 @@ bool loadCfaFile(const QString& path, CfaFile& out, QString* errorMessage)
   return true;
 }
 
+bool SkyStream::open(const QString& path, QString* errorMessage)
+{
+  close();
+  if (!m_View.open(path)) {
+    return setError(errorMessage, QString("Unable to open file: %1").arg(path));
+  }
+
+  const qsizetype need = kPaletteCount * kPaletteBytes +
+                         kTranslationCount * kTablesPerTranslation * 256 +
+                         static_cast<qsizetype>(kFrameCount) * kFrameWidth * kFrameHeight;
+  if (m_View.size() < need) {
+    const qsizetype size = m_View.size();
+    close();
+    return setError(errorMessage, QString("SKY file too small: %1 < %2").arg(size).arg(need));
+  }
+  if (m_View.size() > need) {
+    appendWarning(m_Warning,
+                  QString("SKY file has %1 trailing bytes").arg(m_View.size() - need));
+  }
+  return true;
+}
+
+void SkyStream::close()
+{
+  m_View.close();
+  m_Warning.clear();
+}
+
+bool SkyStream::palette(int index, PaletteFile& out, QString* errorMessage) const
+{
+  out = {};
+  if (!isOpen() || index < 0 || index >= kPaletteCount) {
+    return setError(errorMessage, QString("SKY palette %1 out of range").arg(index));
+  }
+  return parseSkyPalette(m_View.bytes(index * kPaletteBytes, kPaletteBytes), out, errorMessage);
+}
+
+QByteArray SkyStream::translationTable(int set, int table) const
+{
+  if (!isOpen() || set < 0 || set >= kTranslationCount || table < 0 ||
+      table >= kTablesPerTranslation) {
+    return {};
+  }
+  const qsizetype offset = kPaletteCount * kPaletteBytes +
+                           (static_cast<qsizetype>(set) * kTablesPerTranslation + table) * 256;
+  return QByteArray(reinterpret_cast<const char*>(m_View.data()) + offset, 256);
+}
+
+bool SkyStream::decodeFrame(int index, uchar* dest, qsizetype stride,
+                            QString* errorMessage) const
+{
+  if (!isOpen() || index < 0 || index >= kFrameCount) {
+    return setError(errorMessage, QString("SKY frame %1 out of range").arg(index));
+  }
+  if (stride < kFrameWidth) {
+    return setError(errorMessage, "SKY destination stride is smaller than the frame width");
+  }
+
+  // Frames are stored uncompressed after the palettes and translation tables.
+  const uchar* src = m_View.data() + kPaletteCount * kPaletteBytes +
+                     kTranslationCount * kTablesPerTranslation * 256 +
+                     static_cast<qsizetype>(index) * kFrameWidth * kFrameHeight;
+  if (stride == kFrameWidth) {
+    std::memcpy(dest, src, static_cast<size_t>(kFrameWidth) * kFrameHeight);
+    return true;
+  }
+  for (int y = 0; y < kFrameHeight; ++y) {
+    std::memcpy(dest + y * stride, src + y * kFrameWidth, kFrameWidth);
+  }
+  return true;
+}
+
+bool SkyStream::decodeFrame(int index, QByteArray& buffer, QString* errorMessage) const
+{
+  const qsizetype size = static_cast<qsizetype>(kFrameWidth) * kFrameHeight;
+  if (buffer.size() != size) {
+    buffer.resize(size);
+  }
+  return decodeFrame(index, reinterpret_cast<uchar*>(buffer.data()), kFrameWidth,
+                     errorMessage);
+}
+
+bool CfaStream::open(const QString& path, QString* errorMessage)
+{
+  close();
+  if (!m_View.open(path)) {
+    return setError(errorMessage, QString("Unable to open file: %1").arg(path));
+  }
+  if (!parseCfaHeader(m_View.bytes(), m_Header, errorMessage)) {
+    close();
+    return false;
+  }
+
+  // Walk the runs without writing anything, noting the run each frame starts in, up to
+  // the end of the last frame so a short stream fails here as it does in loadCfaFile.
+  const qsizetype framePixels = static_cast<qsizetype>(width()) * height();
+  const int frames = m_Header.frameCount;
+  const qsizetype expected = framePixels * frames;
+  const uchar* src = m_View.data() + m_Header.headerSize;
+  const qsizetype srcSize = m_View.size() - m_Header.headerSize;
+  m_Frames.resize(frames);
+  qsizetype decoded = 0;
+  qsizetype p = 0;
+  int nextFrame = 0;
+  RleRun run;
+  QString decErr;
+  while (decoded < expected && p < srcSize) {
+    const qsizetype runStart = p;
+    if (!nextRleRun(src, srcSize, p, run, &decErr)) {
+      close();
+      return setError(errorMessage, QString("CFA RLE decode failed: %1").arg(decErr));
+    }
+    while (nextFrame < frames && nextFrame * framePixels < decoded + run.length) {
+      m_Frames[nextFrame] = {runStart, nextFrame * framePixels - decoded};
+      ++nextFrame;
+    }
+    decoded += run.length;
+  }
+
+  if (decoded < expected) {
+    close();
+    return setError(errorMessage, QString("CFA RLE decode failed: Decoded %1 bytes, expected %2")
+                                      .arg(decoded)
+                                      .arg(expected));
+  }
+  return true;
+}
+
+void CfaStream::close()
+{
+  m_View.close();
+  m_Header = {};
+  m_Frames.clear();
+}
+
+bool CfaStream::decodeFrame(int index, uchar* dest, qsizetype stride,
+                            QString* errorMessage) const
+{
+  if (index < 0 || index >= m_Frames.size()) {
+    return setError(errorMessage, QString("CFA frame %1 out of range").arg(index));
+  }
+  const FrameStart& frame = m_Frames.at(index);
+  const qsizetype start = m_Header.headerSize + frame.offset;
+  QString decErr;
+  if (!decodeRleSkipping(reinterpret_cast<const char*>(m_View.data()) + start,
+                         m_View.size() - start, frame.skip, dest, width(), height(), stride,
+                         nullptr, &decErr)) {
+    return setError(errorMessage, QString("CFA RLE decode failed: %1").arg(decErr));
+  }
+  return true;
+}
+
+bool CfaStream::decodeFrame(int index, QByteArray& buffer, QString* errorMessage) const
+{
+  const qsizetype size = static_cast<qsizetype>(width()) * height();
+  if (buffer.size() != size) {
+    buffer.resize(size);
+  }
+  return decodeFrame(index, reinterpret_cast<uchar*>(buffer.data()), width(), errorMessage);
+}
+
 bool loadCifFile(const QString& path, CifFile& out, QString* errorMessage)
 {
   out = {};
@@ -407,23 +765,27 @@ bool loadCifFile(const QString& path, CifFile& out, QString* errorMessage)
     if (off + 12 > data.size()) {
       return false;
     }
-    QByteArray slice = data.mid(off);
-    QString err;
     // parse from bytes directly (adapt minimal logic from loadImgFile)
-    if (!readLE16(slice, 0, img.header.xOffset) || !readLE16(slice, 2, img.header.yOffset) ||
-        !readLE16(slice, 4, img.header.width) || !readLE16(slice, 6, img.header.height) ||
-        !readLE16U(slice, 8, img.header.compression) || !readLE16(slice, 10, img.header.pixelDataLength)) {
+    if (!readLE16(data, off + 0, img.header.xOffset) ||
+        !readLE16(data, off + 2, img.header.yOffset) ||
+        !readLE16(data, off + 4, img.header.width) ||
+        !readLE16(data, off + 6, img.header.height) ||
+        !readLE16U(data, off + 8, img.header.compression) ||
+        !readLE16(data, off + 10, img.header.pixelDataLength)) {
       return false;
     }
     const int len = std::max(0, static_cast<int>(img.header.pixelDataLength));
-    if (12 + len > slice.size()) {
+    if (off + 12 + len > data.size()) {
       return false;
     }
-    img.pixelDataRaw = slice.mid(12, len);
-    const int expected = std::max(0, static_cast<int>(img.header.width) *
-                                         static_cast<int>(img.header.height));
+    img.pixelDataRaw = data.mid(off + 12, len);
+    const int w = std::max(0, static_cast<int>(img.header.width));
+    const int h = std::max(0, static_cast<int>(img.header.height));
+    const int expected = w * h;
     if (img.header.compression == static_cast<quint16>(ImgCompression::RleCompressed)) {
-      if (!decodeRleCompressed(img.pixelDataRaw, expected, img.pixelDataDecoded, &err)) {
+      img.pixelDataDecoded = QByteArray(expected, Qt::Uninitialized);
+      if (!decodeRle(data.constData() + off + 12, len,
+                     reinterpret_cast<uchar*>(img.pixelDataDecoded.data()), w, h, w)) {
         return false;
       }
     } else {
@@ -522,21 +884,25 @@ bool loadTextureFile(const QString& path, TextureFile& out, QString* errorMessag
     const qsizetype dataStart = base + rec.dataOffset;
     if (w > 0 && h > 0 && dataStart < data.size()) {
       if ((rec.compression == 0 || rec.compression > 0x2000) && rec.frameCount == 1) {
-        QByteArray frame;
-        frame.reserve(w * h);
+        QByteArray frame(static_cast<qsizetype>(w) * h, Qt::Uninitialized);
+        char* dst = frame.data();
         qsizetype p = dataStart;
-        for (int row = 0; row < h; ++row) {
+        int rows = 0;
+        while (rows < h) {
           if (p + w > data.size()) {
             appendWarning(rec.warning, "Texture row exceeds file size");
             break;
           }
-          frame.append(data.mid(p, w));
+          std::memcpy(dst, data.constData() + p, static_cast<size_t>(w));
+          dst += w;
+          ++rows;
           if (256 - w < 0) {
             appendWarning(rec.warning, "Texture width exceeds 256 for uncompressed-single-frame");
             break;
           }
           p += 256;
         }
+        frame.truncate(static_cast<qsizetype>(rows) * w);
         rec.frames.push_back(frame);
       } else {
         appendWarning(rec.warning, "Texture compression/frame mode currently parsed as header-only");
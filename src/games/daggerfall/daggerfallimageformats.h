@@ -1,6 +1,8 @@
 #ifndef DAGGERFALL_IMAGEFORMATS_H
 #define DAGGERFALL_IMAGEFORMATS_H
 
+#include "xnginesaveview.h"
+
 #include <QColor>
 #include <QImage>
 #include <QVector>
@@ -139,7 +141,7 @@ struct TextureRecord
   quint16 unknown1 = 0;
   qint16 xScale = 0;
   qint16 yScale = 0;
-  QVector<QByteArray> frames;  // decoded indexed when supported
+  QVector<QByteArray> frames;  // decoded indexed; uncompressed single-frame records only
   QString warning;
 };
 
@@ -160,9 +162,94 @@ bool loadRciFile(const QString& path, qint16 width, qint16 height, RciFile& out,
 bool loadSkyFile(const QString& path, SkyFile& out, QString* errorMessage = nullptr);
 bool loadCfaFile(const QString& path, CfaFile& out, QString* errorMessage = nullptr);
 bool loadCifFile(const QString& path, CifFile& out, QString* errorMessage = nullptr);
+// Reads every record header; pixels are decoded only for uncompressed single-frame
+// records (rows 256 bytes apart). RLE-compressed and animated records keep no frames
+// and get a warning.
 bool loadTextureFile(const QString& path, TextureFile& out, QString* errorMessage = nullptr);
 
+// IMG/CIF/CFA RLE (count byte c: c < 0x80 copies c+1 literal bytes, 0x80..0xFE repeats
+// the next byte c-127 times, 0xFF is invalid) decoded straight into caller memory:
+// width*height pixels in rows stride bytes apart, e.g. bits() and bytesPerLine() of a
+// Format_Indexed8 QImage. Runs may cross rows; the last run is clipped at the frame end.
+// consumed receives the number of source bytes read.
+bool decodeRle(const char* src, qsizetype srcSize, uchar* dest, int width, int height,
+               qsizetype stride, qsizetype* consumed = nullptr,
+               QString* errorMessage = nullptr);
+
+// SKY file mapped instead of read: frames, palettes and translation tables are decoded
+// on demand, so animating a sky costs one frame buffer instead of ~7 MB per file.
+class SkyStream
+{
+public:
+  static constexpr int kPaletteCount = 32;
+  static constexpr qsizetype kPaletteBytes = 776;
+  static constexpr int kTranslationCount = 32;
+  static constexpr int kTablesPerTranslation = 64;
+  static constexpr int kFrameCount = 64;
+  static constexpr int kFrameWidth = 512;
+  static constexpr int kFrameHeight = 220;
+
+  bool open(const QString& path, QString* errorMessage = nullptr);
+  void close();
+  bool isOpen() const { return m_View.isOpen(); }
+  const QString& warning() const { return m_Warning; }
+
+  bool palette(int index, PaletteFile& out, QString* errorMessage = nullptr) const;
+  // 256-byte table of translation set, or empty when out of range.
+  QByteArray translationTable(int set, int table) const;
+
+  // Frame index (kFrameWidth x kFrameHeight indexed) into rows stride bytes apart.
+  bool decodeFrame(int index, uchar* dest, qsizetype stride,
+                   QString* errorMessage = nullptr) const;
+  // Same into buffer, which keeps its allocation when it already has the frame size.
+  bool decodeFrame(int index, QByteArray& buffer, QString* errorMessage = nullptr) const;
+
+private:
+  XngineSaveView m_View;
+  QString m_Warning;
+};
+
+// CFA file mapped instead of read. open() walks the RLE stream once to record where
+// each frame starts (runs may cross frames), then frames are decoded on demand.
+class CfaStream
+{
+public:
+  bool open(const QString& path, QString* errorMessage = nullptr);
+  void close();
+  bool isOpen() const { return m_View.isOpen(); }
+
+  // Header fields only; frames stays empty.
+  const CfaFile& header() const { return m_Header; }
+  int frameCount() const { return static_cast<int>(m_Frames.size()); }
+  int width() const { return m_Header.widthUncompressed; }
+  int height() const { return m_Header.height; }
+
+  bool decodeFrame(int index, uchar* dest, qsizetype stride,
+                   QString* errorMessage = nullptr) const;
+  bool decodeFrame(int index, QByteArray& buffer, QString* errorMessage = nullptr) const;
+
+private:
+  struct FrameStart
+  {
+    qsizetype offset = 0;  // RLE run holding the frame's first pixel, from the header end
+    qsizetype skip = 0;    // pixels of that run belonging to the previous frame
+  };
+
+  XngineSaveView m_View;
+  CfaFile m_Header;
+  QVector<FrameStart> m_Frames;
+};
+
+// 256 ARGB32 entries for palette, index 0 fully transparent. Build it once and pass
+// it to the overloads below when converting many images with one palette.
+QVector<QRgb> argbColorTable(const PaletteFile& palette);
+
 QImage toImage(const QByteArray& indexedPixels, int width, int height, const PaletteFile& palette);
+QImage toImage(const QByteArray& indexedPixels, int width, int height,
+               const QVector<QRgb>& colorTable);
+// Format_Indexed8 with colorTable; a quarter of the memory of toImage.
+QImage toIndexedImage(const QByteArray& indexedPixels, int width, int height,
+                      const QVector<QRgb>& colorTable);
 QByteArray applyColourTranslation(const QByteArray& indexedPixels, const QByteArray& xlat256);
 
 }  // namespace Image
@@ -0,0 +1,170 @@
+#include "daggerfalllocationtable.h"
+#include "daggerfallformatutils.h"
+
+#include <QtEndian>
+
+#include <algorithm>
+#include <map>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+using Daggerfall::FormatUtil::setError;
+using Cache = XngineDerivedCache;
+
+const Cache::Format kFormat = {{'D', 'F', 'L', 'T'}, 1, "Location table cache", "MAPS.BSA"};
+constexpr qsizetype kHeaderSize = Cache::kHeaderSize + 4 + 4;
+constexpr qsizetype kCodeCount = 65536;
+constexpr qsizetype kCodeTableSize = kCodeCount * 2;
+constexpr qsizetype kRecordSize = 16;
+constexpr quint16 kNoRecord = 0xffff;
+
+constexpr quint8 kFlagDiscovered = 0x01;
+constexpr quint8 kFlagHidden = 0x02;
+
+template <typename T>
+void storeLE(QByteArray& out, qsizetype offset, T value)
+{
+  qToLittleEndian(value, reinterpret_cast<uchar*>(out.data() + offset));
+}
+
+}  // namespace
+
+QByteArray DaggerfallLocationTable::build(const QHash<quint16, LocationInfo>& index,
+                                          const QString& sourceHash)
+{
+  // Distinct infos become records (the locationNum and header-code keys of one
+  // location normally share a record); names are interned in the string pool.
+  using RecordKey = std::tuple<QString, int, int, quint32, bool, bool>;
+  QHash<QString, quint32> nameOffsets;
+  QByteArray strings;
+  QByteArray records;
+  QByteArray codes(kCodeTableSize, '\xff');
+  std::map<RecordKey, quint16> recordIndexByKey;
+  quint32 recordCount = 0;
+
+  // Walk codes in ascending order so the output is byte-identical across runs.
+  std::vector<quint16> sortedCodes(index.keyBegin(), index.keyEnd());
+  std::sort(sortedCodes.begin(), sortedCodes.end());
+
+  for (const quint16 code : sortedCodes) {
+    const LocationInfo& info = index.value(code);
+    const RecordKey key{info.name, info.regionIndex, info.locationType, info.mapId,
+                        info.discovered, info.hidden};
+    const auto existing = recordIndexByKey.find(key);
+    quint16 recordIndex = existing != recordIndexByKey.end() ? existing->second : kNoRecord;
+
+    if (recordIndex == kNoRecord) {
+      if (recordCount >= kNoRecord) {
+        return {};  // cannot be addressed by a u16 code table
+      }
+      const QByteArray name = info.name.toUtf8();
+      auto nameIt = nameOffsets.constFind(info.name);
+      if (nameIt == nameOffsets.constEnd()) {
+        nameIt = nameOffsets.insert(info.name, static_cast<quint32>(strings.size()));
+        strings.append(name);
+      }
+
+      Cache::appendLE<quint32>(records, nameIt.value());
+      Cache::appendLE<quint16>(records,
+                               static_cast<quint16>(std::min<qsizetype>(name.size(), 0xffff)));
+      Cache::appendLE<qint16>(records, static_cast<qint16>(info.regionIndex));
+      Cache::appendLE<quint32>(records, info.mapId);
+      records.append(static_cast<char>(static_cast<qint8>(info.locationType)));
+      records.append(static_cast<char>((info.discovered ? kFlagDiscovered : 0) |
+                                       (info.hidden ? kFlagHidden : 0)));
+      Cache::appendLE<quint16>(records, 0);
+
+      recordIndex = static_cast<quint16>(recordCount++);
+      recordIndexByKey.emplace(key, recordIndex);
+    }
+    storeLE<quint16>(codes, static_cast<qsizetype>(code) * 2, recordIndex);
+  }
+
+  QByteArray out;
+  out.reserve(kHeaderSize + kCodeTableSize + records.size() + strings.size());
+  Cache::appendHeader(out, kFormat, sourceHash);
+  Cache::appendLE<quint32>(out, recordCount);
+  Cache::appendLE<quint32>(out, static_cast<quint32>(strings.size()));
+  out.append(codes);
+  out.append(records);
+  out.append(strings);
+  return out;
+}
+
+DaggerfallLocationTable::DaggerfallLocationTable() : Table(kFormat) {}
+
+bool DaggerfallLocationTable::attachLayout(const uchar* data, qsizetype size,
+                                           QString* errorMessage)
+{
+  m_RecordCount = 0;
+  m_StringPoolSize = 0;
+
+  if (size < kHeaderSize + kCodeTableSize) {
+    return setError(errorMessage, "Location table cache is truncated");
+  }
+  const quint32 recordCount = qFromLittleEndian<quint32>(data + Cache::kHeaderSize);
+  const quint32 stringPoolSize = qFromLittleEndian<quint32>(data + Cache::kHeaderSize + 4);
+  const qsizetype expected = kHeaderSize + kCodeTableSize +
+                             static_cast<qsizetype>(recordCount) * kRecordSize +
+                             static_cast<qsizetype>(stringPoolSize);
+  if (recordCount >= kNoRecord || size != expected) {
+    return setError(errorMessage, "Location table cache is truncated");
+  }
+
+  m_RecordCount = recordCount;
+  m_StringPoolSize = stringPoolSize;
+  return true;
+}
+
+DaggerfallLocationTable::LocationInfo DaggerfallLocationTable::find(quint16 locationCode) const
+{
+  if (!isValid()) {
+    return {};
+  }
+  const quint16 recordIndex = qFromLittleEndian<quint16>(
+      tableData() + kHeaderSize + static_cast<qsizetype>(locationCode) * 2);
+  if (recordIndex == kNoRecord || recordIndex >= m_RecordCount) {
+    return {};
+  }
+  return record(recordIndex);
+}
+
+QHash<quint16, DaggerfallLocationTable::LocationInfo> DaggerfallLocationTable::toHash() const
+{
+  QHash<quint16, LocationInfo> out;
+  if (!isValid()) {
+    return out;
+  }
+  for (qsizetype code = 0; code < kCodeCount; ++code) {
+    LocationInfo info = find(static_cast<quint16>(code));
+    if (info.isValid()) {
+      out.insert(static_cast<quint16>(code), info);
+    }
+  }
+  return out;
+}
+
+DaggerfallLocationTable::LocationInfo DaggerfallLocationTable::record(quint32 index) const
+{
+  const uchar* rec = tableData() + kHeaderSize + kCodeTableSize +
+                     static_cast<qsizetype>(index) * kRecordSize;
+  const uchar* strings = tableData() + kHeaderSize + kCodeTableSize +
+                         static_cast<qsizetype>(m_RecordCount) * kRecordSize;
+
+  const quint32 nameOffset = qFromLittleEndian<quint32>(rec);
+  const quint16 nameLength = qFromLittleEndian<quint16>(rec + 4);
+
+  LocationInfo info;
+  if (static_cast<quint64>(nameOffset) + nameLength <= m_StringPoolSize) {
+    info.name = QString::fromUtf8(reinterpret_cast<const char*>(strings + nameOffset),
+                                  nameLength);
+  }
+  info.regionIndex = qFromLittleEndian<qint16>(rec + 6);
+  info.mapId = qFromLittleEndian<quint32>(rec + 8);
+  info.locationType = static_cast<qint8>(rec[12]);
+  info.discovered = (rec[13] & kFlagDiscovered) != 0;
+  info.hidden = (rec[13] & kFlagHidden) != 0;
+  return info;
+}
@@ -0,0 +1,50 @@
+#ifndef DAGGERFALL_LOCATIONTABLE_H
+#define DAGGERFALL_LOCATIONTABLE_H
+
+#include "daggerfallmapsbsa.h"
+#include "xnginederivedcache.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QtGlobal>
+
+/**
+ * Pre-decoded MAPS.BSA location table, stored as a derived cache file.
+ *
+ * Layout (little-endian):
+ *   header   "DFLT", u32 version, char[40] MAPS.BSA SHA-1 (hex),
+ *            u32 recordCount, u32 stringPoolSize
+ *   codes    65536 x u16 record index per location code (0xFFFF = none)
+ *   records  recordCount x 16 bytes: u32 nameOffset, u16 nameLength,
+ *            i16 regionIndex, u32 mapId, i8 locationType, u8 flags, u16 reserved
+ *   strings  interned UTF-8 names
+ *
+ * Opening validates sizes and the source hash, then answers lookups straight
+ * from the mapping; names are decoded only for the records actually returned.
+ */
+class DaggerfallLocationTable : public XngineDerivedCache::Table
+{
+public:
+  using LocationInfo = DaggerfallMapsBsa::LocationInfo;
+
+  static QByteArray build(const QHash<quint16, LocationInfo>& index, const QString& sourceHash);
+
+  DaggerfallLocationTable();
+
+  qsizetype recordCount() const { return m_RecordCount; }
+
+  LocationInfo find(quint16 locationCode) const;
+  QHash<quint16, LocationInfo> toHash() const;
+
+protected:
+  bool attachLayout(const uchar* data, qsizetype size, QString* errorMessage) override;
+
+private:
+  LocationInfo record(quint32 index) const;
+
+  quint32 m_RecordCount = 0;
+  quint32 m_StringPoolSize = 0;
+};
+
+#endif  // DAGGERFALL_LOCATIONTABLE_H
@@ -3,11 +3,20 @@
 
 #include "daggerfallblocksbsa.h"
 #include "daggerfallcommon.h"
+#include "daggerfalllocationtable.h"
+#ifdef XNGINE_HEADLESS
+#include "xngineheadless.h"
+#else
 #include "gamedaggerfall.h"
+#endif
 #include "xnginebsaformat.h"
+#include "xnginederivedcache.h"
 
+#include <QDebug>
 #include <QDir>
 #include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
 #include <QtEndian>
 #include <QStringList>
 #include <QVector>
@@ -15,7 +24,8 @@
 #include <algorithm>
 #include <cstring>
 #include <cstdlib>
-#include <limits>
+#include <memory>
+#include <vector>
 
 namespace {
 
@@ -100,6 +110,98 @@ struct CoordinateEntry
   DaggerfallMapsBsa::LocationInfo info;
 };
 
+// 32k map-cell granularity means nearest should usually be very close.
+constexpr qint64 kMaxAcceptableDistance = 300000;
+
+// Implicit 2-d tree over MAPTABLE coordinates. Some DF coordinate contexts are
+// swapped, so every location is inserted in both orientations; a plain L1 nearest
+// search over those points is then the same min-of-both-orientations metric the
+// linear scan used, at O(log n) per query.
+class CoordinateIndex
+{
+public:
+  explicit CoordinateIndex(QVector<CoordinateEntry> entries) : m_Entries(std::move(entries))
+  {
+    m_Points.reserve(static_cast<size_t>(m_Entries.size()) * 2);
+    for (int i = 0; i < m_Entries.size(); ++i) {
+      const auto& e = m_Entries.at(i);
+      m_Points.push_back({e.longitude, e.latitude, i});
+      m_Points.push_back({e.latitude, e.longitude, i});
+    }
+    build(0, static_cast<int>(m_Points.size()), 0);
+  }
+
+  bool isEmpty() const { return m_Entries.isEmpty(); }
+
+  // Closest entry within maxDistance; ties go to the lower entry index.
+  const CoordinateEntry* nearest(qint32 x, qint32 z, qint64 maxDistance) const
+  {
+    qint64 bestDistance = maxDistance;
+    int best = -1;
+    search(0, static_cast<int>(m_Points.size()), 0, x, z, bestDistance, best);
+    return best >= 0 ? &m_Entries.at(best) : nullptr;
+  }
+
+private:
+  struct Point
+  {
+    qint32 x = 0;
+    qint32 z = 0;
+    int entry = -1;
+  };
+
+  void build(int begin, int end, int depth)
+  {
+    if (end - begin <= 1) {
+      return;
+    }
+    const int mid = begin + (end - begin) / 2;
+    const bool byX = (depth % 2) == 0;
+    std::nth_element(m_Points.begin() + begin, m_Points.begin() + mid, m_Points.begin() + end,
+                     [byX](const Point& a, const Point& b) {
+                       return byX ? a.x < b.x : a.z < b.z;
+                     });
+    build(begin, mid, depth + 1);
+    build(mid + 1, end, depth + 1);
+  }
+
+  void search(int begin, int end, int depth, qint32 x, qint32 z, qint64& bestDistance,
+              int& best) const
+  {
+    if (begin >= end) {
+      return;
+    }
+    const int mid = begin + (end - begin) / 2;
+    const Point& p = m_Points[static_cast<size_t>(mid)];
+    const qint64 d = std::llabs(static_cast<qint64>(p.x) - x) +
+                     std::llabs(static_cast<qint64>(p.z) - z);
+    if (d < bestDistance || (d == bestDistance && (best < 0 || p.entry < best))) {
+      bestDistance = d;
+      best = p.entry;
+    }
+
+    const qint64 delta = (depth % 2) == 0 ? static_cast<qint64>(x) - p.x
+                                          : static_cast<qint64>(z) - p.z;
+    const bool nearIsLeft = delta < 0;
+    if (nearIsLeft) {
+      search(begin, mid, depth + 1, x, z, bestDistance, best);
+    } else {
+      search(mid + 1, end, depth + 1, x, z, bestDistance, best);
+    }
+    // The split axis alone contributes |delta| to any point on the far side.
+    if (std::llabs(delta) <= bestDistance) {
+      if (nearIsLeft) {
+        search(mid + 1, end, depth + 1, x, z, bestDistance, best);
+      } else {
+        search(begin, mid, depth + 1, x, z, bestDistance, best);
+      }
+    }
+  }
+
+  QVector<CoordinateEntry> m_Entries;
+  std::vector<Point> m_Points;
+};
+
 QHash<int, QVector<MapTableElement>> readMapTableByRegion(
     const XngineBSAFormat::Archive& archive, const QHash<int, QStringList>& namesByRegion)
 {
@@ -237,6 +339,34 @@ void populateLocationNumIndex(const XngineBSAFormat::Archive& archive,
   }
 }
 
+// Map the derived location table for this MAPS.BSA, decoding the archive and
+// writing the cache only when no valid table exists for its current contents.
+std::shared_ptr<const DaggerfallLocationTable> openLocationTable(const QString& mapsPath)
+{
+  auto table = std::make_shared<DaggerfallLocationTable>();
+  const QString hash = XngineDerivedCache::contentHash(mapsPath);
+  if (hash.isEmpty()) {
+    return table;
+  }
+
+  QString error;
+  const bool ok = table->openOrBuild(
+      XngineDerivedCache::pathFor("dfmaps-locations", hash), hash,
+      [&](QByteArray& bytes, QString* buildError) {
+        QHash<quint16, DaggerfallMapsBsa::LocationInfo> decoded;
+        if (!DaggerfallMapsBsa::loadLocationInfoIndex(mapsPath, decoded, buildError)) {
+          return false;
+        }
+        bytes = DaggerfallLocationTable::build(decoded, hash);
+        return true;
+      },
+      &error);
+  if (!ok) {
+    qWarning().noquote() << "[DaggerfallMapsBsa]" << error;
+  }
+  return table;
+}
+
 }  // namespace
 
 bool DaggerfallMapsBsa::loadLocationNameIndex(const QString& mapsBsaPath,
@@ -293,21 +423,16 @@ DaggerfallMapsBsa::LocationInfo DaggerfallMapsBsa::resolveLocationInfo(
     return {};
   }
 
-  static QHash<QString, QHash<quint16, LocationInfo>> cacheByPath;
+  static XngineDerivedCache::SharedMemo<DaggerfallLocationTable> tableByPath;
 
   const QString mapsPath =
       QDir::fromNativeSeparators(game->gameDirectory().filePath("arena2/MAPS.BSA"));
-  if (!cacheByPath.contains(mapsPath)) {
-    QHash<quint16, LocationInfo> loaded;
-    QString error;
-    if (!loadLocationInfoIndex(mapsPath, loaded, &error)) {
-      cacheByPath.insert(mapsPath, {});
-    } else {
-      cacheByPath.insert(mapsPath, loaded);
-    }
+  std::shared_ptr<const DaggerfallLocationTable> table = tableByPath.find(mapsPath);
+  if (!table) {
+    table = tableByPath.publish(mapsPath, openLocationTable(mapsPath));
   }
 
-  return cacheByPath.value(mapsPath).value(locationCode);
+  return table->find(locationCode);
 }
 
 QString DaggerfallMapsBsa::regionName(int regionIndex)
@@ -323,77 +448,82 @@ QString DaggerfallMapsBsa::locationTypeName(int locationType)
 DaggerfallMapsBsa::LocationInfo DaggerfallMapsBsa::resolveNearestLocation(
     const GameDaggerfall* game, qint32 x, qint32 z)
 {
-  if (game == nullptr) {
-    return {};
+  const auto nearest = resolveNearestLocations(game, {WorldPosition{x, z}});
+  return nearest.isEmpty() ? LocationInfo{} : nearest.front();
+}
+
+QVector<DaggerfallMapsBsa::LocationInfo> DaggerfallMapsBsa::resolveNearestLocations(
+    const GameDaggerfall* game, const QVector<WorldPosition>& positions)
+{
+  QVector<LocationInfo> results(positions.size());
+  if (game == nullptr || positions.isEmpty()) {
+    return results;
   }
 
-  static QHash<QString, QVector<CoordinateEntry>> coordCacheByPath;
+  static QMutex cacheMutex;
+  static QHash<QString, std::shared_ptr<const CoordinateIndex>> indexByPath;
   const QString mapsPath =
       QDir::fromNativeSeparators(game->gameDirectory().filePath("arena2/MAPS.BSA"));
 
-  if (!coordCacheByPath.contains(mapsPath)) {
-    QVector<CoordinateEntry> entries;
-
-    XngineBSAFormat::Archive archive;
-    QString errorMessage;
-    if (XngineBSAFormat::readArchive(mapsPath, archive, &errorMessage)) {
-      const auto namesByRegion = readMapNamesByRegion(archive);
-      const auto tablesByRegion = readMapTableByRegion(archive, namesByRegion);
-      for (auto it = tablesByRegion.constBegin(); it != tablesByRegion.constEnd(); ++it) {
-        const int region = it.key();
-        const auto names = namesByRegion.value(region);
-        const auto& table = it.value();
-        for (int i = 0; i < table.size() && i < names.size(); ++i) {
-          const auto& mt = table.at(i);
-          const QString name = names.at(i);
-          if (name.isEmpty()) {
+  std::shared_ptr<const CoordinateIndex> index;
+  {
+    QMutexLocker lock(&cacheMutex);
+    index = indexByPath.value(mapsPath);
+    if (!index) {
+      QVector<CoordinateEntry> entries;
+
+      XngineBSAFormat::Archive archive;
+      QString errorMessage;
+      if (XngineBSAFormat::readArchive(mapsPath, archive, &errorMessage)) {
+        const auto namesByRegion = readMapNamesByRegion(archive);
+        const auto tablesByRegion = readMapTableByRegion(archive, namesByRegion);
+        // Visit regions in order so tie-breaks do not depend on hash iteration order.
+        auto regions = tablesByRegion.keys();
+        std::sort(regions.begin(), regions.end());
+        for (const int region : regions) {
+          const auto namesIt = namesByRegion.constFind(region);
+          if (namesIt == namesByRegion.constEnd()) {
             continue;
           }
-
-          CoordinateEntry ce;
-          ce.latitude = static_cast<qint32>(mt.latitudeType & 0x1ffffffu);
-          ce.longitude = static_cast<qint32>(mt.longitudeType & 0xffffffu);
-          ce.info.name = name;
-          ce.info.regionIndex = region;
-          ce.info.locationType = static_cast<int>((mt.latitudeType >> 25) & 0x1f);
-          ce.info.discovered = (mt.latitudeType & 0x40000000u) != 0;
-          ce.info.hidden = (mt.latitudeType & 0x80000000u) != 0;
-          ce.info.mapId = mt.mapId;
-          entries.push_back(ce);
+          const auto& names = namesIt.value();
+          const auto& table = tablesByRegion.constFind(region).value();
+          for (int i = 0; i < table.size() && i < names.size(); ++i) {
+            const auto& mt = table.at(i);
+            const QString& name = names.at(i);
+            if (name.isEmpty()) {
+              continue;
+            }
+
+            CoordinateEntry ce;
+            ce.latitude = static_cast<qint32>(mt.latitudeType & 0x1ffffffu);
+            ce.longitude = static_cast<qint32>(mt.longitudeType & 0xffffffu);
+            ce.info.name = name;
+            ce.info.regionIndex = region;
+            ce.info.locationType = static_cast<int>((mt.latitudeType >> 25) & 0x1f);
+            ce.info.discovered = (mt.latitudeType & 0x40000000u) != 0;
+            ce.info.hidden = (mt.latitudeType & 0x80000000u) != 0;
+            ce.info.mapId = mt.mapId;
+            entries.push_back(ce);
+          }
         }
       }
-    }
 
-    coordCacheByPath.insert(mapsPath, entries);
+      index = std::make_shared<const CoordinateIndex>(std::move(entries));
+      indexByPath.insert(mapsPath, index);
+    }
   }
 
-  const auto entries = coordCacheByPath.value(mapsPath);
-  if (entries.isEmpty()) {
-    return {};
+  if (index->isEmpty()) {
+    return results;
   }
 
-  qint64 bestDistance = (std::numeric_limits<qint64>::max)();
-  const CoordinateEntry* best = nullptr;
-  for (const auto& e : entries) {
-    // Some DF coordinate contexts are swapped, so test both orientations.
-    const qint64 d1 = std::llabs(static_cast<qint64>(e.longitude) - x) +
-                      std::llabs(static_cast<qint64>(e.latitude) - z);
-    const qint64 d2 = std::llabs(static_cast<qint64>(e.latitude) - x) +
-                      std::llabs(static_cast<qint64>(e.longitude) - z);
-    const qint64 d = (std::min)(d1, d2);
-    if (d < bestDistance) {
-      bestDistance = d;
-      best = &e;
+  for (int i = 0; i < positions.size(); ++i) {
+    const auto& pos = positions.at(i);
+    if (const auto* best = index->nearest(pos.x, pos.z, kMaxAcceptableDistance)) {
+      results[i] = best->info;
     }
   }
-
-  // 32k map-cell granularity means nearest should usually be very close.
-  constexpr qint64 kMaxAcceptableDistance = 300000;
-  if (best == nullptr || bestDistance > kMaxAcceptableDistance) {
-    return {};
-  }
-
-  return best->info;
+  return results;
 }
 
 QString DaggerfallMapsBsa::resolveExteriorBlockRecordName(const GameDaggerfall* game,
@@ -3,6 +3,7 @@
 
 #include <QHash>
 #include <QString>
+#include <QVector>
 #include <QtGlobal>
 
 class GameDaggerfall;
@@ -22,6 +23,12 @@ public:
     bool isValid() const { return !name.isEmpty(); }
   };
 
+  struct WorldPosition
+  {
+    qint32 x = 0;
+    qint32 z = 0;
+  };
+
   static bool loadLocationNameIndex(const QString& mapsBsaPath,
                                     QHash<quint16, QString>& outIndex,
                                     QString* errorMessage = nullptr);
@@ -32,6 +39,10 @@ public:
                                     QString* errorMessage = nullptr);
   static LocationInfo resolveLocationInfo(const GameDaggerfall* game, quint16 locationCode);
   static LocationInfo resolveNearestLocation(const GameDaggerfall* game, qint32 x, qint32 z);
+  // Batch form: one result per position (invalid when nothing is in range). The
+  // per-MAPS.BSA spatial index is built on first use and shared across calls.
+  static QVector<LocationInfo> resolveNearestLocations(const GameDaggerfall* game,
+                                                       const QVector<WorldPosition>& positions);
   static QString resolveExteriorBlockRecordName(const GameDaggerfall* game, int regionIndex,
                                                 quint8 blockIndex, quint8 blockNumber,
                                                 quint8 blockCharacter);
@@ -3,40 +3,119 @@
 
 #include <QtEndian>
 
+#include <algorithm>
+#include <cstring>
+
 namespace {
 
-using Daggerfall::FormatUtil::readLE16U;
 using Daggerfall::FormatUtil::setError;
 
+quint16 runCount(const char* run)
+{
+  return qFromLittleEndian<quint16>(reinterpret_cast<const uchar*>(run));
+}
+
 }  // namespace
 
-bool DaggerfallPak::decompress(const QByteArray& packed, QByteArray& unpacked,
+qsizetype DaggerfallPak::unpackedSize(QByteArrayView packed, QString* errorMessage)
+{
+  if ((packed.size() % 3) != 0) {
+    setError(errorMessage, "PAK data length must be a multiple of 3");
+    return -1;
+  }
+
+  qsizetype total = 0;
+  for (qsizetype pos = 0; pos < packed.size(); pos += 3) {
+    const quint16 count = runCount(packed.data() + pos);
+    if (count == 0) {
+      setError(errorMessage, "PAK run count of 0 is invalid");
+      return -1;
+    }
+    total += count;
+  }
+  return total;
+}
+
+bool DaggerfallPak::decompress(QByteArrayView packed, QByteArray& unpacked,
                                QString* errorMessage)
 {
   unpacked.clear();
+  const qsizetype size = unpackedSize(packed, errorMessage);
+  if (size < 0) {
+    return false;
+  }
+  unpacked = QByteArray(size, Qt::Uninitialized);
+  return decompressInto(packed, unpacked.data(), size, errorMessage);
+}
+
+bool DaggerfallPak::decompressInto(QByteArrayView packed, char* dest, qsizetype destSize,
+                                   QString* errorMessage)
+{
   if ((packed.size() % 3) != 0) {
     return setError(errorMessage, "PAK data length must be a multiple of 3");
   }
 
-  qsizetype pos = 0;
-  while (pos + 3 <= packed.size()) {
-    quint16 count = 0;
-    if (!readLE16U(packed, pos, count)) {
-      return setError(errorMessage, "Failed to read PAK run count");
-    }
-    const quint8 value = static_cast<quint8>(packed.at(pos + 2));
+  qsizetype out = 0;
+  for (qsizetype pos = 0; pos < packed.size() && out < destSize; pos += 3) {
+    const quint16 count = runCount(packed.data() + pos);
     if (count == 0) {
       return setError(errorMessage, "PAK run count of 0 is invalid");
     }
+    const qsizetype n = std::min<qsizetype>(count, destSize - out);
+    std::memset(dest + out, packed.at(pos + 2), static_cast<size_t>(n));
+    out += n;
+  }
+  return true;
+}
 
-    const QByteArray run(static_cast<int>(count), static_cast<char>(value));
-    unpacked.append(run);
-    pos += 3;
+bool DaggerfallPak::RunIndex::build(QByteArrayView packed, RunIndex& out,
+                                    QString* errorMessage)
+{
+  out = {};
+  if (unpackedSize(packed, errorMessage) < 0) {
+    return false;
   }
 
+  const qsizetype runs = packed.size() / 3;
+  out.m_Ends.resize(runs);
+  out.m_Values.resize(runs);
+  quint32 end = 0;
+  for (qsizetype i = 0; i < runs; ++i) {
+    end += runCount(packed.data() + i * 3);
+    out.m_Ends[i] = end;
+    out.m_Values[i] = static_cast<quint8>(packed.at(i * 3 + 2));
+  }
   return true;
 }
 
+int DaggerfallPak::RunIndex::valueAt(qsizetype offset) const
+{
+  if (offset < 0 || offset >= size()) {
+    return -1;
+  }
+  const auto run = std::upper_bound(m_Ends.cbegin(), m_Ends.cend(), static_cast<quint32>(offset));
+  return m_Values.at(run - m_Ends.cbegin());
+}
+
+void DaggerfallPak::RunIndex::copySpan(qsizetype offset, qsizetype count, quint8* dest,
+                                       qsizetype stride, quint8 padValue) const
+{
+  qsizetype i = 0;
+  if (offset >= 0 && offset < size()) {
+    auto run = std::upper_bound(m_Ends.cbegin(), m_Ends.cend(), static_cast<quint32>(offset));
+    for (; i < count && run != m_Ends.cend(); ++run) {
+      const quint8 value = m_Values.at(run - m_Ends.cbegin());
+      const qsizetype runEnd = std::min<qsizetype>(static_cast<qsizetype>(*run) - offset, count);
+      for (; i < runEnd; ++i) {
+        dest[i * stride] = value;
+      }
+    }
+  }
+  for (; i < count; ++i) {
+    dest[i * stride] = padValue;
+  }
+}
+
 QByteArray DaggerfallPak::compress(const QByteArray& unpacked)
 {
   QByteArray out;
@@ -2,7 +2,9 @@
 #define DAGGERFALL_PAK_H
 
 #include <QByteArray>
+#include <QByteArrayView>
 #include <QString>
+#include <QVector>
 
 class DaggerfallPak
 {
@@ -13,10 +15,39 @@ public:
     quint8 value = 0;
   };
 
-  // Decompresses a whole PAK stream (list of 3-byte runs).
-  static bool decompress(const QByteArray& packed, QByteArray& unpacked,
+  // Run-level view of a PAK stream: answers valueAt(offset) by binary search over the
+  // cumulative run ends, without expanding the runs.
+  class RunIndex
+  {
+  public:
+    static bool build(QByteArrayView packed, RunIndex& out, QString* errorMessage = nullptr);
+
+    qsizetype size() const { return m_Ends.isEmpty() ? 0 : m_Ends.constLast(); }
+    int runCount() const { return static_cast<int>(m_Ends.size()); }
+    // Byte at offset of the unpacked stream, or -1 past its end.
+    int valueAt(qsizetype offset) const;
+    // Writes bytes [offset, offset + count) into dest[i * stride], padValue past the
+    // end; one search for the first run, then a linear walk.
+    void copySpan(qsizetype offset, qsizetype count, quint8* dest, qsizetype stride,
+                  quint8 padValue) const;
+
+  private:
+    QVector<quint32> m_Ends;  // exclusive end offset of each run
+    QVector<quint8> m_Values;
+  };
+
+  // Validates a PAK stream (list of 3-byte runs) and sums its run lengths, or -1.
+  static qsizetype unpackedSize(QByteArrayView packed, QString* errorMessage = nullptr);
+
+  // Decompresses a whole PAK stream into a buffer presized by unpackedSize.
+  static bool decompress(QByteArrayView packed, QByteArray& unpacked,
                          QString* errorMessage = nullptr);
 
+  // Writes the first min(unpackedSize, destSize) bytes of the stream into dest; the
+  // rest of dest is left untouched.
+  static bool decompressInto(QByteArrayView packed, char* dest, qsizetype destSize,
+                             QString* errorMessage = nullptr);
+
   // Encodes bytes into simple run-length PAK runs.
   static QByteArray compress(const QByteArray& unpacked);
 };
@@ -1,6 +1,8 @@
 #ifndef DAGGERFALL_POLITICPAK_H
 #define DAGGERFALL_POLITICPAK_H
 
+#include "daggerfallpak.h"
+
 #include <QByteArray>
 #include <QString>
 #include <QVector>
@@ -15,11 +17,16 @@ public:
     QVector<quint32> offsets;  // 500 entries
     QVector<QByteArray> rows;  // decompressed rows (1001 bytes each)
     QByteArray bitmap;         // rows concatenated
+    QVector<DaggerfallPak::RunIndex> rowRuns;  // loadRunIndex only, instead of rows/bitmap
     QString warning;
   };
 
   static bool load(const QString& filePath, Data& outData,
                    QString* errorMessage = nullptr);
+  // Keeps each row as a run index instead of expanding the 1001x500 map; valueAt
+  // works on either.
+  static bool loadRunIndex(const QString& filePath, Data& outData,
+                           QString* errorMessage = nullptr);
 
   static int valueAt(const Data& data, int x, int y);
   static int regionFromValue(int value);  // 128..233 -> value-128, 64 water -> -1
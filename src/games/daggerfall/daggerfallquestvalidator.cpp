@@ -0,0 +1,377 @@
+#include "daggerfallquestvalidator.h"
+#include "daggerfallqbn.h"
+#include "daggerfalltextrsc.h"
+#include "daggerfalltextvariables.h"
+#include "xngineparallel.h"
+#include "xnginerscformat.h"
+
+#include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QMap>
+#include <QSet>
+
+#include <algorithm>
+
+namespace {
+
+using Severity = DaggerfallQuestValidator::Severity;
+using FileReport = DaggerfallQuestValidator::FileReport;
+
+struct SharedContext
+{
+  const DaggerfallTextRsc::Database* textRsc = nullptr;  // null when not loaded
+  QHash<quint16, DaggerfallQbnPseudo::OpcodeSpec> opcodeSpecs;
+};
+
+void addIssue(FileReport& report, Severity severity, const QString& message)
+{
+  report.issues.push_back({severity, message});
+}
+
+void addWarnings(FileReport& report, const QString& prefix, const QString& warning)
+{
+  // Parsers join their warnings with "; " (Daggerfall::FormatUtil::appendWarning).
+  for (const QString& line : warning.split("; ", Qt::SkipEmptyParts)) {
+    addIssue(report, Severity::Warning, QString("%1: %2").arg(prefix, line));
+  }
+}
+
+QString companionQrc(const QFileInfo& qbn)
+{
+  // Name filters ignore case, so BASE.QRC and base.qrc both match.
+  const QDir dir = qbn.absoluteDir();
+  const QStringList matches = dir.entryList({qbn.completeBaseName() + ".QRC"}, QDir::Files);
+  return matches.isEmpty() ? QString() : dir.filePath(matches.first());
+}
+
+QString joinIds(const QList<quint16>& ids)
+{
+  QStringList parts;
+  for (const quint16 id : ids) {
+    parts.push_back(QString::number(id));
+  }
+  return parts.join(", ");
+}
+
+// Quest symbols are stored with their decoration (_name_, =name_); the record hash
+// may cover either form.
+void insertVariableHashes(const QString& name, QSet<quint32>& out)
+{
+  out.insert(DaggerfallTextVariables::hashVariableName(name));
+  qsizetype begin = 0;
+  qsizetype end = name.size();
+  while (begin < end && (name.at(begin) == '_' || name.at(begin) == '=')) {
+    ++begin;
+  }
+  while (end > begin && name.at(end - 1) == '_') {
+    --end;
+  }
+  out.insert(DaggerfallTextVariables::hashVariableName(name.mid(begin, end - begin)));
+}
+
+void checkQuest(const DaggerfallQbn::File& qbn, const XngineRscFormat::TextRecordDatabase* qrc,
+                const SharedContext& context, FileReport& report)
+{
+  QSet<quint16> messageIds;
+  if (qrc != nullptr) {
+    for (const auto& header : qrc->headers) {
+      messageIds.insert(header.id);
+    }
+  }
+  auto messageExists = [&](quint16 id) {
+    return messageIds.contains(id) ||
+           (context.textRsc != nullptr && context.textRsc->recordIndex(id) >= 0);
+  };
+
+  // Message ids referenced by records and opcodes.
+  QMap<quint16, QStringList> missingMessages;
+  auto checkRecordMessage = [&](quint16 id, const QString& owner) {
+    if (id != 0 && id != 0xFFFF && !messageExists(id)) {
+      missingMessages[id].push_back(owner);
+    }
+  };
+  for (int i = 0; i < qbn.items.size(); ++i) {
+    checkRecordMessage(qbn.items.at(i).textRecordId1, QString("item %1").arg(i));
+    checkRecordMessage(qbn.items.at(i).textRecordId2, QString("item %1").arg(i));
+  }
+  for (int i = 0; i < qbn.npcs.size(); ++i) {
+    checkRecordMessage(qbn.npcs.at(i).textRecordId1, QString("NPC %1").arg(i));
+    checkRecordMessage(qbn.npcs.at(i).textRecordId2, QString("NPC %1").arg(i));
+  }
+  for (int i = 0; i < qbn.locations.size(); ++i) {
+    checkRecordMessage(qbn.locations.at(i).textRecordId1, QString("location %1").arg(i));
+    checkRecordMessage(qbn.locations.at(i).textRecordId2, QString("location %1").arg(i));
+  }
+
+  QMap<quint16, int> unknownOpcodes;
+  for (int i = 0; i < qbn.opCodes.records.size(); ++i) {
+    const auto& record = qbn.opCodes.records.at(i);
+    const auto spec = context.opcodeSpecs.constFind(record.opCode);
+    if (spec == context.opcodeSpecs.constEnd()) {
+      ++unknownOpcodes[record.opCode];
+    } else if (record.argumentCount < spec->minArgs || record.argumentCount > spec->maxArgs) {
+      addIssue(report, Severity::Warning,
+               QString("Opcode %1 (%2) has %3 argument(s), expected %4-%5")
+                   .arg(i)
+                   .arg(spec->name)
+                   .arg(record.argumentCount)
+                   .arg(spec->minArgs)
+                   .arg(spec->maxArgs));
+    }
+    if (record.messageId != 0xFFFF && !messageExists(record.messageId)) {
+      missingMessages[record.messageId].push_back(QString("opcode %1").arg(i));
+    }
+  }
+  for (auto it = unknownOpcodes.cbegin(); it != unknownOpcodes.cend(); ++it) {
+    addIssue(report, Severity::Warning,
+             QString("Unknown opcode 0x%1 in %2 record(s)")
+                 .arg(it.key(), 4, 16, QLatin1Char('0'))
+                 .arg(it.value()));
+  }
+  for (auto it = missingMessages.cbegin(); it != missingMessages.cend(); ++it) {
+    addIssue(report, Severity::Error,
+             QString("Message %1 is in neither the QRC nor TEXT.RSC (used by %2)")
+                 .arg(it.key())
+                 .arg(it.value().join(", ")));
+  }
+
+  // Text variable table: targets must exist, names must be unique.
+  const QHash<int, qsizetype> sectionSizes = {
+      {0, qbn.items.size()},  {3, qbn.npcs.size()}, {4, qbn.locations.size()},
+      {6, qbn.timers.size()}, {7, qbn.mobs.size()}, {9, qbn.states.size()}};
+  QSet<quint32> namedHashes;
+  QSet<QString> seenNames;
+  for (const auto& variable : qbn.textVariables) {
+    if (seenNames.contains(variable.textVariable)) {
+      addIssue(report, Severity::Warning,
+               QString("Text variable %1 is defined more than once").arg(variable.textVariable));
+    }
+    seenNames.insert(variable.textVariable);
+    insertVariableHashes(variable.textVariable, namedHashes);
+
+    const auto size = sectionSizes.constFind(variable.sectionId);
+    if (size == sectionSizes.constEnd()) {
+      addIssue(report, Severity::Error,
+               QString("Text variable %1 points at section %2, which holds no records")
+                   .arg(variable.textVariable)
+                   .arg(variable.sectionId));
+    } else if (variable.recordId >= size.value()) {
+      addIssue(report, Severity::Error,
+               QString("Text variable %1 points at record %2 of section %3, which has %4")
+                   .arg(variable.textVariable)
+                   .arg(variable.recordId)
+                   .arg(variable.sectionId)
+                   .arg(size.value()));
+    }
+  }
+
+  // Without the (debug-only) variable table there is nothing to resolve hashes against.
+  if (!qbn.textVariables.isEmpty()) {
+    int unnamed = 0;
+    auto checkHash = [&](quint32 hash) {
+      unnamed += (hash != 0 && !namedHashes.contains(hash)) ? 1 : 0;
+    };
+    for (const auto& r : qbn.items) {
+      checkHash(r.textVariableHash);
+    }
+    for (const auto& r : qbn.npcs) {
+      checkHash(r.textVariableHash);
+    }
+    for (const auto& r : qbn.locations) {
+      checkHash(r.textVariableHash);
+    }
+    for (const auto& r : qbn.timers) {
+      checkHash(r.textVariableHash);
+    }
+    for (const auto& r : qbn.mobs) {
+      checkHash(r.textVariableHash);
+    }
+    for (const auto& r : qbn.states) {
+      checkHash(r.textVariableHash);
+    }
+    if (unnamed > 0) {
+      addIssue(report, Severity::Warning,
+               QString("%1 record variable hash(es) match no text variable name").arg(unnamed));
+    }
+  }
+
+  // %variables in QRC messages must be ones the game expands.
+  if (qrc != nullptr) {
+    QMap<QString, QList<quint16>> unknownVariables;
+    for (const auto& record : qrc->records) {
+      for (const auto& sub : record.subrecords) {
+        for (const QString& name : DaggerfallTextVariables::extractVariables(sub.text)) {
+          if (DaggerfallTextVariables::namesForHash(DaggerfallTextVariables::hashVariableName(name))
+                  .contains(name)) {
+            continue;
+          }
+          auto& ids = unknownVariables[name];
+          if (ids.isEmpty() || ids.last() != record.id) {
+            ids.push_back(record.id);
+          }
+        }
+      }
+    }
+    for (auto it = unknownVariables.cbegin(); it != unknownVariables.cend(); ++it) {
+      addIssue(report, Severity::Warning,
+               QString("Unknown text variable %%1 in message(s) %2")
+                   .arg(it.key(), joinIds(it.value())));
+    }
+  }
+}
+
+FileReport validateQuest(const QString& qbnPath, const SharedContext& context)
+{
+  FileReport report;
+  report.qbnPath = qbnPath;
+
+  QElapsedTimer timer;
+  timer.start();
+  DaggerfallQbn::File qbn;
+  QString error;
+  if (!DaggerfallQbn::loadFile(qbnPath, qbn, &error)) {
+    report.parseNs = timer.nsecsElapsed();
+    addIssue(report, Severity::Error, QString("QBN: %1").arg(error));
+    return report;
+  }
+  report.parsed = true;
+  report.questId = qbn.header.questId;
+  addWarnings(report, "QBN", qbn.warning);
+
+  XngineRscFormat::TextRecordDatabase qrc;
+  bool hasQrc = false;
+  report.qrcPath = companionQrc(QFileInfo(qbnPath));
+  if (report.qrcPath.isEmpty()) {
+    addIssue(report, Severity::Error, "No companion QRC file");
+  } else {
+    QFile file(report.qrcPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+      addIssue(report, Severity::Error, QString("Unable to open %1").arg(report.qrcPath));
+    } else if (!XngineRscFormat::parseTextRecordDatabase(file.readAll(), qrc, &error)) {
+      addIssue(report, Severity::Error, QString("QRC: %1").arg(error));
+    } else {
+      hasQrc = true;
+      addWarnings(report, "QRC", qrc.warning);
+    }
+  }
+  report.parseNs = timer.nsecsElapsed();
+
+  timer.restart();
+  checkQuest(qbn, hasQrc ? &qrc : nullptr, context, report);
+  report.checkNs = timer.nsecsElapsed();
+  return report;
+}
+
+QString formatMillis(qint64 nanoseconds)
+{
+  return QString::number(static_cast<double>(nanoseconds) / 1.0e6, 'f', 2) + " ms";
+}
+
+}  // namespace
+
+int DaggerfallQuestValidator::FileReport::count(Severity severity) const
+{
+  return static_cast<int>(std::count_if(issues.cbegin(), issues.cend(),
+                                        [severity](const Issue& issue) {
+                                          return issue.severity == severity;
+                                        }));
+}
+
+int DaggerfallQuestValidator::Report::count(Severity severity) const
+{
+  int total = 0;
+  for (const auto& file : files) {
+    total += file.count(severity);
+  }
+  return total;
+}
+
+QStringList DaggerfallQuestValidator::questFiles(const QString& directory)
+{
+  QStringList out;
+  QDirIterator it(directory, {"*.QBN"}, QDir::Files, QDirIterator::Subdirectories);
+  while (it.hasNext()) {
+    out.push_back(it.next());
+  }
+  std::sort(out.begin(), out.end());
+  return out;
+}
+
+DaggerfallQuestValidator::Report
+DaggerfallQuestValidator::validateDirectory(const QString& directory, Options options)
+{
+  if (options.textRscPath.isEmpty()) {
+    const QDir dir(directory);
+    for (const QString& candidate : {dir.filePath("TEXT.RSC"), dir.filePath("../TEXT.RSC")}) {
+      if (QFileInfo::exists(candidate)) {
+        options.textRscPath = QDir::cleanPath(candidate);
+        break;
+      }
+    }
+  }
+  return validateFiles(questFiles(directory), options);
+}
+
+DaggerfallQuestValidator::Report
+DaggerfallQuestValidator::validateFiles(const QStringList& qbnPaths, const Options& options)
+{
+  Report report;
+  QElapsedTimer total;
+  total.start();
+
+  SharedContext context;
+  context.opcodeSpecs = DaggerfallQbnPseudo::opcodeSpecs();
+  DaggerfallTextRsc::Database textRsc;
+  if (!options.textRscPath.isEmpty()) {
+    QElapsedTimer timer;
+    timer.start();
+    QString error;
+    if (DaggerfallTextRsc::loadTextRsc(options.textRscPath, textRsc, &error)) {
+      context.textRsc = &textRsc;
+    } else {
+      report.textRscWarning = error;
+    }
+    report.loadNs = timer.nsecsElapsed();
+  }
+
+  const int count = static_cast<int>(qbnPaths.size());
+  report.files.resize(count);
+  // Each job owns its slot; see DaggerfallArch3dBsa::Reader::loadMeshRecords.
+  FileReport* reportSlots = report.files.data();
+  XngineParallel::parallelFor(
+      count, [&](int index) { reportSlots[index] = validateQuest(qbnPaths.at(index), context); },
+      options.maxThreads);
+
+  report.elapsedNs = total.nsecsElapsed();
+  return report;
+}
+
+QString DaggerfallQuestValidator::formatReport(const Report& report)
+{
+  QString out;
+  if (!report.textRscWarning.isEmpty()) {
+    out += QString("TEXT.RSC not loaded, message ids are checked against the QRC only: %1\n")
+               .arg(report.textRscWarning);
+  }
+  for (const auto& file : report.files) {
+    out += QString("%1: %2 error(s), %3 warning(s)  parse %4, check %5\n")
+               .arg(QDir::toNativeSeparators(file.qbnPath))
+               .arg(file.count(Severity::Error))
+               .arg(file.count(Severity::Warning))
+               .arg(formatMillis(file.parseNs), formatMillis(file.checkNs));
+    for (const auto& issue : file.issues) {
+      out += QString("  %1: %2\n")
+                 .arg(issue.severity == Severity::Error ? "error" : "warning", issue.message);
+    }
+  }
+  out += QString("%1 quest(s), %2 error(s), %3 warning(s) in %4 (TEXT.RSC %5)\n")
+             .arg(report.files.size())
+             .arg(report.count(Severity::Error))
+             .arg(report.count(Severity::Warning))
+             .arg(formatMillis(report.elapsedNs), formatMillis(report.loadNs));
+  return out;
+}
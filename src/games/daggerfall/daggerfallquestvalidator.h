@@ -0,0 +1,80 @@
+#ifndef DAGGERFALL_QUESTVALIDATOR_H
+#define DAGGERFALL_QUESTVALIDATOR_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QtGlobal>
+
+/**
+ * Batch consistency check for a set of quests (QBN files and their companion QRC
+ * message files), as found in ARENA2/QUESTS or a mod's overrides.
+ *
+ * Quests are parsed and checked in parallel, one quest per job. TEXT.RSC is loaded
+ * once (header table only, see DaggerfallTextRsc::Database) and shared read-only by
+ * every job. Per quest it reports:
+ *   errors    QBN/QRC parse failures, a missing QRC, message ids used by opcodes or
+ *             item/NPC/location records that neither the QRC nor TEXT.RSC defines,
+ *             text variables pointing at records that do not exist
+ *   warnings  parse warnings, unknown opcodes or argument counts outside the opcode
+ *             spec, record variable hashes without a named text variable (only when
+ *             the QBN carries its text variable table), duplicate text variable
+ *             names, and %variables in QRC messages that Daggerfall does not define
+ */
+class DaggerfallQuestValidator
+{
+public:
+  enum class Severity
+  {
+    Warning,
+    Error,
+  };
+
+  struct Issue
+  {
+    Severity severity = Severity::Warning;
+    QString message;
+  };
+
+  struct FileReport
+  {
+    QString qbnPath;
+    QString qrcPath;  // empty when no companion QRC was found
+    quint16 questId = 0;
+    bool parsed = false;
+    QVector<Issue> issues;
+    qint64 parseNs = 0;  // reading and parsing QBN + QRC
+    qint64 checkNs = 0;  // cross-referencing
+
+    int count(Severity severity) const;
+  };
+
+  struct Options
+  {
+    QString textRscPath;  // cross-reference target; empty skips TEXT.RSC lookups
+    int maxThreads = 0;   // 0 = QThread::idealThreadCount()
+  };
+
+  struct Report
+  {
+    QVector<FileReport> files;  // in input order
+    QString textRscWarning;     // TEXT.RSC could not be loaded
+    qint64 loadNs = 0;          // TEXT.RSC header table
+    qint64 elapsedNs = 0;       // whole batch, wall clock
+
+    int count(Severity severity) const;
+  };
+
+  // *.QBN files under directory, recursively, sorted by path.
+  static QStringList questFiles(const QString& directory);
+
+  // questFiles(directory); TEXT.RSC defaults to directory/TEXT.RSC, then the
+  // parent directory's TEXT.RSC (for ARENA2/QUESTS).
+  static Report validateDirectory(const QString& directory, Options options = Options{});
+  static Report validateFiles(const QStringList& qbnPaths, const Options& options = Options{});
+
+  // Plain-text summary: one block per quest with issues, then totals and timing.
+  static QString formatReport(const Report& report);
+};
+
+#endif  // DAGGERFALL_QUESTVALIDATOR_H
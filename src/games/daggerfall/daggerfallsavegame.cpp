@@ -1,9 +1,14 @@
 #include "daggerfallsavegame.h"
 
 #include "daggerfallcommon.h"
+#ifdef XNGINE_HEADLESS
+#include "xngineheadless.h"
+#else
 #include "gamedaggerfall.h"
+#endif
 #include "daggerfallmapsbsa.h"
 #include "xnginepaletteformat.h"
+#include "xnginesaveview.h"
 
 #include <QDir>
 #include <QFile>
@@ -140,19 +145,14 @@ std::unique_ptr<XngineSaveGame::DataFields> DaggerfallsSaveGame::fetchDataFields
 {
   auto fields = std::make_unique<DataFields>();
 
-  QFile imageFile(saveFilePath("IMAGE.RAW"));
-  if (!imageFile.open(QIODevice::ReadOnly)) {
-    return fields;
-  }
-
-  QByteArray raw = imageFile.readAll();
+  const XngineSaveView raw(saveFilePath("IMAGE.RAW"));
   if (raw.size() < kImageRawSize8) {
     return fields;
   }
 
   QImage image(static_cast<int>(kImageWidth), static_cast<int>(kImageHeight),
                QImage::Format_RGB32);
-  const auto* ptr = reinterpret_cast<const uchar*>(raw.constData());
+  const uchar* ptr = raw.data();
 
   if (raw.size() >= kImageRawSize15) {
     // 15-bit RGB (5:5:5) raw.
@@ -190,22 +190,13 @@ std::unique_ptr<XngineSaveGame::DataFields> DaggerfallsSaveGame::fetchDataFields
 
 bool DaggerfallsSaveGame::parseSaveName()
 {
-  QFile saveNameFile(saveFilePath("SAVENAME.TXT"));
-  if (!saveNameFile.open(QIODevice::ReadOnly)) {
+  const XngineSaveView view(saveFilePath("SAVENAME.TXT"));
+  if (view.isEmpty()) {
     return false;
   }
 
-  QByteArray bytes = saveNameFile.read(kSaveNameLength);
-  if (bytes.isEmpty()) {
-    return false;
-  }
-
-  const int nullPos = bytes.indexOf('\0');
-  if (nullPos >= 0) {
-    bytes.truncate(nullPos);
-  }
-
-  const QString saveName = QString::fromLocal8Bit(bytes).trimmed();
+  const QString saveName =
+      view.readFixedString(0, std::min<qsizetype>(view.size(), kSaveNameLength));
   if (!saveName.isEmpty()) {
     m_DisplayName = saveName;
     return true;
@@ -280,14 +271,22 @@ QString DaggerfallsSaveGame::getGameDetails() const
   return lines.join("<br/>");
 }
 
-bool DaggerfallsSaveGame::parseSaveTree()
+XngineSaveGame::Metadata DaggerfallsSaveGame::metadata() const
 {
-  QFile saveTreeFile(saveFilePath("SAVETREE.DAT"));
-  if (!saveTreeFile.open(QIODevice::ReadOnly)) {
-    return false;
-  }
+  Metadata meta = XngineSaveGame::metadata();
+  if (!m_LocationNameDetail.isEmpty()) {
+    meta.location = m_LocationNameDetail;
+  }
+  meta.region        = m_LocationRegionNameDetail;
+  meta.inGameDate    = m_InGameDate;
+  meta.inGameMinutes = m_InGameMinutes;
+  meta.gold          = m_Gold;
+  return meta;
+}
 
-  const QByteArray data = saveTreeFile.readAll();
+bool DaggerfallsSaveGame::parseSaveTree()
+{
+  const XngineSaveView data(saveFilePath("SAVETREE.DAT"));
   if (data.size() < 16) {
     return false;
   }
@@ -300,12 +299,12 @@ bool DaggerfallsSaveGame::parseSaveTree()
   quint16 locationCode = 0;
   quint8 zoneType = 0;
   if (data.size() >= kHeaderSize &&
-      readLE32U(data, 0x00, version) &&
-      readLE32(data, 0x04, headerX) &&
-      readLE32(data, 0x08, headerY) &&
-      readLE32(data, 0x0c, headerZ) &&
-      readLE16U(data, 0x10, locationCode) &&
-      readU8(data, 0x12, zoneType)) {
+      data.readLE32U(0x00, version) &&
+      data.readLE32(0x04, headerX) &&
+      data.readLE32(0x08, headerY) &&
+      data.readLE32(0x0c, headerZ) &&
+      data.readLE16U(0x10, locationCode) &&
+      data.readU8(0x12, zoneType)) {
     // Keep this as fallback if we do not find a better in-record player position.
     m_PCLocation = formatHeaderLocationText(locationCode, zoneType, headerX, headerY, headerZ);
     Q_UNUSED(version);
@@ -333,7 +332,7 @@ bool DaggerfallsSaveGame::parseSaveTree()
     }
 
     qint32 parentType = 0;
-    if (readLE32(data, record.payloadOffset + 67, parentType) &&
+    if (data.readLE32(record.payloadOffset + 67, parentType) &&
         parentType == kRecordTypeCharacter) {
       bestPosition = &record;
       break;
@@ -347,36 +346,37 @@ bool DaggerfallsSaveGame::parseSaveTree()
   if (characterRecord != nullptr) {
     const qsizetype recordDataOffset = characterRecord->payloadOffset + kRecordBaseSize;
     const QString characterName =
-        readFixedString(data, recordDataOffset + kCharacterRecordNameOffset,
-                        kCharacterRecordNameLength);
+        data.readFixedString(recordDataOffset + kCharacterRecordNameOffset,
+                             kCharacterRecordNameLength);
     if (!characterName.isEmpty()) {
       m_PCName = characterName;
     }
 
     const QString className =
-        readFixedString(data, recordDataOffset + kCharacterRecordClassOffset,
-                        kCharacterRecordClassLength);
+        data.readFixedString(recordDataOffset + kCharacterRecordClassOffset,
+                             kCharacterRecordClassLength);
     if (isLikelyClassName(className)) {
       m_ClassName = className;
     }
 
     quint8 level = 0;
-    if (readU8(data, recordDataOffset + kCharacterRecordLevelOffset, level) && level > 0) {
+    if (data.readU8(recordDataOffset + kCharacterRecordLevelOffset, level) && level > 0) {
       m_PCLevel = level;
     }
 
-    readU8(data, recordDataOffset + kCharacterRecordRaceOffset, m_Race);
-    readU8(data, recordDataOffset + kCharacterRecordReflexOffset, m_Reflex);
-    readLE16U(data, recordDataOffset + kCharacterRecordHealthOffset, m_HP);
-    readLE16U(data, recordDataOffset + kCharacterRecordHealthOffset + 2, m_HPMax);
-    readLE16U(data, recordDataOffset + kCharacterRecordManaOffset, m_Mana);
-    readLE16U(data, recordDataOffset + kCharacterRecordManaOffset + 2, m_ManaMax);
-    readLE32U(data, recordDataOffset + kCharacterRecordGoldOffset, m_Gold);
+    data.readU8(recordDataOffset + kCharacterRecordRaceOffset, m_Race);
+    data.readU8(recordDataOffset + kCharacterRecordReflexOffset, m_Reflex);
+    data.readLE16U(recordDataOffset + kCharacterRecordHealthOffset, m_HP);
+    data.readLE16U(recordDataOffset + kCharacterRecordHealthOffset + 2, m_HPMax);
+    data.readLE16U(recordDataOffset + kCharacterRecordManaOffset, m_Mana);
+    data.readLE16U(recordDataOffset + kCharacterRecordManaOffset + 2, m_ManaMax);
+    data.readLE32U(recordDataOffset + kCharacterRecordGoldOffset, m_Gold);
 
     quint32 timestamp = 0;
-    if (readLE32U(data, recordDataOffset + kCharacterRecordTimestampOffset, timestamp) &&
+    if (data.readLE32U(recordDataOffset + kCharacterRecordTimestampOffset, timestamp) &&
         timestamp > 0) {
       m_InGameDate = formatDaggerfallDate(timestamp);
+      m_InGameMinutes = timestamp;
     }
   }
 
@@ -385,10 +385,10 @@ bool DaggerfallsSaveGame::parseSaveTree()
     quint16 yOffset = 0;
     quint16 yBase = 0;
     qint32 z = 0;
-    if (readLE32(data, bestPosition->payloadOffset + 7, x) &&
-        readLE16U(data, bestPosition->payloadOffset + 11, yOffset) &&
-        readLE16U(data, bestPosition->payloadOffset + 13, yBase) &&
-        readLE32(data, bestPosition->payloadOffset + 15, z)) {
+    if (data.readLE32(bestPosition->payloadOffset + 7, x) &&
+        data.readLE16U(bestPosition->payloadOffset + 11, yOffset) &&
+        data.readLE16U(bestPosition->payloadOffset + 13, yBase) &&
+        data.readLE32(bestPosition->payloadOffset + 15, z)) {
       if (m_PCLocation.isEmpty()) {
         m_PCLocation = formatPositionText(x, yOffset, yBase, z);
       }
@@ -400,122 +400,74 @@ bool DaggerfallsSaveGame::parseSaveTree()
 
 bool DaggerfallsSaveGame::parseSaveVars()
 {
-  QFile f(saveFilePath("SAVEVARS.DAT"));
-  if (!f.open(QIODevice::ReadOnly)) {
-    return false;
-  }
-  const QByteArray data = f.readAll();
+  const XngineSaveView data(saveFilePath("SAVEVARS.DAT"));
   if (data.size() < 0x3cd) {
     return false;
   }
 
   quint32 timestamp = 0;
-  if (!readLE32U(data, 0x3c9, timestamp) || timestamp == 0) {
+  if (!data.readLE32U(0x3c9, timestamp) || timestamp == 0) {
     return false;
   }
 
   // Prefer character timestamp if available, fallback to SAVEVARS timestamp.
   if (m_InGameDate.isEmpty()) {
     m_InGameDate = formatDaggerfallDate(timestamp);
+    m_InGameMinutes = timestamp;
   }
   return true;
 }
 
-bool DaggerfallsSaveGame::readLE32(const QByteArray& data, qsizetype offset,
-                                   qint32& value)
-{
-  if (offset < 0 || offset + static_cast<qsizetype>(sizeof(qint32)) > data.size()) {
-    return false;
-  }
-
-  qint32 tmp = 0;
-  std::memcpy(&tmp, data.constData() + offset, sizeof(tmp));
-  value = qFromLittleEndian(tmp);
-  return true;
-}
-
-bool DaggerfallsSaveGame::readLE32U(const QByteArray& data, qsizetype offset,
-                                    quint32& value)
-{
-  if (offset < 0 || offset + static_cast<qsizetype>(sizeof(quint32)) > data.size()) {
-    return false;
-  }
-
-  quint32 tmp = 0;
-  std::memcpy(&tmp, data.constData() + offset, sizeof(tmp));
-  value = qFromLittleEndian(tmp);
-  return true;
-}
-
-bool DaggerfallsSaveGame::readLE16U(const QByteArray& data, qsizetype offset,
-                                    quint16& value)
-{
-  if (offset < 0 || offset + static_cast<qsizetype>(sizeof(quint16)) > data.size()) {
-    return false;
-  }
-
-  quint16 tmp = 0;
-  std::memcpy(&tmp, data.constData() + offset, sizeof(tmp));
-  value = qFromLittleEndian(tmp);
-  return true;
-}
-
-bool DaggerfallsSaveGame::readU8(const QByteArray& data, qsizetype offset, quint8& value)
-{
-  if (offset < 0 || offset >= data.size()) {
-    return false;
-  }
-  value = static_cast<quint8>(data.at(offset));
-  return true;
-}
-
 std::vector<DaggerfallsSaveGame::ParsedRecord> DaggerfallsSaveGame::parseRecordStream(
-    const QByteArray& data, qsizetype startOffset, qsizetype* endOffset)
+    const XngineSaveView& data, qsizetype startOffset, qsizetype* endOffset)
 {
   std::vector<ParsedRecord> records;
-  qsizetype pos = startOffset;
+  XngineSaveView::Cursor cursor = data.cursor(startOffset);
 
-  while (pos + 4 <= data.size()) {
+  while (cursor.remaining() >= 4) {
+    const qsizetype recordStart = cursor.pos();
     qint32 recordLength = 0;
-    if (!readLE32(data, pos, recordLength) || recordLength < 0) {
+    if (!cursor.readLE(recordLength) || recordLength < 0) {
+      cursor.seek(recordStart);
       break;
     }
 
     if (recordLength == 0) {
-      pos += 4;
       continue;
     }
 
-    if (pos + 4 + recordLength > data.size()) {
+    if (recordLength > cursor.remaining()) {
+      cursor.seek(recordStart);
       break;
     }
 
-    const qsizetype payloadOffset = pos + 4;
+    const qsizetype payloadOffset = cursor.pos();
     qsizetype payloadLength = recordLength;
-    const quint8 recordType = static_cast<quint8>(data.at(payloadOffset));
+    const quint8 recordType = *cursor.current();
 
     // Daggerfall's dungeon-information records report compressed length units.
     if (recordType == kRecordTypeDungeonInformation) {
       const qsizetype correctedLength = payloadLength * 39;
-      if (payloadLength <= 0 || pos + 4 + correctedLength > data.size()) {
+      if (payloadLength <= 0 || correctedLength > cursor.remaining()) {
+        cursor.seek(recordStart);
         break;
       }
       payloadLength = correctedLength;
     }
 
     records.push_back({recordType, payloadOffset, payloadLength});
-    pos += 4 + payloadLength;
+    cursor.skip(payloadLength);
   }
 
   if (endOffset != nullptr) {
-    *endOffset = pos;
+    *endOffset = cursor.pos();
   }
 
   return records;
 }
 
 std::vector<DaggerfallsSaveGame::ParsedRecord> DaggerfallsSaveGame::findBestRecordStream(
-    const QByteArray& data, qsizetype* startOffset, qsizetype* endOffset)
+    const XngineSaveView& data, qsizetype* startOffset, qsizetype* endOffset)
 {
   std::vector<ParsedRecord> bestRecords;
   qsizetype bestStart = 0;
@@ -702,21 +654,6 @@ QString DaggerfallsSaveGame::reflexName(quint8 reflex)
   }
 }
 
-QString DaggerfallsSaveGame::readFixedString(const QByteArray& data, qsizetype offset,
-                                             qsizetype size)
-{
-  if (offset < 0 || size <= 0 || offset + size > data.size()) {
-    return {};
-  }
-
-  QByteArray bytes = data.mid(offset, size);
-  const int nullPos = bytes.indexOf('\0');
-  if (nullPos >= 0) {
-    bytes.truncate(nullPos);
-  }
-  return QString::fromLocal8Bit(bytes).trimmed();
-}
-
 QString DaggerfallsSaveGame::saveFilePath(const QString& fileName) const
 {
   return QDir(m_SaveFolder).filePath(fileName);
@@ -11,6 +11,7 @@
 #include <vector>
 
 class GameDaggerfall;
+class XngineSaveView;
 
 /**
  * Daggerfall-specific save game handler.
@@ -23,6 +24,7 @@ public:
   virtual QString getName() const override;
   virtual QString getPCLocation() const override;
   virtual QString getGameDetails() const override;
+  virtual Metadata metadata() const override;
 
 protected:
   virtual std::unique_ptr<DataFields> fetchDataFields() const override;
@@ -38,17 +40,12 @@ private:
   bool parseSaveTree();
   bool parseSaveName();
   bool parseSaveVars();
-  static bool readLE32(const QByteArray& data, qsizetype offset, qint32& value);
-  static bool readLE32U(const QByteArray& data, qsizetype offset, quint32& value);
-  static bool readLE16U(const QByteArray& data, qsizetype offset, quint16& value);
-  static bool readU8(const QByteArray& data, qsizetype offset, quint8& value);
-  static std::vector<ParsedRecord> parseRecordStream(const QByteArray& data,
+  static std::vector<ParsedRecord> parseRecordStream(const XngineSaveView& data,
                                                      qsizetype startOffset,
                                                      qsizetype* endOffset);
-  static std::vector<ParsedRecord> findBestRecordStream(const QByteArray& data,
+  static std::vector<ParsedRecord> findBestRecordStream(const XngineSaveView& data,
                                                         qsizetype* startOffset,
                                                         qsizetype* endOffset);
-  static QString readFixedString(const QByteArray& data, qsizetype offset, qsizetype size);
   static QString formatPositionText(qint32 x, quint16 yOffset, quint16 yBase, qint32 z);
   QString formatHeaderLocationText(quint16 locationCode, quint8 zoneType, qint32 x, qint32 y,
                                    qint32 z);
@@ -70,6 +67,7 @@ private:
   QString m_ClassName;
   quint8 m_Reflex = 0xFF;
   QString m_InGameDate;
+  quint32 m_InGameMinutes = 0;
   QString m_LocationNameDetail;
   QString m_LocationTypeNameDetail;
   QString m_LocationRegionNameDetail;
@@ -4,15 +4,19 @@
 
 #include <algorithm>
 
+namespace {
+
 QVector<DaggerfallTextRecord::Token>
-DaggerfallTextRecord::tokenizeSubrecord(const QByteArray& bytes)
+convertTokens(const QVector<XngineRscFormat::TextTokenSpan>& core)
 {
-  QVector<Token> out;
-  const auto core = XngineRscFormat::tokenizeTextSubrecord(bytes);
+  using TokenType = DaggerfallTextRecord::TokenType;
+
+  QVector<DaggerfallTextRecord::Token> out;
   out.reserve(core.size());
   for (const auto& t : core) {
-    Token tt;
-    tt.bytes = t.bytes;
+    DaggerfallTextRecord::Token tt;
+    tt.offset = t.offset;
+    tt.length = t.length;
     switch (t.type) {
       case XngineRscFormat::TextTokenType::Printable: tt.type = TokenType::Printable; break;
       case XngineRscFormat::TextTokenType::FontCode: tt.type = TokenType::FontCode; break;
@@ -29,6 +33,14 @@ DaggerfallTextRecord::tokenizeSubrecord(const QByteArray& bytes)
   return out;
 }
 
+}  // namespace
+
+QVector<DaggerfallTextRecord::Token>
+DaggerfallTextRecord::tokenizeSubrecord(const QByteArray& bytes)
+{
+  return convertTokens(XngineRscFormat::tokenizeTextSubrecordSpans(bytes));
+}
+
 QString DaggerfallTextRecord::decodeSubrecordText(const QByteArray& bytes)
 {
   return XngineRscFormat::decodeTextSubrecordText(bytes);
@@ -53,7 +65,7 @@ bool DaggerfallTextRecord::parseRecord(const QByteArray& bytes, Record& outRecor
     s.raw = sub.raw;
     s.text = sub.text;
     s.variables = DaggerfallTextVariables::extractVariables(s.text);
-    s.tokens = tokenizeSubrecord(sub.raw);
+    s.tokens = convertTokens(sub.tokens);
     outRecord.subrecords.push_back(s);
   }
 
@@ -89,7 +101,7 @@ bool DaggerfallTextRecord::parseDatabase(const QByteArray& bytes, Database& outD
       s.raw = cs.raw;
       s.text = cs.text;
       s.variables = DaggerfallTextVariables::extractVariables(s.text);
-      s.tokens = tokenizeSubrecord(cs.raw);
+      s.tokens = convertTokens(cs.tokens);
       r.subrecords.push_back(s);
     }
     outDb.records.push_back(r);
@@ -22,10 +22,15 @@ public:
     RawControl
   };
 
+  // Span of Subrecord::raw; printable runs are a single token (see
+  // XngineRscFormat::TextTokenSpan).
   struct Token
   {
     TokenType type = TokenType::RawControl;
-    QByteArray bytes;
+    qint32 offset = 0;
+    qint32 length = 0;
+
+    QByteArray bytes(const QByteArray& raw) const { return raw.mid(offset, length); }
   };
 
   struct Subrecord
@@ -2,8 +2,13 @@
 #include "daggerfallformatutils.h"
 #include "daggerfalltextrecord.h"
 #include "daggerfalltextrscindices.h"
+#include "xnginerscformat.h"
 
 #include <QFile>
+#include <QMutexLocker>
+
+#include <utility>
+
 namespace {
 
 using Daggerfall::FormatUtil::setError;
@@ -47,6 +52,76 @@ QString DaggerfallTextRsc::formatRecordLabel(quint16 textRecordId,
   return QString("Record %1 (%2)").arg(textRecordId).arg(categoryLabel.trimmed());
 }
 
+int DaggerfallTextRsc::Database::recordCount() const
+{
+  return m_State ? static_cast<int>(m_State->entries.size()) : 0;
+}
+
+QVector<quint16> DaggerfallTextRsc::Database::recordIds() const
+{
+  QVector<quint16> ids;
+  if (!m_State) {
+    return ids;
+  }
+  ids.reserve(m_State->entries.size());
+  for (const auto& entry : m_State->entries) {
+    ids.push_back(entry.textRecordId);
+  }
+  return ids;
+}
+
+int DaggerfallTextRsc::Database::recordIndex(quint16 textRecordId) const
+{
+  return m_State ? m_State->indexById.value(textRecordId, -1) : -1;
+}
+
+const DaggerfallTextRsc::TextRecord* DaggerfallTextRsc::Database::record(int index) const
+{
+  if (!m_State || index < 0 || index >= m_State->entries.size()) {
+    return nullptr;
+  }
+
+  QMutexLocker locker(&m_State->mutex);
+  Slot& entry = m_State->entries[index];
+  if (!entry.decoded) {
+    entry.decoded = true;
+    ++m_State->decodedCount;
+    TextRecord tr;
+    const QByteArray raw = m_State->bytes.mid(entry.offset, entry.length);
+    if (parseTextRecordBytes(raw, index, tr, &entry.error)) {
+      tr.textRecordId = entry.textRecordId;
+      tr.categoryLabel = categoryLabelForRecordId(tr.textRecordId);
+      tr.displayLabel = formatRecordLabel(tr.textRecordId, tr.categoryLabel);
+      entry.record = std::move(tr);
+    }
+  }
+  return entry.record.isValid() ? &entry.record : nullptr;
+}
+
+const DaggerfallTextRsc::TextRecord*
+DaggerfallTextRsc::Database::recordById(quint16 textRecordId) const
+{
+  return record(recordIndex(textRecordId));
+}
+
+QString DaggerfallTextRsc::Database::recordError(int index) const
+{
+  if (!m_State || index < 0 || index >= m_State->entries.size()) {
+    return {};
+  }
+  QMutexLocker locker(&m_State->mutex);
+  return m_State->entries.at(index).error;
+}
+
+int DaggerfallTextRsc::Database::decodedRecordCount() const
+{
+  if (!m_State) {
+    return 0;
+  }
+  QMutexLocker locker(&m_State->mutex);
+  return m_State->decodedCount;
+}
+
 bool DaggerfallTextRsc::loadTextRsc(const QString& filePath, Database& outDb,
                                     QString* errorMessage)
 {
@@ -56,38 +131,37 @@ bool DaggerfallTextRsc::loadTextRsc(const QString& filePath, Database& outDb,
   if (!f.open(QIODevice::ReadOnly)) {
     return setError(errorMessage, QString("Unable to open TEXT.RSC: %1").arg(filePath));
   }
-  const QByteArray data = f.readAll();
-  DaggerfallTextRecord::Database parsedDb;
-  if (!DaggerfallTextRecord::parseDatabase(data, parsedDb, errorMessage)) {
+  auto state = std::make_shared<Database::State>();
+  state->bytes = f.readAll();
+
+  XngineRscFormat::TextRecordDatabase index;
+  QVector<XngineRscFormat::TextRecordSlice> slices;
+  if (!XngineRscFormat::parseTextRecordIndex(state->bytes, index, slices, errorMessage)) {
     return false;
   }
-  outDb.textRecordHeaderLength = parsedDb.headerLength;
-  outDb.textRecordCount = parsedDb.recordCount;
-  outDb.warning = parsedDb.warning;
-  outDb.headers.reserve(parsedDb.headers.size());
-  for (const auto& h : parsedDb.headers) {
-    outDb.headers.push_back({h.id, h.offset});
+  if (slices.isEmpty()) {
+    return setError(errorMessage, "TEXT.RSC parsed, but no usable records were found");
   }
-  for (int i = 0; i < parsedDb.records.size(); ++i) {
-    const auto& r = parsedDb.records.at(i);
-    TextRecord tr;
-    tr.index = i;
-    tr.textRecordId = r.id;
-    tr.categoryLabel = categoryLabelForRecordId(tr.textRecordId);
-    tr.displayLabel = formatRecordLabel(tr.textRecordId, tr.categoryLabel);
-    tr.rawBytes = r.raw;
-    tr.warning = r.warning;
-    tr.subrecords.reserve(r.subrecords.size());
-    for (const auto& sub : r.subrecords) {
-      tr.subrecords.push_back({sub.raw, sub.text, sub.variables});
-    }
-    outDb.records.insert(i, tr);
-    outDb.recordsById.insert(tr.textRecordId, tr);
+
+  outDb.textRecordHeaderLength = index.headerLength;
+  outDb.textRecordCount = index.recordCount;
+  outDb.warning = index.warning;
+  outDb.headers.reserve(index.headers.size());
+  for (const auto& h : index.headers) {
+    outDb.headers.push_back({h.id, h.offset});
   }
 
-  if (outDb.records.isEmpty()) {
-    return setError(errorMessage, "TEXT.RSC parsed, but no usable records were decoded");
+  state->entries.resize(slices.size());
+  state->indexById.reserve(slices.size());
+  for (int i = 0; i < slices.size(); ++i) {
+    const auto& slice = slices.at(i);
+    auto& entry = state->entries[i];
+    entry.textRecordId = slice.id;
+    entry.offset = slice.offset;
+    entry.length = slice.length;
+    state->indexById.insert(slice.id, i);  // last record wins for duplicate ids
   }
+  outDb.m_State = std::move(state);
 
   return true;
 }
@@ -3,10 +3,13 @@
 
 #include <QByteArray>
 #include <QHash>
+#include <QMutex>
 #include <QString>
 #include <QStringList>
 #include <QVector>
 
+#include <memory>
+
 class DaggerfallTextRsc
 {
 public:
@@ -35,14 +38,57 @@ public:
     bool isValid() const { return index >= 0; }
   };
 
+  /**
+   * TEXT.RSC with only the header table parsed. Each record keeps its byte slice
+   * of the file and is decoded (subrecords, text, variables) the first time it is
+   * accessed, so looking up a few strings does not decode the whole file.
+   *
+   * Records live once in a vector; recordIndex() maps ids to positions in it.
+   * Copies share the decoded records. Accessors are safe to call from several
+   * threads.
+   */
   struct Database
   {
     quint16 textRecordHeaderLength = 0;
     int textRecordCount = 0;
     QVector<TextRecordHeader> headers;
-    QHash<int, TextRecord> records;
-    QHash<quint16, TextRecord> recordsById;
     QString warning;
+
+    int recordCount() const;
+    QVector<quint16> recordIds() const;  // file order
+    int recordIndex(quint16 textRecordId) const;  // -1 when absent
+
+    // nullptr when out of range, absent, or the record failed to decode; the
+    // decode error is then in recordError().
+    const TextRecord* record(int index) const;
+    const TextRecord* recordById(quint16 textRecordId) const;
+    QString recordError(int index) const;
+
+    int decodedRecordCount() const;
+
+  private:
+    friend class DaggerfallTextRsc;
+
+    struct Slot
+    {
+      quint16 textRecordId = 0;
+      quint32 offset = 0;
+      qint32 length = 0;
+      bool decoded = false;
+      TextRecord record;
+      QString error;
+    };
+
+    struct State
+    {
+      QByteArray bytes;
+      QVector<Slot> entries;
+      QHash<quint16, int> indexById;
+      QMutex mutex;
+      int decodedCount = 0;
+    };
+
+    std::shared_ptr<State> m_State;
   };
 
   static bool loadTextRsc(const QString& filePath, Database& outDb,
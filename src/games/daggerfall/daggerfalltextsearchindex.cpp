@@ -0,0 +1,600 @@
+#include "daggerfalltextsearchindex.h"
+#include "daggerfallbooktxt.h"
+#include "daggerfallformatutils.h"
+#include "xnginederivedcache.h"
+#include "xnginerscformat.h"
+
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QLatin1String>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <map>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using Daggerfall::FormatUtil::setError;
+using SourceType = DaggerfallTextSearchIndex::SourceType;
+using Cache = XngineDerivedCache;
+
+const Cache::Format kFormat = {{'D', 'F', 'T', 'X'}, 1, "Text search index", "set of text files"};
+constexpr qsizetype kHeaderSize = Cache::kHeaderSize + 5 * 4;
+constexpr qsizetype kSourceRecordSize = 12;
+constexpr qsizetype kDocumentRecordSize = 16;
+constexpr qsizetype kTermRecordSize = 20;
+
+quint32 readU32(const uchar* data, qsizetype index = 0)
+{
+  return qFromLittleEndian<quint32>(data + index * 4);
+}
+
+bool isWordByte(char c)
+{
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
+}
+
+bool isVariableByte(char c)
+{
+  return isWordByte(c) || c == '_';
+}
+
+bool sourceTypeForFile(const QString& fileName, SourceType& outType)
+{
+  const QString upper = fileName.toUpper();
+  if (upper.endsWith(".RSC")) {
+    outType = SourceType::TextRsc;
+  } else if (upper.startsWith("BOOK") && upper.endsWith(".TXT")) {
+    outType = SourceType::Book;
+  } else if (upper.endsWith(".QRC")) {
+    outType = SourceType::Qrc;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+int compareBytes(QByteArrayView a, QByteArrayView b)
+{
+  const qsizetype common = std::min(a.size(), b.size());
+  const int c = common > 0 ? std::memcmp(a.data(), b.data(), static_cast<size_t>(common)) : 0;
+  if (c != 0) {
+    return c;
+  }
+  return a.size() < b.size() ? -1 : (a.size() > b.size() ? 1 : 0);
+}
+
+}  // namespace
+
+class DaggerfallTextSearchIndex::Builder
+{
+public:
+  quint32 addSource(SourceType type, const QString& name)
+  {
+    m_Sources.push_back({static_cast<quint32>(type), name.toLatin1()});
+    return static_cast<quint32>(m_Sources.size() - 1);
+  }
+
+  void addDocument(quint32 source, quint32 recordId, const QString& text)
+  {
+    const auto document = static_cast<quint32>(m_Documents.size());
+    m_Documents.push_back({source, recordId, text.toLatin1()});
+
+    const QByteArray& bytes = m_Documents.last().text;
+    const char* data = bytes.constData();
+    const qsizetype size = bytes.size();
+    qsizetype i = 0;
+    while (i < size) {
+      if (data[i] == '%') {
+        qsizetype end = i + 1;
+        while (end < size && isVariableByte(data[end])) {
+          ++end;
+        }
+        if (end > i + 1) {
+          addPosting(TermKind::Variable, QByteArray(data + i + 1, end - i - 1), document);
+        }
+        i = end;
+        continue;
+      }
+      if (isWordByte(data[i])) {
+        qsizetype end = i + 1;
+        while (end < size && isWordByte(data[end])) {
+          ++end;
+        }
+        addPosting(TermKind::Word, QByteArray(data + i, end - i).toLower(), document);
+        i = end;
+        continue;
+      }
+      ++i;
+    }
+  }
+
+  // Appends every document of segment under source, reusing its postings.
+  void addSegment(const DaggerfallTextSearchIndex& segment, quint32 source)
+  {
+    const auto documentBase = static_cast<quint32>(m_Documents.size());
+    for (quint32 d = 0; d < segment.m_DocumentCount; ++d) {
+      const uchar* record = segment.m_Documents + d * kDocumentRecordSize;
+      const QByteArrayView text = segment.poolView(readU32(record, 2), readU32(record, 3));
+      m_Documents.push_back({source, readU32(record, 1), text.toByteArray()});
+    }
+    for (quint32 t = 0; t < segment.m_TermCount; ++t) {
+      const uchar* record = segment.m_Terms + t * kTermRecordSize;
+      const QByteArrayView text = segment.poolView(readU32(record, 1), readU32(record, 2));
+      auto& list = m_Terms[{readU32(record), text.toByteArray()}];
+      const quint32 first = readU32(record, 3);
+      const quint32 count = readU32(record, 4);
+      for (quint32 p = first; p < first + count; ++p) {
+        list.push_back(documentBase + readU32(segment.m_Postings, p));
+      }
+    }
+  }
+
+  bool isEmpty() const { return m_Documents.isEmpty(); }
+
+  QByteArray serialize(const QString& hash) const
+  {
+    QByteArray pool;
+    QByteArray sources;
+    for (const auto& source : m_Sources) {
+      Cache::appendLE<quint32>(sources, source.type);
+      Cache::appendLE<quint32>(sources, static_cast<quint32>(pool.size()));
+      Cache::appendLE<quint32>(sources, static_cast<quint32>(source.name.size()));
+      pool.append(source.name);
+    }
+
+    QByteArray terms;
+    QByteArray postings;
+    quint32 postingCount = 0;
+    terms.reserve(static_cast<qsizetype>(m_Terms.size()) * kTermRecordSize);
+    for (const auto& [key, list] : m_Terms) {
+      Cache::appendLE<quint32>(terms, key.first);
+      Cache::appendLE<quint32>(terms, static_cast<quint32>(pool.size()));
+      Cache::appendLE<quint32>(terms, static_cast<quint32>(key.second.size()));
+      Cache::appendLE<quint32>(terms, postingCount);
+      Cache::appendLE<quint32>(terms, static_cast<quint32>(list.size()));
+      pool.append(key.second);
+      for (const quint32 document : list) {
+        Cache::appendLE<quint32>(postings, document);
+      }
+      postingCount += static_cast<quint32>(list.size());
+    }
+
+    QByteArray documents;
+    documents.reserve(m_Documents.size() * kDocumentRecordSize);
+    for (const auto& document : m_Documents) {
+      Cache::appendLE<quint32>(documents, document.source);
+      Cache::appendLE<quint32>(documents, document.recordId);
+      Cache::appendLE<quint32>(documents, static_cast<quint32>(pool.size()));
+      Cache::appendLE<quint32>(documents, static_cast<quint32>(document.text.size()));
+      pool.append(document.text);
+    }
+
+    QByteArray out;
+    out.reserve(kHeaderSize + sources.size() + documents.size() + terms.size() +
+                postings.size() + pool.size());
+    Cache::appendHeader(out, kFormat, hash);
+    Cache::appendLE<quint32>(out, static_cast<quint32>(m_Sources.size()));
+    Cache::appendLE<quint32>(out, static_cast<quint32>(m_Documents.size()));
+    Cache::appendLE<quint32>(out, static_cast<quint32>(m_Terms.size()));
+    Cache::appendLE<quint32>(out, postingCount);
+    Cache::appendLE<quint32>(out, static_cast<quint32>(pool.size()));
+    out.append(sources);
+    out.append(documents);
+    out.append(terms);
+    out.append(postings);
+    out.append(pool);
+    return out;
+  }
+
+private:
+  struct Source
+  {
+    quint32 type = 0;
+    QByteArray name;
+  };
+
+  struct Document
+  {
+    quint32 source = 0;
+    quint32 recordId = 0;
+    QByteArray text;
+  };
+
+  void addPosting(TermKind kind, QByteArray term, quint32 document)
+  {
+    auto& list = m_Terms[{static_cast<quint32>(kind), std::move(term)}];
+    if (list.empty() || list.back() != document) {
+      list.push_back(document);
+    }
+  }
+
+  QVector<Source> m_Sources;
+  QVector<Document> m_Documents;
+  // Ordered as (kind, bytes), which is the on-disk term order.
+  std::map<std::pair<quint32, QByteArray>, std::vector<quint32>> m_Terms;
+};
+
+QStringList DaggerfallTextSearchIndex::sourceFiles(const QString& arena2Path)
+{
+  QStringList out;
+  const QDir arena2(arena2Path);
+  const QStringList filters = {"TEXT.RSC", "BOOK*.TXT", "*.QRC"};
+  for (const QString& folder : {QString("."), QString("BOOKS"), QString("QUESTS")}) {
+    const QDir dir(arena2.filePath(folder));
+    if (!dir.exists()) {
+      continue;
+    }
+    for (const QString& name : dir.entryList(filters, QDir::Files, QDir::Name)) {
+      out.push_back(QDir::cleanPath(dir.filePath(name)));
+    }
+  }
+  return out;
+}
+
+bool DaggerfallTextSearchIndex::buildSegment(const QString& filePath, const QString& fileHash,
+                                             QByteArray& outData, QString* errorMessage)
+{
+  outData.clear();
+  const QString fileName = QFileInfo(filePath).fileName();
+  SourceType type = SourceType::TextRsc;
+  if (!sourceTypeForFile(fileName, type)) {
+    return setError(errorMessage, QString("%1 is not a Daggerfall text resource").arg(fileName));
+  }
+
+  Builder builder;
+  const quint32 source = builder.addSource(type, fileName);
+  if (type == SourceType::Book) {
+    DaggerfallBookTxt::Book book;
+    if (!DaggerfallBookTxt::loadBook(filePath, book, errorMessage)) {
+      return false;
+    }
+    for (int page = 0; page < book.pages.size(); ++page) {
+      builder.addDocument(source, static_cast<quint32>(page), book.pages.at(page).text);
+    }
+  } else {
+    // QRC message files share the TEXT.RSC record database layout.
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+      return setError(errorMessage, QString("Unable to open %1").arg(filePath));
+    }
+    XngineRscFormat::TextRecordDatabase db;
+    if (!XngineRscFormat::parseTextRecordDatabase(file.readAll(), db, errorMessage)) {
+      return false;
+    }
+    for (const auto& record : db.records) {
+      QString text;
+      for (const auto& sub : record.subrecords) {
+        if (!text.isEmpty()) {
+          text.append('\n');
+        }
+        text.append(sub.text);
+      }
+      builder.addDocument(source, record.id, text);
+    }
+  }
+
+  outData = builder.serialize(fileHash);
+  return true;
+}
+
+std::shared_ptr<const DaggerfallTextSearchIndex>
+DaggerfallTextSearchIndex::forFiles(const QStringList& filePaths, QString* errorMessage)
+{
+  struct SourceFile
+  {
+    QString path;
+    QString name;
+    QString hash;
+    SourceType type = SourceType::TextRsc;
+  };
+
+  QVector<SourceFile> files;
+  files.reserve(filePaths.size());
+  for (const QString& filePath : filePaths) {
+    const QFileInfo info(filePath);
+    SourceFile file;
+    file.path = info.absoluteFilePath();
+    file.name = info.fileName();
+    if (!sourceTypeForFile(file.name, file.type)) {
+      qWarning().noquote() << "[DaggerfallTextSearchIndex] not a text resource, skipped:"
+                           << filePath;
+      continue;
+    }
+    file.hash = XngineDerivedCache::contentHash(file.path);
+    if (file.hash.isEmpty()) {
+      qWarning().noquote() << "[DaggerfallTextSearchIndex] cannot read, skipped:" << filePath;
+      continue;
+    }
+    files.push_back(file);
+  }
+  std::sort(files.begin(), files.end(), [](const SourceFile& a, const SourceFile& b) {
+    return a.name.compare(b.name, Qt::CaseInsensitive) < 0;
+  });
+
+  QCryptographicHash installHasher(QCryptographicHash::Sha1);
+  for (const auto& file : files) {
+    installHasher.addData(QString("%1|%2\n").arg(file.name.toUpper(), file.hash).toLatin1());
+  }
+  const QString installHash = QString::fromLatin1(installHasher.result().toHex());
+
+  static XngineDerivedCache::SharedMemo<DaggerfallTextSearchIndex> indexByInstall;
+  if (auto cached = indexByInstall.find(installHash)) {
+    return cached;
+  }
+
+  auto index = std::make_shared<DaggerfallTextSearchIndex>();
+  const QString cachePath = XngineDerivedCache::pathFor("dftext-index", installHash);
+  if (cachePath.isEmpty() || !index->open(cachePath, installHash)) {
+    Builder merged;
+    bool complete = true;
+    for (const auto& file : files) {
+      DaggerfallTextSearchIndex segment;
+      QString error;
+      const bool ok = segment.openOrBuild(
+          XngineDerivedCache::pathFor("dftext-segment", file.hash), file.hash,
+          [&](QByteArray& bytes, QString* buildError) {
+            return buildSegment(file.path, file.hash, bytes, buildError);
+          },
+          &error);
+      if (!ok) {
+        qWarning().noquote() << "[DaggerfallTextSearchIndex]" << file.name
+                             << "not indexed:" << error;
+        complete = false;
+        continue;
+      }
+      merged.addSegment(segment, merged.addSource(file.type, file.name));
+    }
+    if (merged.isEmpty()) {
+      setError(errorMessage, "No Daggerfall text resource could be indexed");
+      return nullptr;
+    }
+
+    // installHash still covers the files that failed, so their merge is not cached.
+    if (!index->store(complete ? cachePath : QString(), merged.serialize(installHash),
+                      installHash, errorMessage)) {
+      return nullptr;
+    }
+  }
+
+  return indexByInstall.publish(installHash, index);
+}
+
+DaggerfallTextSearchIndex::DaggerfallTextSearchIndex() : Table(kFormat) {}
+
+bool DaggerfallTextSearchIndex::attachLayout(const uchar* data, qsizetype size,
+                                             QString* errorMessage)
+{
+  m_SourceCount = 0;
+  m_DocumentCount = 0;
+  m_TermCount = 0;
+  m_PostingCount = 0;
+  m_PoolSize = 0;
+
+  if (size < kHeaderSize) {
+    return setError(errorMessage, "Text search index is truncated");
+  }
+
+  const uchar* counts = data + Cache::kHeaderSize;
+  const quint32 sourceCount = readU32(counts, 0);
+  const quint32 documentCount = readU32(counts, 1);
+  const quint32 termCount = readU32(counts, 2);
+  const quint32 postingCount = readU32(counts, 3);
+  const quint32 poolSize = readU32(counts, 4);
+  const qsizetype expected = kHeaderSize + qsizetype(sourceCount) * kSourceRecordSize +
+                             qsizetype(documentCount) * kDocumentRecordSize +
+                             qsizetype(termCount) * kTermRecordSize +
+                             qsizetype(postingCount) * 4 + qsizetype(poolSize);
+  if (size != expected) {
+    return setError(errorMessage, "Text search index is truncated");
+  }
+
+  const uchar* sources = data + kHeaderSize;
+  const uchar* documents = sources + qsizetype(sourceCount) * kSourceRecordSize;
+  const uchar* terms = documents + qsizetype(documentCount) * kDocumentRecordSize;
+  const uchar* postings = terms + qsizetype(termCount) * kTermRecordSize;
+  const uchar* pool = postings + qsizetype(postingCount) * 4;
+  auto inPool = [poolSize](quint32 offset, quint32 length) {
+    return quint64(offset) + length <= poolSize;
+  };
+
+  for (quint32 i = 0; i < sourceCount; ++i) {
+    const uchar* record = sources + i * kSourceRecordSize;
+    if (!inPool(readU32(record, 1), readU32(record, 2))) {
+      return setError(errorMessage, "Text search index has an out-of-range source name");
+    }
+  }
+  for (quint32 i = 0; i < documentCount; ++i) {
+    const uchar* record = documents + i * kDocumentRecordSize;
+    if (readU32(record) >= sourceCount || !inPool(readU32(record, 2), readU32(record, 3))) {
+      return setError(errorMessage, "Text search index has an out-of-range document");
+    }
+  }
+  for (quint32 i = 0; i < termCount; ++i) {
+    const uchar* record = terms + i * kTermRecordSize;
+    if (!inPool(readU32(record, 1), readU32(record, 2)) ||
+        quint64(readU32(record, 3)) + readU32(record, 4) > postingCount) {
+      return setError(errorMessage, "Text search index has an out-of-range term");
+    }
+  }
+  for (quint32 i = 0; i < postingCount; ++i) {
+    if (readU32(postings, i) >= documentCount) {
+      return setError(errorMessage, "Text search index has an out-of-range posting");
+    }
+  }
+
+  m_Sources = sources;
+  m_Documents = documents;
+  m_Terms = terms;
+  m_Postings = postings;
+  m_Pool = pool;
+  m_SourceCount = sourceCount;
+  m_DocumentCount = documentCount;
+  m_TermCount = termCount;
+  m_PostingCount = postingCount;
+  m_PoolSize = poolSize;
+  return true;
+}
+
+QByteArrayView DaggerfallTextSearchIndex::poolView(quint32 offset, quint32 length) const
+{
+  return QByteArrayView(reinterpret_cast<const char*>(m_Pool + offset), length);
+}
+
+qsizetype DaggerfallTextSearchIndex::findTerm(TermKind kind, QByteArrayView text) const
+{
+  const auto wanted = static_cast<quint32>(kind);
+  qsizetype low = 0;
+  qsizetype high = m_TermCount;
+  while (low < high) {
+    const qsizetype mid = low + (high - low) / 2;
+    const uchar* record = m_Terms + mid * kTermRecordSize;
+    const quint32 midKind = readU32(record);
+    int c = midKind < wanted ? -1 : (midKind > wanted ? 1 : 0);
+    if (c == 0) {
+      c = compareBytes(poolView(readU32(record, 1), readU32(record, 2)), text);
+    }
+    if (c == 0) {
+      return mid;
+    }
+    if (c < 0) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return -1;
+}
+
+QVector<quint32> DaggerfallTextSearchIndex::postings(qsizetype term) const
+{
+  QVector<quint32> out;
+  if (term < 0) {
+    return out;
+  }
+  const uchar* record = m_Terms + term * kTermRecordSize;
+  const quint32 first = readU32(record, 3);
+  const quint32 count = readU32(record, 4);
+  out.resize(count);
+  qFromLittleEndian<quint32>(m_Postings + qsizetype(first) * 4, count, out.data());
+  return out;
+}
+
+QVector<DaggerfallTextSearchIndex::Hit>
+DaggerfallTextSearchIndex::hits(const QVector<quint32>& documents) const
+{
+  QVector<Hit> out;
+  out.reserve(documents.size());
+  for (const quint32 document : documents) {
+    const uchar* record = m_Documents + qsizetype(document) * kDocumentRecordSize;
+    const uchar* source = m_Sources + qsizetype(readU32(record)) * kSourceRecordSize;
+    Hit hit;
+    hit.document = static_cast<int>(document);
+    hit.type = static_cast<SourceType>(readU32(source));
+    const QByteArrayView name = poolView(readU32(source, 1), readU32(source, 2));
+    hit.source = QString::fromLatin1(name.data(), name.size());
+    hit.recordId = readU32(record, 1);
+    out.push_back(hit);
+  }
+  return out;
+}
+
+QString DaggerfallTextSearchIndex::documentText(int document) const
+{
+  if (!isValid() || document < 0 || quint32(document) >= m_DocumentCount) {
+    return {};
+  }
+  const uchar* record = m_Documents + qsizetype(document) * kDocumentRecordSize;
+  const QByteArrayView text = poolView(readU32(record, 2), readU32(record, 3));
+  return QString::fromLatin1(text.data(), text.size());
+}
+
+QVector<DaggerfallTextSearchIndex::Hit>
+DaggerfallTextSearchIndex::findVariable(const QString& name) const
+{
+  if (!isValid()) {
+    return {};
+  }
+  QString trimmed = name.trimmed();
+  if (trimmed.startsWith('%')) {
+    trimmed.remove(0, 1);
+  }
+  return hits(postings(findTerm(TermKind::Variable, trimmed.toLatin1())));
+}
+
+QVector<DaggerfallTextSearchIndex::Hit>
+DaggerfallTextSearchIndex::findWord(const QString& word) const
+{
+  if (!isValid()) {
+    return {};
+  }
+  return hits(postings(findTerm(TermKind::Word, word.trimmed().toLatin1().toLower())));
+}
+
+QVector<DaggerfallTextSearchIndex::Hit>
+DaggerfallTextSearchIndex::findText(const QString& phrase) const
+{
+  if (!isValid() || phrase.isEmpty()) {
+    return {};
+  }
+  const QByteArray needle = phrase.toLatin1();
+
+  // Only words with a separator on both sides inside the phrase are whole words in
+  // every match; the outer ones may be parts of longer words.
+  bool narrowed = false;
+  QVector<quint32> candidates;
+  const char* data = needle.constData();
+  const qsizetype size = needle.size();
+  for (qsizetype i = 0; i < size;) {
+    if (!isWordByte(data[i])) {
+      ++i;
+      continue;
+    }
+    qsizetype end = i + 1;
+    while (end < size && isWordByte(data[end])) {
+      ++end;
+    }
+    const bool whole = i > 0 && end < size && data[i - 1] != '%' && data[i - 1] != '_' &&
+                       data[end] != '_';
+    if (whole) {
+      const QVector<quint32> list =
+          postings(findTerm(TermKind::Word, QByteArray(data + i, end - i).toLower()));
+      if (!narrowed) {
+        candidates = list;
+        narrowed = true;
+      } else {
+        QVector<quint32> both;
+        std::set_intersection(candidates.cbegin(), candidates.cend(), list.cbegin(),
+                              list.cend(), std::back_inserter(both));
+        candidates = std::move(both);
+      }
+      if (candidates.isEmpty()) {
+        return {};
+      }
+    }
+    i = end;
+  }
+  if (!narrowed) {
+    candidates.resize(m_DocumentCount);
+    std::iota(candidates.begin(), candidates.end(), 0u);
+  }
+
+  const QLatin1String needleView(needle.constData(), needle.size());
+  QVector<quint32> matches;
+  for (const quint32 document : candidates) {
+    const uchar* record = m_Documents + qsizetype(document) * kDocumentRecordSize;
+    const QByteArrayView text = poolView(readU32(record, 2), readU32(record, 3));
+    if (QLatin1String(text.data(), text.size()).contains(needleView, Qt::CaseInsensitive)) {
+      matches.push_back(document);
+    }
+  }
+  return hits(matches);
+}
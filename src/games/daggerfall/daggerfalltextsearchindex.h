@@ -0,0 +1,115 @@
+#ifndef DAGGERFALL_TEXTSEARCHINDEX_H
+#define DAGGERFALL_TEXTSEARCHINDEX_H
+
+#include "xnginederivedcache.h"
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QtGlobal>
+
+#include <memory>
+
+/**
+ * Inverted word and text-variable index over the Daggerfall text resources:
+ * TEXT.RSC records, BOOK*.TXT pages and QRC quest messages. Answers "which records
+ * use %fn" or "which records mention a phrase" without decoding any source.
+ *
+ * Every source file is indexed on its own into a segment cached per file content
+ * hash, and the segments of one set of files are merged into an index cached per
+ * install hash (SHA-1 over the file names and their content hashes). A mod that
+ * overrides a file therefore only re-indexes that file before the merge. A merge
+ * missing a file that failed to index is kept in memory only, so the file is
+ * retried by the next session.
+ *
+ * Segments and merged indices share one layout (little-endian):
+ *   header    "DFTX", u32 version, char[40] install or file SHA-1 (hex),
+ *             u32 sourceCount, u32 documentCount, u32 termCount, u32 postingCount,
+ *             u32 poolSize
+ *   sources   sourceCount x (u32 type, u32 nameOffset, u32 nameLength)
+ *   documents documentCount x (u32 source, u32 recordId, u32 textOffset, u32 textLength)
+ *   terms     termCount x (u32 kind, u32 textOffset, u32 textLength, u32 firstPosting,
+ *             u32 postingCount), sorted by (kind, text)
+ *   postings  postingCount x u32 document index, ascending per term
+ *   pool      Latin-1 source names, terms and document text
+ * Words are lowercased runs of ASCII letters and digits; variables are the names of
+ * %name tokens (same rules as DaggerfallTextVariables::extractVariables).
+ */
+class DaggerfallTextSearchIndex : public XngineDerivedCache::Table
+{
+public:
+  enum class SourceType : quint32
+  {
+    TextRsc = 1,  // document per record, recordId = TEXT.RSC record id
+    Book = 2,     // document per page, recordId = page index
+    Qrc = 3,      // document per message, recordId = QRC message id
+  };
+
+  struct Hit
+  {
+    int document = -1;
+    SourceType type = SourceType::TextRsc;
+    QString source;  // file name, e.g. BOOK0001.TXT
+    quint32 recordId = 0;
+  };
+
+  // TEXT.RSC, BOOK*.TXT and *.QRC under arena2Path (and its BOOKS/QUESTS folders).
+  static QStringList sourceFiles(const QString& arena2Path);
+
+  // Shared index for exactly these files: mapped from the cache when the set is
+  // unchanged, otherwise merged from per-file segments, building only the segments
+  // whose file contents are new. Files that cannot be indexed are skipped with a
+  // warning. Null when nothing could be indexed.
+  static std::shared_ptr<const DaggerfallTextSearchIndex>
+  forFiles(const QStringList& filePaths, QString* errorMessage = nullptr);
+
+  static bool buildSegment(const QString& filePath, const QString& fileHash,
+                           QByteArray& outData, QString* errorMessage = nullptr);
+
+  DaggerfallTextSearchIndex();
+
+  int sourceCount() const { return static_cast<int>(m_SourceCount); }
+  int documentCount() const { return static_cast<int>(m_DocumentCount); }
+  QString documentText(int document) const;
+
+  // Documents using %name; the leading '%' is optional.
+  QVector<Hit> findVariable(const QString& name) const;
+  // Documents containing word as a whole word, case-insensitively.
+  QVector<Hit> findWord(const QString& word) const;
+  // Documents containing phrase, case-insensitively. Whole words inside the phrase
+  // narrow the candidates through the index before the text is compared.
+  QVector<Hit> findText(const QString& phrase) const;
+
+protected:
+  bool attachLayout(const uchar* data, qsizetype size, QString* errorMessage) override;
+
+private:
+  enum class TermKind : quint32
+  {
+    Word = 1,
+    Variable = 2,
+  };
+
+  class Builder;
+
+  // Index into the term table, or -1.
+  qsizetype findTerm(TermKind kind, QByteArrayView text) const;
+  QVector<quint32> postings(qsizetype term) const;
+  QVector<Hit> hits(const QVector<quint32>& documents) const;
+  QByteArrayView poolView(quint32 offset, quint32 length) const;
+
+  const uchar* m_Sources = nullptr;
+  const uchar* m_Documents = nullptr;
+  const uchar* m_Terms = nullptr;
+  const uchar* m_Postings = nullptr;
+  const uchar* m_Pool = nullptr;
+  quint32 m_SourceCount = 0;
+  quint32 m_DocumentCount = 0;
+  quint32 m_TermCount = 0;
+  quint32 m_PostingCount = 0;
+  quint32 m_PoolSize = 0;
+};
+
+#endif  // DAGGERFALL_TEXTSEARCHINDEX_H
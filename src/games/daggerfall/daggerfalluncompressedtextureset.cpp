@@ -0,0 +1,370 @@
+#include "daggerfalluncompressedtextureset.h"
+#include "daggerfallformatutils.h"
+#include "xngineparallel.h"
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+
+using Daggerfall::FormatUtil::appendWarning;
+using Daggerfall::FormatUtil::setError;
+
+constexpr char kManifestMagic[4] = {'D', 'F', 'T', 'A'};
+constexpr quint32 kManifestVersion = 1;
+
+template <typename T>
+void appendLE(QByteArray& out, T value)
+{
+  uchar bytes[sizeof(T)];
+  qToLittleEndian(value, bytes);
+  out.append(reinterpret_cast<const char*>(bytes), sizeof(T));
+}
+
+void appendFloat(QByteArray& out, float value)
+{
+  quint32 bits = 0;
+  std::memcpy(&bits, &value, sizeof(bits));
+  appendLE<quint32>(out, bits);
+}
+
+struct PackItem
+{
+  int record = 0;
+  int frame = 0;
+  int width = 0;
+  int height = 0;
+  const QByteArray* pixels = nullptr;
+};
+
+DaggerfallUncompressedTextureSet::Archive
+decodeArchive(const QString& path, const DaggerfallUncompressedTextureSet::Options& options)
+{
+  DaggerfallUncompressedTextureSet::Archive archive;
+  archive.path = path;
+
+  QElapsedTimer timer;
+  timer.start();
+  archive.loaded = Daggerfall::Image::loadTextureFile(path, archive.texture, &archive.error);
+  archive.decodeNs = timer.nsecsElapsed();
+  if (!archive.loaded) {
+    if (archive.error.isEmpty()) {
+      archive.error = "Failed loading texture archive";
+    }
+    return archive;
+  }
+
+  // loadTextureFile leaves RLE-compressed and animated records header-only.
+  for (const auto& record : archive.texture.records) {
+    const bool sized = record.width > 0 && record.height > 0;
+    if (sized && std::all_of(record.frames.cbegin(), record.frames.cend(),
+                             [](const QByteArray& frame) { return frame.isEmpty(); })) {
+      ++archive.skippedRecords;
+    }
+  }
+  if (archive.skippedRecords > 0) {
+    appendWarning(archive.warning,
+                  QString("%1 of %2 record(s) not decoded (RLE-compressed or animated)")
+                      .arg(archive.skippedRecords)
+                      .arg(archive.texture.records.size()));
+  }
+
+  if (options.buildAtlas) {
+    timer.restart();
+    archive.atlas = DaggerfallUncompressedTextureSet::packAtlas(
+        archive.texture, options.maxAtlasWidth, options.padding);
+    archive.packNs = timer.nsecsElapsed();
+  }
+  if (!options.keepFrames) {
+    for (auto& record : archive.texture.records) {
+      record.frames.clear();
+    }
+  }
+  return archive;
+}
+
+}  // namespace
+
+int DaggerfallUncompressedTextureSet::Result::frameCount() const
+{
+  int count = 0;
+  for (const auto& archive : archives) {
+    if (!archive.atlas.frames.isEmpty()) {
+      count += static_cast<int>(archive.atlas.frames.size());
+      continue;
+    }
+    for (const auto& record : archive.texture.records) {
+      count += static_cast<int>(record.frames.size());
+    }
+  }
+  return count;
+}
+
+int DaggerfallUncompressedTextureSet::Result::failedCount() const
+{
+  return static_cast<int>(std::count_if(archives.cbegin(), archives.cend(),
+                                        [](const Archive& a) { return !a.loaded; }));
+}
+
+int DaggerfallUncompressedTextureSet::Result::skippedRecordCount() const
+{
+  int count = 0;
+  for (const auto& archive : archives) {
+    count += archive.skippedRecords;
+  }
+  return count;
+}
+
+QStringList DaggerfallUncompressedTextureSet::textureFiles(const QString& arena2Path)
+{
+  QStringList out;
+  const QDir dir(arena2Path);
+  for (const QFileInfo& info : dir.entryInfoList({"TEXTURE.*"}, QDir::Files, QDir::Name)) {
+    const QString suffix = info.suffix();
+    const bool numbered = suffix.size() == 3 &&
+                          std::all_of(suffix.cbegin(), suffix.cend(),
+                                      [](QChar c) { return c.isDigit(); });
+    if (numbered) {
+      out.push_back(info.filePath());
+    }
+  }
+  return out;
+}
+
+DaggerfallUncompressedTextureSet::Result
+DaggerfallUncompressedTextureSet::decodeDirectory(const QString& arena2Path,
+                                                  const Options& options)
+{
+  return decodeFiles(textureFiles(arena2Path), options);
+}
+
+DaggerfallUncompressedTextureSet::Result
+DaggerfallUncompressedTextureSet::decodeFiles(const QStringList& texturePaths,
+                                              const Options& options)
+{
+  Result result;
+  QElapsedTimer total;
+  total.start();
+
+  const int count = static_cast<int>(texturePaths.size());
+  result.archives.resize(count);
+  // Each job owns its slot; see DaggerfallArch3dBsa::Reader::loadMeshRecords.
+  Archive* archiveSlots = result.archives.data();
+  XngineParallel::parallelFor(
+      count,
+      [&](int index) { archiveSlots[index] = decodeArchive(texturePaths.at(index), options); },
+      options.maxThreads);
+
+  result.elapsedNs = total.nsecsElapsed();
+  return result;
+}
+
+DaggerfallUncompressedTextureSet::Atlas
+DaggerfallUncompressedTextureSet::packAtlas(const Daggerfall::Image::TextureFile& texture,
+                                            int maxAtlasWidth, int padding)
+{
+  padding = std::max(0, padding);
+
+  QVector<PackItem> items;
+  qint64 area = 0;
+  int widest = 0;
+  for (int r = 0; r < texture.records.size(); ++r) {
+    const auto& record = texture.records.at(r);
+    const int w = std::max(0, static_cast<int>(record.width));
+    const int h = std::max(0, static_cast<int>(record.height));
+    if (w == 0 || h == 0) {
+      continue;
+    }
+    for (int f = 0; f < record.frames.size(); ++f) {
+      if (record.frames.at(f).isEmpty()) {
+        continue;
+      }
+      items.push_back({r, f, w, h, &record.frames.at(f)});
+      area += static_cast<qint64>(w + padding) * (h + padding);
+      widest = std::max(widest, w);
+    }
+  }
+
+  Atlas atlas;
+  if (items.isEmpty()) {
+    return atlas;
+  }
+
+  // Roughly square, power-of-two wide, never narrower than the widest frame.
+  const int target = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(area))));
+  int width = 1;
+  while (width < target) {
+    width <<= 1;
+  }
+  if (maxAtlasWidth > 0) {
+    width = std::min(width, maxAtlasWidth);
+  }
+  width = std::max(width, widest);
+
+  QVector<int> order(items.size());
+  for (int i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
+  std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+    const PackItem& lhs = items.at(a);
+    const PackItem& rhs = items.at(b);
+    return lhs.height != rhs.height ? lhs.height > rhs.height : lhs.width > rhs.width;
+  });
+
+  atlas.frames.resize(items.size());
+  int x = 0;
+  int y = 0;
+  int shelfHeight = 0;
+  for (const int index : order) {
+    const PackItem& item = items.at(index);
+    if (x > 0 && x + item.width > width) {
+      y += shelfHeight + padding;
+      x = 0;
+      shelfHeight = 0;
+    }
+    const auto& record = texture.records.at(item.record);
+    FrameRect& rect = atlas.frames[index];
+    rect.record = item.record;
+    rect.frame = item.frame;
+    rect.x = x;
+    rect.y = y;
+    rect.width = item.width;
+    rect.height = item.height;
+    rect.offsetX = record.offsetX;
+    rect.offsetY = record.offsetY;
+    x += item.width + padding;
+    shelfHeight = std::max(shelfHeight, item.height);
+  }
+
+  atlas.width = width;
+  atlas.height = y + shelfHeight;
+  atlas.pixels = QByteArray(static_cast<qsizetype>(atlas.width) * atlas.height, '\0');
+  char* dst = atlas.pixels.data();
+  for (int i = 0; i < items.size(); ++i) {
+    const PackItem& item = items.at(i);
+    const FrameRect& rect = atlas.frames.at(i);
+    // Frames cut short by the file end keep only their complete rows.
+    const int rows = static_cast<int>(
+        std::min<qsizetype>(item.height, item.pixels->size() / item.width));
+    const char* src = item.pixels->constData();
+    for (int row = 0; row < rows; ++row) {
+      std::memcpy(dst + static_cast<qsizetype>(rect.y + row) * atlas.width + rect.x,
+                  src + static_cast<qsizetype>(row) * item.width,
+                  static_cast<size_t>(item.width));
+    }
+  }
+  return atlas;
+}
+
+QByteArray DaggerfallUncompressedTextureSet::manifestJson(const Archive& archive,
+                                                          const QString& atlasFileName)
+{
+  const Atlas& atlas = archive.atlas;
+  const double w = std::max(1, atlas.width);
+  const double h = std::max(1, atlas.height);
+
+  QJsonArray frames;
+  for (const auto& rect : atlas.frames) {
+    QJsonObject frame;
+    frame["record"] = rect.record;
+    frame["frame"] = rect.frame;
+    frame["x"] = rect.x;
+    frame["y"] = rect.y;
+    frame["width"] = rect.width;
+    frame["height"] = rect.height;
+    frame["offsetX"] = rect.offsetX;
+    frame["offsetY"] = rect.offsetY;
+    frame["uv"] = QJsonArray{rect.x / w, rect.y / h, (rect.x + rect.width) / w,
+                             (rect.y + rect.height) / h};
+    frames.append(frame);
+  }
+
+  QJsonObject root;
+  root["archive"] = QFileInfo(archive.path).fileName();
+  root["name"] = archive.texture.header.name;
+  root["atlas"] = atlasFileName;
+  root["width"] = atlas.width;
+  root["height"] = atlas.height;
+  root["frames"] = frames;
+  return QJsonDocument(root).toJson(QJsonDocument::Indented);
+}
+
+QByteArray DaggerfallUncompressedTextureSet::manifestBinary(const Atlas& atlas)
+{
+  const float w = static_cast<float>(std::max(1, atlas.width));
+  const float h = static_cast<float>(std::max(1, atlas.height));
+
+  QByteArray out;
+  out.reserve(20 + atlas.frames.size() * 32);
+  out.append(kManifestMagic, sizeof(kManifestMagic));
+  appendLE<quint32>(out, kManifestVersion);
+  appendLE<quint32>(out, static_cast<quint32>(atlas.width));
+  appendLE<quint32>(out, static_cast<quint32>(atlas.height));
+  appendLE<quint32>(out, static_cast<quint32>(atlas.frames.size()));
+  for (const auto& rect : atlas.frames) {
+    appendLE<quint16>(out, static_cast<quint16>(rect.record));
+    appendLE<quint16>(out, static_cast<quint16>(rect.frame));
+    appendLE<quint16>(out, static_cast<quint16>(rect.x));
+    appendLE<quint16>(out, static_cast<quint16>(rect.y));
+    appendLE<quint16>(out, static_cast<quint16>(rect.width));
+    appendLE<quint16>(out, static_cast<quint16>(rect.height));
+    appendLE<qint16>(out, rect.offsetX);
+    appendLE<qint16>(out, rect.offsetY);
+    appendFloat(out, rect.x / w);
+    appendFloat(out, rect.y / h);
+    appendFloat(out, (rect.x + rect.width) / w);
+    appendFloat(out, (rect.y + rect.height) / h);
+  }
+  return out;
+}
+
+bool DaggerfallUncompressedTextureSet::writeAtlas(const Archive& archive,
+                                                  const QString& outputDir,
+                                                  const QVector<QRgb>& colorTable,
+                                                  QString* errorMessage)
+{
+  const Atlas& atlas = archive.atlas;
+  if (atlas.frames.isEmpty()) {
+    return setError(errorMessage, QString("No decoded frames to pack in %1").arg(archive.path));
+  }
+
+  const QDir dir(outputDir);
+  if (!dir.exists() && !QDir().mkpath(outputDir)) {
+    return setError(errorMessage,
+                    QString("Could not create output directory: %1").arg(outputDir));
+  }
+
+  const QString baseName = QFileInfo(archive.path).fileName();
+  const QString imageName = baseName + ".png";
+  const QImage image =
+      Daggerfall::Image::toIndexedImage(atlas.pixels, atlas.width, atlas.height, colorTable);
+  if (!image.save(dir.filePath(imageName), "PNG")) {
+    return setError(errorMessage,
+                    QString("Failed writing atlas image: %1").arg(dir.filePath(imageName)));
+  }
+
+  const QVector<QPair<QString, QByteArray>> manifests = {
+      {baseName + ".json", manifestJson(archive, imageName)},
+      {baseName + ".bin", manifestBinary(atlas)},
+  };
+  for (const auto& [name, data] : manifests) {
+    QFile file(dir.filePath(name));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(data) != data.size()) {
+      return setError(errorMessage,
+                      QString("Failed writing atlas manifest: %1").arg(file.fileName()));
+    }
+  }
+  return true;
+}
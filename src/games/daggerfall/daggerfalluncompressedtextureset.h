@@ -0,0 +1,108 @@
+#ifndef DAGGERFALL_UNCOMPRESSEDTEXTURESET_H
+#define DAGGERFALL_UNCOMPRESSEDTEXTURESET_H
+
+#include "daggerfallimageformats.h"
+
+#include <QByteArray>
+#include <QRgb>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QtGlobal>
+
+/**
+ * Batch decoder for the uncompressed single-frame records of a whole set of
+ * TEXTURE.xxx archives (ARENA2 ships about 500), for texture-pack tooling and
+ * previews. Archives are decoded in parallel, one archive per job, and each can be
+ * packed into a single indexed atlas with a UV manifest so consumers load one image
+ * per archive instead of one per frame.
+ *
+ * Atlases are shelf-packed: frames sorted by height, placed left to right, with
+ * padding pixels of index 0 (transparent) between them. UVs are normalized with
+ * the origin at the top-left of the atlas.
+ *
+ * Records are decoded by Daggerfall::Image::loadTextureFile, which only handles the
+ * uncompressed single-frame layout. RLE-compressed (RecordRle/ImageRle) and animated
+ * records are not supported: they are counted in Archive::skippedRecords and left
+ * out of the atlas.
+ *
+ * The binary manifest (little-endian):
+ *   header  "DFTA", u32 version, u32 atlasWidth, u32 atlasHeight, u32 frameCount
+ *   frames  frameCount x (u16 record, u16 frame, u16 x, u16 y, u16 width, u16 height,
+ *           i16 offsetX, i16 offsetY, f32 u0, f32 v0, f32 u1, f32 v1)
+ * The JSON manifest carries the same fields plus the archive and atlas file names.
+ */
+class DaggerfallUncompressedTextureSet
+{
+public:
+  struct FrameRect
+  {
+    int record = 0;
+    int frame = 0;
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+    qint16 offsetX = 0;  // TextureRecord::offsetX/offsetY
+    qint16 offsetY = 0;
+  };
+
+  struct Atlas
+  {
+    int width = 0;
+    int height = 0;
+    QByteArray pixels;          // width*height indexed
+    QVector<FrameRect> frames;  // in record/frame order
+  };
+
+  struct Archive
+  {
+    QString path;
+    bool loaded = false;
+    QString error;                           // set when the archive failed to load
+    QString warning;                         // records left out of the atlas
+    int skippedRecords = 0;                  // sized records without any decoded frame
+    Daggerfall::Image::TextureFile texture;  // frames dropped unless Options::keepFrames
+    Atlas atlas;                             // empty unless Options::buildAtlas
+    qint64 decodeNs = 0;
+    qint64 packNs = 0;
+  };
+
+  struct Options
+  {
+    int maxThreads = 0;  // 0 = QThread::idealThreadCount()
+    bool buildAtlas = true;
+    bool keepFrames = true;
+    int maxAtlasWidth = 2048;  // widened to the widest frame when that is larger
+    int padding = 1;
+  };
+
+  struct Result
+  {
+    QVector<Archive> archives;  // in input order
+    qint64 elapsedNs = 0;       // whole batch, wall clock
+
+    int frameCount() const;
+    int failedCount() const;
+    int skippedRecordCount() const;
+  };
+
+  // TEXTURE.000 .. TEXTURE.999 in arena2Path, sorted by name.
+  static QStringList textureFiles(const QString& arena2Path);
+
+  static Result decodeDirectory(const QString& arena2Path, const Options& options = Options{});
+  static Result decodeFiles(const QStringList& texturePaths, const Options& options = Options{});
+
+  static Atlas packAtlas(const Daggerfall::Image::TextureFile& texture, int maxAtlasWidth,
+                         int padding);
+
+  static QByteArray manifestJson(const Archive& archive, const QString& atlasFileName);
+  static QByteArray manifestBinary(const Atlas& atlas);
+
+  // Writes <archive file name>.png (Format_Indexed8 with colorTable), .json and .bin
+  // into outputDir.
+  static bool writeAtlas(const Archive& archive, const QString& outputDir,
+                         const QVector<QRgb>& colorTable, QString* errorMessage = nullptr);
+};
+
+#endif  // DAGGERFALL_UNCOMPRESSEDTEXTURESET_H
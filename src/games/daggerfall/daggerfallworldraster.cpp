@@ -0,0 +1,376 @@
+#include "daggerfallworldraster.h"
+#include "daggerfallformatutils.h"
+
+#include <QDir>
+#include <QMutexLocker>
+#include <QtEndian>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace {
+
+using Daggerfall::FormatUtil::appendWarning;
+using Daggerfall::FormatUtil::setError;
+
+constexpr qsizetype kWldHeaderSize = 0x90;
+constexpr qsizetype kWldPixelDataSize = 47;
+constexpr quint8 kClimatePad = 223;
+constexpr quint8 kPoliticPad = 64;
+
+using Pixel = DaggerfallWorldRaster::Pixel;
+
+int tileKey(int tileX, int tileY)
+{
+  return (tileY << 16) | tileX;
+}
+
+// One PAK row of a raster line; row is nullptr past the PAK's last row.
+struct PakLayer
+{
+  const DaggerfallPak::RunIndex* row = nullptr;
+  int width = 0;
+  quint8 padValue = 0;  // where a row decodes short, as DaggerfallClimatePak::valueAt does
+  quint8 flag = 0;
+  quint8 Pixel::*value = nullptr;
+};
+
+template <typename Data>
+PakLayer pakLayer(const Data& data, int y, quint8 padValue, quint8 flag, quint8 Pixel::*value)
+{
+  const bool inside = y >= 0 && y < data.rowRuns.size();
+  return {inside ? &data.rowRuns.at(y) : nullptr, data.width, padValue, flag, value};
+}
+
+std::array<PakLayer, 2> pakLayers(const DaggerfallClimatePak::Data& climate,
+                                  const DaggerfallPoliticPak::Data& politic, int y)
+{
+  return {pakLayer(climate, y, kClimatePad, Pixel::kHasClimate, &Pixel::climate),
+          pakLayer(politic, y, kPoliticPad, Pixel::kHasPolitic, &Pixel::politic)};
+}
+
+}  // namespace
+
+int DaggerfallWorldRaster::Pixel::regionIndex() const
+{
+  return (flags & kHasPolitic) != 0 ? DaggerfallPoliticPak::regionFromValue(politic) : -2;
+}
+
+bool DaggerfallWorldRaster::open(const QString& arena2Path, QString* errorMessage)
+{
+  close();
+
+  const QDir arena2(arena2Path);
+  const QString woodsPath = arena2.filePath("WOODS.WLD");
+  if (!m_Woods.open(woodsPath)) {
+    return setError(errorMessage, QString("WOODS.WLD: Unable to open %1").arg(woodsPath));
+  }
+
+  const uchar* wld = m_Woods.data();
+  const qsizetype wldSize = m_Woods.size();
+  if (wldSize < kWldHeaderSize) {
+    close();
+    return setError(errorMessage, "WOODS.WLD: WOODS.WLD is too small");
+  }
+  const qint32 offsetSize = qFromLittleEndian<qint32>(wld + 0x00);
+  const qint32 width = qFromLittleEndian<qint32>(wld + 0x04);
+  const qint32 height = qFromLittleEndian<qint32>(wld + 0x08);
+  const qint32 elevationOffset = qFromLittleEndian<qint32>(wld + 0x1C);
+  const qsizetype pixelCount = static_cast<qsizetype>(width) * static_cast<qsizetype>(height);
+  if (width <= 0 || height <= 0 || width > 0xffff || height > 0x7fff) {
+    close();
+    return setError(errorMessage, "WOODS.WLD: Daggerfall WLD header width/height invalid");
+  }
+  if (offsetSize <= 0 || (offsetSize % 4) != 0 || kWldHeaderSize + offsetSize > wldSize) {
+    close();
+    return setError(errorMessage, "WOODS.WLD: Daggerfall WLD offset list is invalid");
+  }
+  if (elevationOffset < 0 || static_cast<qsizetype>(elevationOffset) + pixelCount > wldSize) {
+    close();
+    return setError(errorMessage, "WOODS.WLD: Daggerfall WLD elevation map is out of range");
+  }
+
+  QString err;
+  if (!DaggerfallClimatePak::loadRunIndex(arena2.filePath("CLIMATE.PAK"), m_Climate, &err) ||
+      !DaggerfallPoliticPak::loadRunIndex(arena2.filePath("POLITIC.PAK"), m_Politic, &err)) {
+    close();
+    return setError(errorMessage, err);
+  }
+
+  m_PixelOffsetCount = offsetSize / 4;
+  m_ElevationOffset = elevationOffset;
+  if (m_PixelOffsetCount != pixelCount) {
+    appendWarning(m_Warning, QString("Header offset-size implies %1 pixels, but width*height is %2")
+                                 .arg(m_PixelOffsetCount)
+                                 .arg(pixelCount));
+  }
+  const struct
+  {
+    const char* label;
+    int width;
+    qsizetype height;
+    QString warning;
+  } paks[] = {{"CLIMATE", m_Climate.width, m_Climate.rowRuns.size(), m_Climate.warning},
+              {"POLITIC", m_Politic.width, m_Politic.rowRuns.size(), m_Politic.warning}};
+  for (const auto& pak : paks) {
+    if (!pak.warning.isEmpty()) {
+      appendWarning(m_Warning, QString("%1.PAK: %2").arg(pak.label, pak.warning));
+    }
+    if (width != pak.width || height != pak.height) {
+      appendWarning(m_Warning, QString("WOODS (%1x%2) vs %3 (%4x%5) size mismatch")
+                                   .arg(width)
+                                   .arg(height)
+                                   .arg(pak.label)
+                                   .arg(pak.width)
+                                   .arg(pak.height));
+    }
+  }
+
+  m_Width = width;
+  m_Height = height;
+  return true;
+}
+
+void DaggerfallWorldRaster::close()
+{
+  QMutexLocker lock(&m_TileMutex);
+  m_Tiles.clear();
+  m_UseCounter = 0;
+  m_Woods.close();
+  m_Climate = {};
+  m_Politic = {};
+  m_Width = 0;
+  m_Height = 0;
+  m_PixelOffsetCount = 0;
+  m_ElevationOffset = 0;
+  m_Warning.clear();
+}
+
+void DaggerfallWorldRaster::setTileCacheLimit(int tiles)
+{
+  QMutexLocker lock(&m_TileMutex);
+  m_TileCacheLimit = std::max(tiles, 1);
+}
+
+int DaggerfallWorldRaster::cachedTileCount() const
+{
+  QMutexLocker lock(&m_TileMutex);
+  return static_cast<int>(m_Tiles.size());
+}
+
+void DaggerfallWorldRaster::decodeWoods(int x0, int y, int count, Pixel* dest,
+                                        qsizetype stride) const
+{
+  const uchar* wld = m_Woods.data();
+  const qsizetype wldSize = m_Woods.size();
+  for (int i = 0; i < count; ++i) {
+    Pixel& pixel = dest[i * stride];
+    const qsizetype idx = static_cast<qsizetype>(y) * m_Width + x0 + i;
+    pixel.elevation = static_cast<qint8>(wld[m_ElevationOffset + idx]);
+    if (idx >= m_PixelOffsetCount) {
+      continue;
+    }
+    const quint32 record = qFromLittleEndian<quint32>(wld + kWldHeaderSize + idx * 4);
+    if (record == 0 || static_cast<qsizetype>(record) + kWldPixelDataSize > wldSize) {
+      continue;
+    }
+    pixel.fileIndex = qFromLittleEndian<quint16>(wld + record + 6);
+    pixel.terrainType = wld[record + 8];
+    pixel.terrainNoise = wld[record + 9];
+    pixel.flags |= Pixel::kHasPixelData;
+  }
+}
+
+std::shared_ptr<DaggerfallWorldRaster::Tile> DaggerfallWorldRaster::decodeTile(int tileX,
+                                                                               int tileY) const
+{
+  auto decoded = std::make_shared<Tile>();
+  decoded->pixels.resize(kTileSize * kTileSize);
+  Pixel* pixels = decoded->pixels.data();
+
+  const int x0 = tileX * kTileSize;
+  const int y0 = tileY * kTileSize;
+  const int columns = std::min(kTileSize, m_Width - x0);
+  const int rows = std::min(kTileSize, m_Height - y0);
+  quint8 span[kTileSize];
+  for (int row = 0; row < rows; ++row) {
+    Pixel* line = pixels + row * kTileSize;
+    decodeWoods(x0, y0 + row, columns, line, 1);
+
+    for (const PakLayer& pak : pakLayers(m_Climate, m_Politic, y0 + row)) {
+      const int pakColumns = std::min(columns, pak.width - x0);
+      if (pak.row == nullptr || pakColumns <= 0) {
+        continue;
+      }
+      pak.row->copySpan(x0, pakColumns, span, 1, pak.padValue);
+      for (int i = 0; i < pakColumns; ++i) {
+        line[i].*pak.value = span[i];
+        line[i].flags |= pak.flag;
+      }
+    }
+  }
+  return decoded;
+}
+
+std::shared_ptr<const DaggerfallWorldRaster::Tile> DaggerfallWorldRaster::tile(int tileX,
+                                                                               int tileY) const
+{
+  const int key = tileKey(tileX, tileY);
+  {
+    QMutexLocker lock(&m_TileMutex);
+    const auto it = m_Tiles.constFind(key);
+    if (it != m_Tiles.constEnd()) {
+      it.value()->lastUse = ++m_UseCounter;
+      return it.value();
+    }
+  }
+
+  // Decode outside the lock; if another thread raced us, keep its tile.
+  auto decoded = decodeTile(tileX, tileY);
+
+  QMutexLocker lock(&m_TileMutex);
+  auto& slot = m_Tiles[key];
+  if (slot == nullptr) {
+    slot = decoded;
+  }
+  slot->lastUse = ++m_UseCounter;
+  std::shared_ptr<const Tile> result = slot;
+
+  while (m_Tiles.size() > m_TileCacheLimit) {
+    auto oldest = m_Tiles.begin();
+    for (auto it = m_Tiles.begin(); it != m_Tiles.end(); ++it) {
+      if (it.value()->lastUse < oldest.value()->lastUse) {
+        oldest = it;
+      }
+    }
+    m_Tiles.erase(oldest);
+  }
+  return result;
+}
+
+DaggerfallWorldRaster::Pixel DaggerfallWorldRaster::pixelAt(int x, int y) const
+{
+  if (x < 0 || y < 0 || x >= m_Width || y >= m_Height) {
+    return {};
+  }
+  const auto decoded = tile(x / kTileSize, y / kTileSize);
+  return decoded->pixels.at((y % kTileSize) * kTileSize + (x % kTileSize));
+}
+
+QVector<DaggerfallWorldRaster::Pixel> DaggerfallWorldRaster::region(const QRect& area,
+                                                                    QRect* clippedArea) const
+{
+  const QRect clipped = area.intersected(QRect(0, 0, m_Width, m_Height));
+  if (clippedArea != nullptr) {
+    *clippedArea = clipped;
+  }
+  QVector<Pixel> out;
+  if (clipped.isEmpty()) {
+    return out;
+  }
+
+  out.resize(static_cast<qsizetype>(clipped.width()) * clipped.height());
+  Pixel* dest = out.data();
+  for (int tileY = clipped.top() / kTileSize; tileY <= clipped.bottom() / kTileSize; ++tileY) {
+    for (int tileX = clipped.left() / kTileSize; tileX <= clipped.right() / kTileSize;
+         ++tileX) {
+      const auto decoded = tile(tileX, tileY);
+      const QRect tileRect(tileX * kTileSize, tileY * kTileSize, kTileSize, kTileSize);
+      const QRect part = tileRect.intersected(clipped);
+      for (int y = part.top(); y <= part.bottom(); ++y) {
+        const Pixel* src = decoded->pixels.constData() + (y - tileRect.top()) * kTileSize +
+                           (part.left() - tileRect.left());
+        std::copy(src, src + part.width(),
+                  dest + static_cast<qsizetype>(y - clipped.top()) * clipped.width() +
+                      (part.left() - clipped.left()));
+      }
+    }
+  }
+  return out;
+}
+
+QVector<DaggerfallWorldRaster::Pixel> DaggerfallWorldRaster::overview(int factor,
+                                                                      QSize* outSize) const
+{
+  factor = std::max(factor, 1);
+  const int columns = m_Width > 0 ? (m_Width + factor - 1) / factor : 0;
+  const int rows = m_Height > 0 ? (m_Height + factor - 1) / factor : 0;
+  if (outSize != nullptr) {
+    *outSize = QSize(columns, rows);
+  }
+
+  QVector<Pixel> out(static_cast<qsizetype>(columns) * rows);
+  QByteArray pakRow;
+  for (int row = 0; row < rows; ++row) {
+    const int y = row * factor;
+    Pixel* line = out.data() + static_cast<qsizetype>(row) * columns;
+    for (int column = 0; column < columns; ++column) {
+      decodeWoods(column * factor, y, 1, line + column, 1);
+    }
+
+    for (const PakLayer& pak : pakLayers(m_Climate, m_Politic, y)) {
+      if (pak.row == nullptr) {
+        continue;
+      }
+      pakRow.resize(pak.width);
+      auto* values = reinterpret_cast<quint8*>(pakRow.data());
+      pak.row->copySpan(0, pak.width, values, 1, pak.padValue);
+      for (int column = 0; column < columns && column * factor < pak.width; ++column) {
+        line[column].*pak.value = values[column * factor];
+        line[column].flags |= pak.flag;
+      }
+    }
+  }
+  return out;
+}
+
+DaggerfallWoodsWld::PixelData DaggerfallWorldRaster::pixelData(int x, int y) const
+{
+  DaggerfallWoodsWld::PixelData out{};
+  if (x < 0 || y < 0 || x >= m_Width || y >= m_Height) {
+    return out;
+  }
+  const qsizetype idx = static_cast<qsizetype>(y) * m_Width + x;
+  if (idx >= m_PixelOffsetCount) {
+    return out;
+  }
+  const uchar* wld = m_Woods.data();
+  const quint32 record = qFromLittleEndian<quint32>(wld + kWldHeaderSize + idx * 4);
+  if (record == 0 || static_cast<qsizetype>(record) + kWldPixelDataSize > m_Woods.size()) {
+    return out;
+  }
+
+  const uchar* p = wld + record;
+  out.unknown1 = qFromLittleEndian<quint16>(p + 0);
+  out.nullValue1 = qFromLittleEndian<quint32>(p + 2);
+  out.fileIndex = qFromLittleEndian<quint16>(p + 6);
+  out.terrainType = p[8];
+  out.terrainNoise = p[9];
+  out.nullValue2a = qFromLittleEndian<quint32>(p + 10);
+  out.nullValue2b = qFromLittleEndian<quint32>(p + 14);
+  out.nullValue2c = qFromLittleEndian<quint32>(p + 18);
+  std::memcpy(out.elevationNoise, p + 22, sizeof(out.elevationNoise));
+  return out;
+}
+
+DaggerfallWorldLayers::PixelInfo DaggerfallWorldRaster::pixelInfo(int x, int y) const
+{
+  DaggerfallWorldLayers::PixelInfo out;
+  out.x = x;
+  out.y = y;
+  if (x < 0 || y < 0 || x >= m_Width || y >= m_Height) {
+    return out;
+  }
+
+  const Pixel pixel = pixelAt(x, y);
+  out.woodsIndex = y * m_Width + x;
+  out.elevation = pixel.elevation;
+  out.woodsPixelData = pixelData(x, y);
+  out.climateValue = (pixel.flags & Pixel::kHasClimate) != 0 ? pixel.climate : -1;
+  out.climateMapping = DaggerfallClimatePak::mappingForValue(out.climateValue);
+  out.politicValue = (pixel.flags & Pixel::kHasPolitic) != 0 ? pixel.politic : -1;
+  out.regionIndex = DaggerfallPoliticPak::regionFromValue(out.politicValue);
+  out.valid = true;
+  return out;
+}
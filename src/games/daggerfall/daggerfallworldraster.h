@@ -0,0 +1,116 @@
+#ifndef DAGGERFALL_WORLDRASTER_H
+#define DAGGERFALL_WORLDRASTER_H
+
+#include "daggerfallclimatepak.h"
+#include "daggerfallpoliticpak.h"
+#include "daggerfallworldlayers.h"
+#include "daggerfallwoodswld.h"
+#include "xnginesaveview.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QRect>
+#include <QSize>
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+#include <memory>
+
+/**
+ * WOODS.WLD, CLIMATE.PAK and POLITIC.PAK as one lazily decoded world raster.
+ *
+ * Opening validates headers and the WLD offset table and keeps each PAK row as a
+ * DaggerfallPak::RunIndex (loadRunIndex); WOODS.WLD stays memory-mapped. Pixels are
+ * decoded per 64x64 tile, on first access, into one interleaved Pixel record (PAK
+ * rows are read only across the tile's span), and decoded tiles are kept in a small
+ * LRU cache, so memory follows the area being viewed rather than the whole map.
+ *
+ * overview() point-samples straight from the sources without filling the cache,
+ * which is the right filter for the categorical climate/politic values.
+ *
+ * Const members are safe to call from several threads.
+ */
+class DaggerfallWorldRaster
+{
+public:
+  static constexpr int kTileSize = 64;
+
+  struct Pixel
+  {
+    qint8 elevation = 0;
+    quint8 climate = 0;        // CLIMATE.PAK value
+    quint8 politic = 0;        // POLITIC.PAK value
+    quint8 terrainType = 0;    // WLD PixelData
+    quint8 terrainNoise = 0;   // WLD PixelData
+    quint8 flags = 0;          // kHas* bits
+    quint16 fileIndex = 0;     // WLD PixelData
+
+    static constexpr quint8 kHasPixelData = 0x01;
+    static constexpr quint8 kHasClimate = 0x02;
+    static constexpr quint8 kHasPolitic = 0x04;
+
+    int regionIndex() const;  // DaggerfallPoliticPak::regionFromValue, -2 without data
+  };
+  static_assert(sizeof(Pixel) == 8, "Pixel must stay an 8-byte interleaved record");
+
+  DaggerfallWorldRaster() = default;
+  DaggerfallWorldRaster(const DaggerfallWorldRaster&) = delete;
+  DaggerfallWorldRaster& operator=(const DaggerfallWorldRaster&) = delete;
+
+  bool open(const QString& arena2Path, QString* errorMessage = nullptr);
+  void close();
+
+  bool isOpen() const { return m_Width > 0; }
+  int width() const { return m_Width; }
+  int height() const { return m_Height; }
+  QString warning() const { return m_Warning; }
+
+  // Decoded tiles kept in memory (default 64, about 2 MiB).
+  void setTileCacheLimit(int tiles);
+  int cachedTileCount() const;
+
+  Pixel pixelAt(int x, int y) const;
+
+  // Row-major pixels of area clipped to the map; clippedArea receives the rect
+  // actually returned (empty when area misses the map).
+  QVector<Pixel> region(const QRect& area, QRect* clippedArea = nullptr) const;
+
+  // Every factor-th pixel in both directions, row-major; outSize receives the
+  // overview dimensions.
+  QVector<Pixel> overview(int factor, QSize* outSize = nullptr) const;
+
+  // Full WLD pixel record, including the 25-byte elevation noise, read directly
+  // from the mapping.
+  DaggerfallWoodsWld::PixelData pixelData(int x, int y) const;
+
+  // Same result as DaggerfallWorldLayers::pixelInfoAt over fully loaded layers.
+  DaggerfallWorldLayers::PixelInfo pixelInfo(int x, int y) const;
+
+private:
+  struct Tile
+  {
+    QVector<Pixel> pixels;  // kTileSize * kTileSize, row-major
+    quint64 lastUse = 0;
+  };
+
+  std::shared_ptr<const Tile> tile(int tileX, int tileY) const;
+  std::shared_ptr<Tile> decodeTile(int tileX, int tileY) const;
+  void decodeWoods(int x0, int y, int count, Pixel* dest, qsizetype stride) const;
+
+  XngineSaveView m_Woods;
+  DaggerfallClimatePak::Data m_Climate;  // rowRuns only
+  DaggerfallPoliticPak::Data m_Politic;  // rowRuns only
+  int m_Width = 0;
+  int m_Height = 0;
+  qsizetype m_PixelOffsetCount = 0;
+  qsizetype m_ElevationOffset = 0;
+  QString m_Warning;
+
+  mutable QMutex m_TileMutex;
+  mutable QHash<int, std::shared_ptr<Tile>> m_Tiles;
+  mutable quint64 m_UseCounter = 0;
+  int m_TileCacheLimit = 64;
+};
+
+#endif  // DAGGERFALL_WORLDRASTER_H
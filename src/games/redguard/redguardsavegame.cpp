@@ -1,6 +1,11 @@
 #include "redguardsavegame.h"
+#ifdef XNGINE_HEADLESS
+#include "xngineheadless.h"
+#else
 #include "gameredguard.h"
+#endif
 #include "redguardsrtxdatabase.h"
+#include "xnginesaveview.h"
 
 #include <QDir>
 #include <QFile>
@@ -155,6 +160,13 @@ QString RedguardsSaveGame::getGameDetails() const
   return lines.join('\n');
 }
 
+XngineSaveGame::Metadata RedguardsSaveGame::metadata() const
+{
+  Metadata meta = XngineSaveGame::metadata();
+  meta.gold = m_Gold;
+  return meta;
+}
+
 QStringList RedguardsSaveGame::allFiles() const
 {
   const QFileInfo fi(getFilepath());
@@ -235,13 +247,8 @@ void RedguardsSaveGame::parseAuxiliaryMetadata()
     return;
   }
 
-  QFile f(tsgFiles.first().absoluteFilePath());
-  if (!f.open(QIODevice::ReadOnly)) {
-    return;
-  }
-  const QByteArray bytes = f.readAll();
-  f.close();
-
+  const XngineSaveView view(tsgFiles.first().absoluteFilePath());
+  const QByteArray bytes = view.bytes();
   if (bytes.size() < 16) {
     return;
   }
@@ -272,21 +279,20 @@ void RedguardsSaveGame::detectSlotFromFolder()
 
 bool RedguardsSaveGame::parseSaveHeader()
 {
-  QFile f(m_SaveFile);
-  if (!f.open(QIODevice::ReadOnly)) {
+  const XngineSaveView view(m_SaveFile);
+  if (!view.isOpen()) {
     return false;
   }
 
-  const QByteArray bytes = f.readAll();
-  m_FileSize = static_cast<quint64>(f.size());
-  f.close();
+  const QByteArray bytes = view.bytes();
+  m_FileSize = static_cast<quint64>(view.size());
   if (bytes.size() < 0x30) {
     return false;
   }
 
-  m_ValidSignature = (bytes.mid(0, 4) == "SVGM");
-  m_FormatVersion = readFixedCString(bytes, 0x08, 8);
-  m_SaveTitle = readFixedCString(bytes, 0x14, 128);
+  m_ValidSignature = bytes.startsWith("SVGM");
+  m_FormatVersion = view.readFixedString(0x08, 8);
+  m_SaveTitle = view.readFixedString(0x14, 128);
   m_HasThumbnail = (bytes.indexOf("THMB") >= 0);
 
   // Redguard has a fixed protagonist.
@@ -470,12 +476,8 @@ std::unique_ptr<XngineSaveGame::DataFields> RedguardsSaveGame::fetchDataFields()
 {
   auto fields = std::make_unique<DataFields>();
 
-  QFile f(m_SaveFile);
-  if (!f.open(QIODevice::ReadOnly)) {
-    return fields;
-  }
-  const QByteArray bytes = f.readAll();
-  f.close();
+  const XngineSaveView view(m_SaveFile);
+  const QByteArray bytes = view.bytes();
   if (bytes.size() < 0x120) {
     return fields;
   }
@@ -537,18 +539,3 @@ std::unique_ptr<XngineSaveGame::DataFields> RedguardsSaveGame::fetchDataFields()
   fields->Screenshot = image;
   return fields;
 }
-
-QString RedguardsSaveGame::readFixedCString(const QByteArray& data, qsizetype offset,
-                                            qsizetype maxLen)
-{
-  if (offset < 0 || maxLen <= 0 || offset + maxLen > data.size()) {
-    return {};
-  }
-
-  QByteArray value = data.mid(offset, maxLen);
-  const int nul = value.indexOf('\0');
-  if (nul >= 0) {
-    value.truncate(nul);
-  }
-  return QString::fromLocal8Bit(value).trimmed();
-}
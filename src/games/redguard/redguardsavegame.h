@@ -21,6 +21,7 @@ public:
   virtual QString getName() const override;
   virtual QString getGameDetails() const override;
   virtual QStringList allFiles() const override;
+  virtual Metadata metadata() const override;
 
 protected:
   virtual std::unique_ptr<DataFields> fetchDataFields() const override;
@@ -33,7 +34,6 @@ private:
   bool parseSaveHeader();
   void parseStructuredMetadata(const QByteArray& bytes);
   void resolveLocationFromCode();
-  static QString readFixedCString(const QByteArray& data, qsizetype offset, qsizetype maxLen);
   static bool isWeakLocationToken(const QString& code, const QString& subtitle);
 
 private:
@@ -7,6 +7,7 @@
 #include "utility.h"
 #include "vdf_parser.h"
 #include "xnginearchiveextractorfeature.h"
+#include "xnginesavegameinfo.h"
 
 #include <QDir>
 #include <QDirIterator>
@@ -14,6 +15,7 @@
 #include <QFileInfo>
 #include <QIcon>
 #include <QJsonDocument>
+#include <QJsonObject>
 #include <QJsonValue>
 
 #include <QtDebug>
@@ -22,6 +24,7 @@
 #include <Knownfolders.h>
 #include <Shlobj.h>
 #include <Windows.h>
+#include <winioctl.h>
 #include <winreg.h>
 #include <winver.h>
 
@@ -54,6 +57,177 @@ static bool isPeExecutable(const QString& path)
          peSig[3] == '\0';
 }
 
+static constexpr const char* MATERIALIZE_MANIFEST_NAME = "xngine_materialized.json";
+
+struct MaterializeStats
+{
+  int cloned = 0;
+  int copied = 0;
+};
+
+// Block clone (FSCTL_DUPLICATE_EXTENTS_TO_FILE) of source into a new destination. The
+// clone shares the source's clusters copy-on-write, so writes through either file stay
+// private to it. Only ReFS/Dev Drive volumes support it; everything else fails here.
+static bool cloneFile(const QString& source, const QString& destination)
+{
+  const std::wstring nativeSource = QDir::toNativeSeparators(source).toStdWString();
+  const std::wstring nativeDest   = QDir::toNativeSeparators(destination).toStdWString();
+
+  HANDLE src = ::CreateFileW(nativeSource.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                             OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (src == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+  ON_BLOCK_EXIT([&] { ::CloseHandle(src); });
+
+  LARGE_INTEGER size{};
+  wchar_t volume[MAX_PATH] = {};
+  DWORD sectorsPerCluster = 0;
+  DWORD bytesPerSector = 0;
+  DWORD freeClusters = 0;
+  DWORD totalClusters = 0;
+  if (!::GetFileSizeEx(src, &size) ||
+      !::GetVolumePathNameW(nativeSource.c_str(), volume, MAX_PATH) ||
+      !::GetDiskFreeSpaceW(volume, &sectorsPerCluster, &bytesPerSector, &freeClusters,
+                           &totalClusters)) {
+    return false;
+  }
+
+  HANDLE dst = ::CreateFileW(nativeDest.c_str(), GENERIC_READ | GENERIC_WRITE | DELETE, 0,
+                             nullptr, CREATE_NEW, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (dst == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+
+  FILE_END_OF_FILE_INFO eof{};
+  eof.EndOfFile = size;
+  bool ok = ::SetFileInformationByHandle(dst, FileEndOfFileInfo, &eof, sizeof(eof)) != FALSE;
+
+  // Ranges must be cluster aligned; the last one may run past EOF up to the cluster end.
+  const LONGLONG cluster =
+      std::max<LONGLONG>(1, static_cast<LONGLONG>(sectorsPerCluster) * bytesPerSector);
+  constexpr LONGLONG kChunk = 1LL << 30;
+  for (LONGLONG offset = 0; ok && offset < size.QuadPart; offset += kChunk) {
+    const LONGLONG remaining = size.QuadPart - offset;
+    DUPLICATE_EXTENTS_DATA extents{};
+    extents.FileHandle                  = src;
+    extents.SourceFileOffset.QuadPart   = offset;
+    extents.TargetFileOffset.QuadPart   = offset;
+    extents.ByteCount.QuadPart          =
+        std::min(kChunk, (remaining + cluster - 1) / cluster * cluster);
+    DWORD returned = 0;
+    ok = ::DeviceIoControl(dst, FSCTL_DUPLICATE_EXTENTS_TO_FILE, &extents, sizeof(extents),
+                           nullptr, 0, &returned, nullptr) != FALSE;
+  }
+
+  if (!ok) {
+    FILE_DISPOSITION_INFO dispose{};
+    dispose.DeleteFile = TRUE;
+    ::SetFileInformationByHandle(dst, FileDispositionInfo, &dispose, sizeof(dispose));
+  }
+  ::CloseHandle(dst);
+  return ok;
+}
+
+// Materialized slots must be independent of the legacy originals: the game writes saves
+// in place, so a hard link would write through to both. Clone where the volume supports
+// it and fall back to a real copy everywhere else.
+static bool cloneOrCopyFile(const QString& source, const QString& destination,
+                            MaterializeStats& stats)
+{
+  if (cloneFile(source, destination)) {
+    ++stats.cloned;
+    return true;
+  }
+  if (QFile::copy(source, destination)) {
+    ++stats.copied;
+    return true;
+  }
+  return false;
+}
+
+// Total size and newest modification time of a file, or of every file under a directory.
+static void statMaterialized(const QString& path, qint64& size, QDateTime& modified)
+{
+  size = 0;
+  modified = {};
+  const QFileInfo info(path);
+  if (info.isFile()) {
+    size = info.size();
+    modified = info.lastModified();
+    return;
+  }
+  QDirIterator it(path, QDir::Files, QDirIterator::Subdirectories);
+  while (it.hasNext()) {
+    it.next();
+    const QFileInfo file = it.fileInfo();
+    size += file.size();
+    if (!modified.isValid() || file.lastModified() > modified) {
+      modified = file.lastModified();
+    }
+  }
+}
+
+static bool cloneOrCopyDirRecursive(const QString& source, const QString& destination,
+                                    MaterializeStats& stats)
+{
+  QDir src(source);
+  if (!src.exists()) {
+    return false;
+  }
+  if (!QDir().mkpath(destination)) {
+    return false;
+  }
+
+  const auto subdirs = src.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot);
+  for (const auto& subdir : subdirs) {
+    const QString dstSubdir = QDir(destination).filePath(subdir.fileName());
+    if (!cloneOrCopyDirRecursive(subdir.absoluteFilePath(), dstSubdir, stats)) {
+      return false;
+    }
+  }
+
+  const auto files = src.entryInfoList(QDir::Files);
+  for (const auto& file : files) {
+    const QString dstFile = QDir(destination).filePath(file.fileName());
+    if (!QFileInfo::exists(dstFile)) {
+      if (!cloneOrCopyFile(file.absoluteFilePath(), dstFile, stats)) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+static QJsonObject loadMaterializeManifest(const QString& saveRoot)
+{
+  QFile file(QDir(saveRoot).filePath(MATERIALIZE_MANIFEST_NAME));
+  if (!file.open(QIODevice::ReadOnly)) {
+    return {};
+  }
+  const QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+  if (!doc.isObject() || doc.object().value("version").toInt() != 1) {
+    return {};
+  }
+  return doc.object().value("entries").toObject();
+}
+
+static void saveMaterializeManifest(const QString& saveRoot, const QJsonObject& entries)
+{
+  QJsonObject root;
+  root.insert("version", 1);
+  root.insert("entries", entries);
+
+  QFile file(QDir(saveRoot).filePath(MATERIALIZE_MANIFEST_NAME));
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+    qWarning().noquote() << "[GameXngine] failed to write save materialize manifest:"
+                         << file.fileName();
+    return;
+  }
+  file.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+}
+
 GameXngine::GameXngine() {
   qInfo().noquote() << "[GameXngine] Constructor ENTRY";
   OutputDebugStringA("[GameXngine] Constructor ENTRY\n");
@@ -264,36 +438,12 @@ GameXngine::listSaves(QDir folder) const
       std::set<QString> visitedRoots;
       const QString profileSaveRoot = QDir::cleanPath(rootDir.absolutePath());
 
-      std::function<bool(const QString&, const QString&)> copyDirRecursive;
-      copyDirRecursive = [&](const QString& source, const QString& destination) -> bool {
-        QDir src(source);
-        if (!src.exists()) {
-          return false;
-        }
-        if (!QDir().mkpath(destination)) {
-          return false;
-        }
-
-        const auto subdirs = src.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot);
-        for (const auto& subdir : subdirs) {
-          const QString dstSubdir = QDir(destination).filePath(subdir.fileName());
-          if (!copyDirRecursive(subdir.absoluteFilePath(), dstSubdir)) {
-            return false;
-          }
-        }
-
-        const auto files = src.entryInfoList(QDir::Files);
-        for (const auto& file : files) {
-          const QString dstFile = QDir(destination).filePath(file.fileName());
-          if (!QFileInfo::exists(dstFile)) {
-            if (!QFile::copy(file.absoluteFilePath(), dstFile)) {
-              return false;
-            }
-          }
-        }
-
-        return true;
-      };
+      // Legacy slots are block-cloned into the profile where the volume supports it and
+      // copied otherwise. Every materialized entry is recorded in a manifest together with
+      // the size and modification time of its source, so a slot is only materialized again
+      // when the legacy original changed and the profile copy was not saved to since.
+      QJsonObject manifestEntries = loadMaterializeManifest(profileSaveRoot);
+      bool manifestDirty = false;
 
       auto materializeInProfile = [&](const QFileInfo& entry) -> QString {
         const QString sourcePath = QDir::cleanPath(entry.absoluteFilePath());
@@ -302,25 +452,83 @@ GameXngine::listSaves(QDir folder) const
           return sourcePath;
         }
 
-        const QString destPath = QDir(profileSaveRoot).filePath(entry.fileName());
+        qint64 sourceSize = 0;
+        QDateTime sourceModified;
+        statMaterialized(sourcePath, sourceSize, sourceModified);
+        const QString sourceStamp = sourceModified.toUTC().toString(Qt::ISODate);
+
+        const QString destPath = QDir::cleanPath(QDir(profileSaveRoot).filePath(entry.fileName()));
+        const QJsonObject recorded = manifestEntries.value(entry.fileName()).toObject();
+        const bool sameSource =
+            recorded.value("source").toString().compare(sourcePath, Qt::CaseInsensitive) == 0;
+        bool refresh = false;
+        if (sameSource && QFileInfo::exists(destPath)) {
+          if (recorded.value("size").toInteger() == sourceSize &&
+              recorded.value("modified").toString() == sourceStamp) {
+            return destPath;
+          }
+          // The original changed. Keep the profile copy if the game saved to it since it
+          // was materialized; otherwise replace it with the new original.
+          qint64 destSize = 0;
+          QDateTime destModified;
+          statMaterialized(destPath, destSize, destModified);
+          const QDateTime materialized =
+              QDateTime::fromString(recorded.value("materialized").toString(), Qt::ISODateWithMs);
+          if (!materialized.isValid() || destModified > materialized) {
+            return destPath;
+          }
+          refresh = true;
+        }
+
+        // A refresh is built next to the slot and swapped in once complete.
+        const QString targetPath = refresh ? destPath + ".xngine-refresh" : destPath;
+        if (refresh) {
+          if (entry.isDir()) {
+            QDir(targetPath).removeRecursively();
+          } else {
+            QFile::remove(targetPath);
+          }
+        }
+
+        MaterializeStats stats;
         if (entry.isDir()) {
-          if (!QDir(destPath).exists()) {
-            if (!copyDirRecursive(sourcePath, destPath)) {
-              return sourcePath;
+          if (!QDir(targetPath).exists()) {
+            if (!cloneOrCopyDirRecursive(sourcePath, targetPath, stats)) {
+              return refresh ? destPath : sourcePath;
             }
           }
         } else {
-          if (!QFileInfo::exists(destPath)) {
-            if (!QDir().mkpath(QFileInfo(destPath).absolutePath())) {
+          if (!QFileInfo::exists(targetPath)) {
+            if (!QDir().mkpath(QFileInfo(targetPath).absolutePath())) {
               return sourcePath;
             }
-            if (!QFile::copy(sourcePath, destPath)) {
-              return sourcePath;
+            if (!cloneOrCopyFile(sourcePath, targetPath, stats)) {
+              return refresh ? destPath : sourcePath;
             }
           }
         }
 
-        return QDir::cleanPath(destPath);
+        if (refresh) {
+          const bool removed =
+              entry.isDir() ? QDir(destPath).removeRecursively() : QFile::remove(destPath);
+          if (!removed || !QDir().rename(targetPath, destPath)) {
+            qWarning().noquote() << "[GameXngine] failed to refresh save slot:" << destPath;
+            return QFileInfo::exists(destPath) ? destPath : sourcePath;
+          }
+        }
+
+        QJsonObject record;
+        record.insert("source", sourcePath);
+        record.insert("cloned", stats.cloned);
+        record.insert("copied", stats.copied);
+        record.insert("size", sourceSize);
+        record.insert("modified", sourceStamp);
+        record.insert("materialized",
+                      QDateTime::currentDateTimeUtc().toString(Qt::ISODateWithMs));
+        manifestEntries.insert(entry.fileName(), record);
+        manifestDirty = true;
+
+        return destPath;
       };
 
       for (const auto& probePath : rootsToProbe) {
@@ -392,6 +600,10 @@ GameXngine::listSaves(QDir folder) const
         }
       }
 
+      if (manifestDirty) {
+        saveMaterializeManifest(profileSaveRoot, manifestEntries);
+      }
+
       std::sort(saveSlots.begin(), saveSlots.end(), [](const SaveSlot& a, const SaveSlot& b) {
         if (a.slotNumber != b.slotNumber)
           return a.slotNumber < b.slotNumber;
@@ -447,6 +659,12 @@ GameXngine::listSaves(QDir folder) const
   }
 
   qInfo().noquote() << "[GameXngine] listSaves() - total saves returned:" << saves.size();
+  if (m_Organizer != nullptr) {
+    const auto info = m_Organizer->gameFeatures()->gameFeature<MOBase::SaveGameInfo>();
+    if (const auto* xngineInfo = dynamic_cast<const XngineSaveGameInfo*>(info.get())) {
+      xngineInfo->refreshSaveIndex(saves);
+    }
+  }
   return saves;
 }
 
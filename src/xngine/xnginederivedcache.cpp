@@ -0,0 +1,244 @@
+#include "xnginederivedcache.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <cstring>
+
+namespace
+{
+
+struct HashEntry
+{
+  qint64 size = -1;
+  QDateTime modified;
+  QString hash;
+};
+
+// <directory>/hash-<sha1 of the folded path>.txt holding "<size> <mtime ms> <hash>".
+QString stampPath(const QString& absolutePath)
+{
+  const QByteArray key =
+      QCryptographicHash::hash(absolutePath.toCaseFolded().toUtf8(), QCryptographicHash::Sha1);
+  return XngineDerivedCache::pathFor("hash", QString::fromLatin1(key.toHex()), "txt");
+}
+
+QString readStamp(const QString& path, const QFileInfo& info)
+{
+  QFile file(path);
+  if (path.isEmpty() || !file.open(QIODevice::ReadOnly)) {
+    return {};
+  }
+  const QList<QByteArray> fields = file.readAll().trimmed().split(' ');
+  if (fields.size() != 3 || fields.at(0).toLongLong() != info.size() ||
+      fields.at(1).toLongLong() != info.lastModified().toMSecsSinceEpoch() ||
+      fields.at(2).size() != 40) {
+    return {};
+  }
+  return QString::fromLatin1(fields.at(2));
+}
+
+}  // namespace
+
+QString XngineDerivedCache::directory()
+{
+  const QString base = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+  if (base.isEmpty()) {
+    return {};
+  }
+  const QString path = QDir(base).filePath("xngine");
+  if (!QDir().mkpath(path)) {
+    return {};
+  }
+  return path;
+}
+
+QString XngineDerivedCache::contentHash(const QString& filePath)
+{
+  static QMutex mutex;
+  static QHash<QString, HashEntry> memo;
+
+  const QFileInfo info(filePath);
+  if (!info.isFile()) {
+    return {};
+  }
+  const QString key = info.absoluteFilePath();
+  {
+    QMutexLocker lock(&mutex);
+    const auto it = memo.constFind(key);
+    if (it != memo.constEnd() && it->size == info.size() &&
+        it->modified == info.lastModified()) {
+      return it->hash;
+    }
+  }
+
+  // A matching size/mtime stamp from an earlier session saves re-reading the file.
+  const QString stamp = stampPath(key);
+  QString hash = readStamp(stamp, info);
+  if (hash.isEmpty()) {
+    XngineSaveView view(filePath);
+    if (!view.isOpen()) {
+      return {};
+    }
+    QCryptographicHash hasher(QCryptographicHash::Sha1);
+    hasher.addData(view.bytes());
+    hash = QString::fromLatin1(hasher.result().toHex());
+    if (!stamp.isEmpty()) {
+      write(stamp, QString("%1 %2 %3\n")
+                       .arg(info.size())
+                       .arg(info.lastModified().toMSecsSinceEpoch())
+                       .arg(hash)
+                       .toLatin1());
+    }
+  }
+
+  QMutexLocker lock(&mutex);
+  memo.insert(key, HashEntry{info.size(), info.lastModified(), hash});
+  return hash;
+}
+
+QString XngineDerivedCache::pathFor(const QString& kind, const QString& hash,
+                                    const QString& suffix)
+{
+  if (hash.isEmpty()) {
+    return {};
+  }
+  const QString dir = directory();
+  if (dir.isEmpty()) {
+    return {};
+  }
+  return QDir(dir).filePath(QString("%1-%2.%3").arg(kind, hash, suffix));
+}
+
+bool XngineDerivedCache::write(const QString& path, const QByteArray& data,
+                               QString* errorMessage)
+{
+  QSaveFile file(path);
+  if (!file.open(QIODevice::WriteOnly)) {
+    if (errorMessage != nullptr) {
+      *errorMessage = QString("Cannot write %1: %2").arg(path, file.errorString());
+    }
+    return false;
+  }
+  if (file.write(data) != data.size() || !file.commit()) {
+    if (errorMessage != nullptr) {
+      *errorMessage = QString("Cannot write %1: %2").arg(path, file.errorString());
+    }
+    return false;
+  }
+  return true;
+}
+
+void XngineDerivedCache::appendHeader(QByteArray& out, const Format& format,
+                                      const QString& sourceHash)
+{
+  out.append(format.magic, sizeof(format.magic));
+  appendLE<quint32>(out, format.version);
+  out.append(sourceHash.toLatin1().leftJustified(kHashSize, '\0', true));
+}
+
+bool XngineDerivedCache::checkHeader(const uchar* data, qsizetype size, const Format& format,
+                                     const QString& expectedHash, QString* errorMessage)
+{
+  auto fail = [errorMessage](const QString& message) {
+    if (errorMessage != nullptr) {
+      *errorMessage = message;
+    }
+    return false;
+  };
+  if (data == nullptr || size < kHeaderSize ||
+      std::memcmp(data, format.magic, sizeof(format.magic)) != 0 ||
+      qFromLittleEndian<quint32>(data + 4) != format.version) {
+    return fail(QString("%1 has an unknown format").arg(format.name));
+  }
+  const QByteArray storedHash(reinterpret_cast<const char*>(data + 8), kHashSize);
+  if (storedHash != expectedHash.toLatin1().leftJustified(kHashSize, '\0', true)) {
+    return fail(QString("%1 was built from a different %2").arg(format.name, format.source));
+  }
+  return true;
+}
+
+bool XngineDerivedCache::Table::open(const QString& cachePath, const QString& expectedHash,
+                                     QString* errorMessage)
+{
+  m_Owned.clear();
+  m_Data = nullptr;
+  if (!m_View.open(cachePath)) {
+    if (errorMessage != nullptr) {
+      *errorMessage = QString("Cannot open %1").arg(cachePath);
+    }
+    return false;
+  }
+  if (!attach(m_View.data(), m_View.size(), expectedHash, errorMessage)) {
+    m_View.close();
+    return false;
+  }
+  return true;
+}
+
+bool XngineDerivedCache::Table::load(const QByteArray& data, const QString& expectedHash,
+                                     QString* errorMessage)
+{
+  m_View.close();
+  m_Owned = data;
+  if (!attach(reinterpret_cast<const uchar*>(m_Owned.constData()), m_Owned.size(),
+              expectedHash, errorMessage)) {
+    m_Owned.clear();
+    return false;
+  }
+  return true;
+}
+
+bool XngineDerivedCache::Table::openOrBuild(
+    const QString& cachePath, const QString& expectedHash,
+    const std::function<bool(QByteArray&, QString*)>& build, QString* errorMessage)
+{
+  if (!cachePath.isEmpty() && open(cachePath, expectedHash)) {
+    return true;
+  }
+
+  QByteArray bytes;
+  if (!build(bytes, errorMessage)) {
+    return false;
+  }
+  return store(cachePath, bytes, expectedHash, errorMessage);
+}
+
+bool XngineDerivedCache::Table::store(const QString& cachePath, const QByteArray& bytes,
+                                      const QString& expectedHash, QString* errorMessage)
+{
+  if (!cachePath.isEmpty()) {
+    QString writeError;
+    if (write(cachePath, bytes, &writeError)) {
+      if (open(cachePath, expectedHash, &writeError)) {
+        return true;
+      }
+    }
+    qWarning().noquote() << "[XngineDerivedCache]" << m_Format.name
+                         << "not cached:" << writeError;
+  }
+  return load(bytes, expectedHash, errorMessage);
+}
+
+bool XngineDerivedCache::Table::attach(const uchar* data, qsizetype size,
+                                       const QString& expectedHash, QString* errorMessage)
+{
+  m_Data = nullptr;
+  m_Size = 0;
+  if (!checkHeader(data, size, m_Format, expectedHash, errorMessage) ||
+      !attachLayout(data, size, errorMessage)) {
+    return false;
+  }
+  m_Data = data;
+  m_Size = size;
+  return true;
+}
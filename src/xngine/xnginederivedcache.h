@@ -0,0 +1,159 @@
+#ifndef XNGINEDERIVEDCACHE_H
+#define XNGINEDERIVEDCACHE_H
+
+#include "xnginesaveview.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QString>
+#include <QtEndian>
+
+#include <functional>
+#include <memory>
+
+/**
+ * Placement and keying of derived cache files: pre-decoded indices built from
+ * game archives so later sessions can map them instead of re-parsing.
+ *
+ * Cache files are named after a content hash of their source file, so a patched
+ * or replaced archive simply misses and gets rebuilt; a stale cache is never read.
+ * Every helper degrades to "no cache" (empty path / false) rather than failing,
+ * and callers are expected to fall back to decoding in memory.
+ *
+ * Every table starts with the same header (little-endian):
+ *   char[4] magic, u32 version, char[40] source SHA-1 (hex, NUL padded)
+ * Table handles the header check and the mapping; each index only lays out and
+ * validates what follows it.
+ */
+class XngineDerivedCache
+{
+public:
+  static constexpr qsizetype kHashSize = 40;
+  static constexpr qsizetype kHeaderSize = 4 + 4 + kHashSize;
+
+  struct Format
+  {
+    char magic[4];
+    quint32 version;
+    const char* name;    // for errors, e.g. "Location table cache"
+    const char* source;  // what the hash covers, e.g. "MAPS.BSA"
+  };
+
+  /**
+   * Base for indices that answer queries straight from a derived cache file.
+   * The file is mapped through XngineSaveView, or held in memory when it could
+   * not be written; subclasses validate their layout in attachLayout().
+   */
+  class Table
+  {
+  public:
+    // format must outlive the table (a namespace-scope constant in practice).
+    explicit Table(const Format& format) : m_Format(format) {}
+    virtual ~Table() = default;
+
+    Table(const Table&)            = delete;
+    Table& operator=(const Table&) = delete;
+
+    // Map an existing cache file; fails when it is missing, truncated or stale.
+    bool open(const QString& cachePath, const QString& expectedHash,
+              QString* errorMessage = nullptr);
+    // Same validation over bytes already in memory (used when no cache dir exists).
+    bool load(const QByteArray& data, const QString& expectedHash,
+              QString* errorMessage = nullptr);
+    // Maps cachePath when it holds this table for expectedHash. Otherwise build()
+    // produces the bytes, which are written to cachePath and mapped from there,
+    // or kept in memory when caching is unavailable or the write fails.
+    bool openOrBuild(const QString& cachePath, const QString& expectedHash,
+                     const std::function<bool(QByteArray&, QString*)>& build,
+                     QString* errorMessage = nullptr);
+    // Writes bytes built elsewhere to cachePath and maps them, or keeps them in
+    // memory when cachePath is empty or the write fails.
+    bool store(const QString& cachePath, const QByteArray& bytes, const QString& expectedHash,
+               QString* errorMessage = nullptr);
+
+    bool isValid() const { return m_Data != nullptr; }
+
+  protected:
+    // Called with the header already checked; size is the whole file. Returns
+    // false (with an error) when the rest of the layout does not fit.
+    virtual bool attachLayout(const uchar* data, qsizetype size, QString* errorMessage) = 0;
+
+    const uchar* tableData() const { return m_Data; }
+    qsizetype tableSize() const { return m_Size; }
+
+  private:
+    bool attach(const uchar* data, qsizetype size, const QString& expectedHash,
+                QString* errorMessage);
+
+    const Format& m_Format;
+    XngineSaveView m_View;
+    QByteArray m_Owned;
+    const uchar* m_Data = nullptr;
+    qsizetype m_Size    = 0;
+  };
+
+  /**
+   * Process-wide memo of shared indices. Lookups and publishing take the lock;
+   * building does not, so a slow first build never blocks unrelated keys. Two
+   * racing builds of one key are both finished and the first published wins.
+   */
+  template <typename T>
+  class SharedMemo
+  {
+  public:
+    std::shared_ptr<const T> find(const QString& key) const
+    {
+      QMutexLocker lock(&m_Mutex);
+      return m_Values.value(key);
+    }
+
+    std::shared_ptr<const T> publish(const QString& key, std::shared_ptr<const T> value)
+    {
+      QMutexLocker lock(&m_Mutex);
+      const auto existing = m_Values.constFind(key);
+      if (existing != m_Values.constEnd()) {
+        return existing.value();
+      }
+      m_Values.insert(key, value);
+      return value;
+    }
+
+  private:
+    mutable QMutex m_Mutex;
+    QHash<QString, std::shared_ptr<const T>> m_Values;
+  };
+
+  // <writable app cache>/xngine, created on demand; empty if unavailable.
+  static QString directory();
+
+  // Hex SHA-1 of the file contents, memoized per path/size/mtime both for the
+  // process lifetime and across sessions (a stamp file in directory()), so an
+  // unchanged archive is only hashed once. Empty if the file cannot be read.
+  static QString contentHash(const QString& filePath);
+
+  // <directory>/<kind>-<hash>.<suffix>; empty when caching is unavailable.
+  static QString pathFor(const QString& kind, const QString& hash,
+                         const QString& suffix = QStringLiteral("bin"));
+
+  // Atomic replace (QSaveFile), so concurrent readers never see a partial file.
+  static bool write(const QString& path, const QByteArray& data,
+                    QString* errorMessage = nullptr);
+
+  // The common table header; the caller appends its own counts and body.
+  static void appendHeader(QByteArray& out, const Format& format, const QString& sourceHash);
+  // Checks magic, version and source hash of a table of at least kHeaderSize bytes.
+  static bool checkHeader(const uchar* data, qsizetype size, const Format& format,
+                          const QString& expectedHash, QString* errorMessage = nullptr);
+
+  template <typename T>
+  static void appendLE(QByteArray& out, T value)
+  {
+    uchar bytes[sizeof(T)];
+    qToLittleEndian(value, bytes);
+    out.append(reinterpret_cast<const char*>(bytes), sizeof(T));
+  }
+};
+
+#endif  // XNGINEDERIVEDCACHE_H
@@ -0,0 +1,121 @@
+#ifndef XNGINEHEADLESS_H
+#define XNGINEHEADLESS_H
+
+// Stand-ins for the MO2 and plugin types the save parsers depend on, used when the
+// parsers are compiled outside the plugin with XNGINE_HEADLESS defined (see
+// tools/xngine_save_bench). Only the members the parsers actually call exist here;
+// nothing in this header is part of the plugin build.
+
+#ifndef XNGINE_HEADLESS
+#error "xngineheadless.h is only for XNGINE_HEADLESS builds"
+#endif
+
+#include <QDateTime>
+#include <QDir>
+#include <QString>
+#include <QStringList>
+
+#include <functional>
+#include <mutex>
+#include <utility>
+
+namespace MOBase
+{
+
+class ISaveGame
+{
+public:
+  virtual ~ISaveGame() = default;
+
+  virtual QString getFilepath() const            = 0;
+  virtual QDateTime getCreationTime() const      = 0;
+  virtual QString getName() const                = 0;
+  virtual QString getSaveGroupIdentifier() const = 0;
+  virtual QStringList allFiles() const           = 0;
+};
+
+// Same contract as uibase's MemoizedLocked: compute once on first value(), under a lock.
+template <class T, class Fn = std::function<T()>>
+class MemoizedLocked
+{
+public:
+  template <class Callable>
+  MemoizedLocked(Callable&& callable) : m_Fn(std::forward<Callable>(callable))
+  {}
+
+  T& value() const
+  {
+    std::scoped_lock lock(m_Mutex);
+    if (m_NeedsUpdate) {
+      m_Value       = m_Fn();
+      m_NeedsUpdate = false;
+    }
+    return m_Value;
+  }
+
+  void invalidate()
+  {
+    std::scoped_lock lock(m_Mutex);
+    m_NeedsUpdate = true;
+  }
+
+private:
+  mutable std::mutex m_Mutex;
+  Fn m_Fn;
+  mutable T m_Value{};
+  mutable bool m_NeedsUpdate = true;
+};
+
+}  // namespace MOBase
+
+// Game install lookup used by the parsers for palettes, MAPS.BSA and ENGLISH.RTX.
+// An empty game path makes every lookup miss, exactly like a null game pointer.
+class GameXngine
+{
+public:
+  explicit GameXngine(const QString& gamePath = {}) : m_GamePath(gamePath) {}
+  virtual ~GameXngine() = default;
+
+  QDir gameDirectory() const { return QDir(m_GamePath); }
+  virtual QDir dataDirectory() const { return QDir(gameDirectory().absoluteFilePath("data")); }
+  QString savegameSEExtension() const { return {}; }
+
+  void setGamePath(const QString& path) { m_GamePath = path; }
+
+private:
+  QString m_GamePath;
+};
+
+class GameArena : public GameXngine
+{
+public:
+  using GameXngine::GameXngine;
+};
+
+class GameBattlespire : public GameXngine
+{
+public:
+  using GameXngine::GameXngine;
+};
+
+class GameDaggerfall : public GameXngine
+{
+public:
+  using GameXngine::GameXngine;
+};
+
+class GameRedguard : public GameXngine
+{
+public:
+  using GameXngine::GameXngine;
+  QDir dataDirectory() const override
+  {
+    const QDir gameDir = gameDirectory();
+    if (gameDir.path().isEmpty() || !gameDir.exists()) {
+      return QDir();
+    }
+    return QDir(gameDir.absoluteFilePath("Redguard"));
+  }
+};
+
+#endif  // XNGINEHEADLESS_H
@@ -0,0 +1,37 @@
+#include "xngineparallel.h"
+
+#include <QThread>
+#include <QThreadPool>
+
+#include <algorithm>
+#include <atomic>
+
+void XngineParallel::parallelFor(int count, const std::function<void(int)>& fn, int maxThreads)
+{
+  if (count <= 0) {
+    return;
+  }
+
+  std::atomic<int> next{0};
+  auto worker = [&]() {
+    for (int index = next.fetch_add(1, std::memory_order_relaxed); index < count;
+         index = next.fetch_add(1, std::memory_order_relaxed)) {
+      fn(index);
+    }
+  };
+
+  int threads = maxThreads > 0 ? maxThreads : QThread::idealThreadCount();
+  threads = std::clamp(threads, 1, count);
+  if (threads == 1) {
+    worker();
+    return;
+  }
+
+  QThreadPool pool;
+  pool.setMaxThreadCount(threads - 1);
+  for (int i = 0; i < threads - 1; ++i) {
+    pool.start(worker);
+  }
+  worker();
+  pool.waitForDone();
+}
@@ -0,0 +1,26 @@
+#ifndef XNGINEPARALLEL_H
+#define XNGINEPARALLEL_H
+
+#include <functional>
+
+/**
+ * Fan-out helper for batch decoders that process many independent records or
+ * files (quest validation, texture sets, ARCH3D meshes, BLOCKS.BSA entries).
+ *
+ * Indices are handed out one at a time from a shared atomic counter, so a few
+ * slow items do not leave the other threads idle. The calling thread works
+ * alongside a private QThreadPool instead of blocking in waitForDone(), and
+ * everything has finished when the call returns.
+ */
+class XngineParallel
+{
+public:
+  // Calls fn(index) once for every index in [0, count) on up to maxThreads threads
+  // (0 = QThread::idealThreadCount(), never more than count). fn may run
+  // concurrently with itself: it should write only to state owned by its index, or
+  // guard shared state itself. To stop early, have fn return at once after a flag
+  // is set; the remaining indices are still handed out, but they cost nothing.
+  static void parallelFor(int count, const std::function<void(int)>& fn, int maxThreads = 0);
+};
+
+#endif  // XNGINEPARALLEL_H
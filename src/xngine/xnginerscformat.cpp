@@ -5,6 +5,7 @@
 
 #include <algorithm>
 #include <cstring>
+#include <utility>
 
 namespace {
 
@@ -56,12 +57,8 @@ QVector<quint32> sortedUniqueOffsets(const QVector<quint32>& offsets)
 
 qsizetype nextOffsetEnd(quint32 start, const QVector<quint32>& sortedOffsets, qsizetype fileSize)
 {
-  for (quint32 o : sortedOffsets) {
-    if (o > start) {
-      return static_cast<qsizetype>(o);
-    }
-  }
-  return fileSize;
+  const auto it = std::upper_bound(sortedOffsets.cbegin(), sortedOffsets.cend(), start);
+  return it != sortedOffsets.cend() ? static_cast<qsizetype>(*it) : fileSize;
 }
 
 XngineRscFormat::Variant detectVariant(const QByteArray& bytes)
@@ -174,23 +171,98 @@ XngineRscFormat::tokenizeTextSubrecord(const QByteArray& bytes)
   return out;
 }
 
-QString XngineRscFormat::decodeTextSubrecordText(const QByteArray& bytes)
+QVector<XngineRscFormat::TextTokenSpan>
+XngineRscFormat::tokenizeTextSubrecordSpans(QByteArrayView bytes)
+{
+  // Same grammar as tokenizeTextSubrecord, but tokens only record where they are.
+  QVector<TextTokenSpan> out;
+  const auto* data = reinterpret_cast<const quint8*>(bytes.data());
+  const qsizetype size = bytes.size();
+  auto push = [&out](TextTokenType type, qsizetype offset, qsizetype length) {
+    out.push_back({type, static_cast<qint32>(offset), static_cast<qint32>(length)});
+  };
+  auto isPrintable = [](quint8 b) {
+    return b >= 0x20 && b <= 0x7F;
+  };
+
+  for (qsizetype i = 0; i < size; ++i) {
+    const quint8 b = data[i];
+
+    if ((b == 0xFC || b == 0xFD) && i + 1 < size && data[i + 1] == 0x00) {
+      push(TextTokenType::EndOfLine, i, 2);
+      ++i;
+      continue;
+    }
+
+    if (b == 0xF9 || b == 0xFA) {
+      const qsizetype length = (i + 1 < size) ? 2 : 1;
+      push(b == 0xF9 ? TextTokenType::FontCode : TextTokenType::FontColor, i, length);
+      i += length - 1;
+      continue;
+    }
+
+    if (b == 0xFB && i >= 1 && i + 2 < size) {
+      push(TextTokenType::PositionCode, i - 1, 4);
+      i += 2;
+      continue;
+    }
+
+    if (b == 0xF7) {
+      qsizetype j = i + 1;
+      while (j < size && data[j] != 0x00) {
+        ++j;
+      }
+      if (j < size) {
+        ++j;
+      }
+      push(TextTokenType::BookImage, i, j - i);
+      i = j - 1;
+      continue;
+    }
+
+    if (b == 0xF6) {
+      push(TextTokenType::EndOfPage, i, 1);
+      continue;
+    }
+
+    if (isPrintable(b)) {
+      qsizetype j = i + 1;
+      while (j < size && isPrintable(data[j])) {
+        ++j;
+      }
+      push(TextTokenType::Printable, i, j - i);
+      i = j - 1;
+      continue;
+    }
+
+    push(TextTokenType::RawControl, i, 1);
+  }
+
+  return out;
+}
+
+QString XngineRscFormat::decodeTextTokens(QByteArrayView bytes,
+                                          const QVector<TextTokenSpan>& tokens)
 {
   QString out;
   out.reserve(bytes.size());
 
-  const QVector<TextToken> tokens = tokenizeTextSubrecord(bytes);
+  const char* data = bytes.data();
   for (const auto& t : tokens) {
+    if (t.offset < 0 || t.length <= 0 ||
+        static_cast<qsizetype>(t.offset) + t.length > bytes.size()) {
+      continue;
+    }
     switch (t.type) {
       case TextTokenType::Printable:
-        out.append(QChar::fromLatin1(t.bytes.at(0)));
+        out.append(QLatin1String(data + t.offset, t.length));
         break;
       case TextTokenType::EndOfLine:
       case TextTokenType::EndOfPage:
         out.append('\n');
         break;
       default:
-        if (!t.bytes.isEmpty() && static_cast<quint8>(t.bytes.at(0)) == 0x00) {
+        if (data[t.offset] == '\0') {
           out.append('\n');
         }
         break;
@@ -200,45 +272,44 @@ QString XngineRscFormat::decodeTextSubrecordText(const QByteArray& bytes)
   return out;
 }
 
+QString XngineRscFormat::decodeTextSubrecordText(const QByteArray& bytes)
+{
+  return decodeTextTokens(bytes, tokenizeTextSubrecordSpans(bytes));
+}
+
 bool XngineRscFormat::parseTextRecord(const QByteArray& bytes, TextRecord& outRecord,
                                       QString* errorMessage)
 {
   outRecord = {};
   outRecord.raw = bytes;
 
-  QByteArray current;
+  // Each subrecord is tokenized once; its text is decoded from those spans.
+  auto addSubrecord = [&outRecord](QByteArray raw) {
+    TextSubrecord s;
+    s.raw = std::move(raw);
+    s.tokens = tokenizeTextSubrecordSpans(s.raw);
+    s.text = decodeTextTokens(s.raw, s.tokens);
+    outRecord.subrecords.push_back(std::move(s));
+  };
+
+  qsizetype start = 0;
   bool sawEnd = false;
-  for (char c : bytes) {
-    const quint8 b = static_cast<quint8>(c);
+  for (qsizetype i = 0; i < bytes.size(); ++i) {
+    const quint8 b = static_cast<quint8>(bytes.at(i));
     if (b == 0xFE) {
-      TextSubrecord s;
-      s.raw = current;
-      s.tokens = tokenizeTextSubrecord(current);
-      s.text = decodeTextSubrecordText(current);
-      outRecord.subrecords.push_back(s);
-      current.clear();
+      addSubrecord(bytes.mid(start, i - start));
       sawEnd = true;
       break;
     }
     if (b == 0xFF) {
-      TextSubrecord s;
-      s.raw = current;
-      s.tokens = tokenizeTextSubrecord(current);
-      s.text = decodeTextSubrecordText(current);
-      outRecord.subrecords.push_back(s);
-      current.clear();
-      continue;
+      addSubrecord(bytes.mid(start, i - start));
+      start = i + 1;
     }
-    current.push_back(c);
   }
 
   if (!sawEnd) {
-    if (!current.isEmpty()) {
-      TextSubrecord s;
-      s.raw = current;
-      s.tokens = tokenizeTextSubrecord(current);
-      s.text = decodeTextSubrecordText(current);
-      outRecord.subrecords.push_back(s);
+    if (start < bytes.size()) {
+      addSubrecord(bytes.mid(start));
     }
     appendWarning(outRecord.warning, "Record does not contain 0xFE terminator");
   }
@@ -249,11 +320,12 @@ bool XngineRscFormat::parseTextRecord(const QByteArray& bytes, TextRecord& outRe
   return true;
 }
 
-bool XngineRscFormat::parseTextRecordDatabase(const QByteArray& bytes, TextRecordDatabase& outDb,
-                                              QString* errorMessage, bool strictValidation)
+bool XngineRscFormat::parseTextRecordIndex(const QByteArray& bytes, TextRecordDatabase& outDb,
+                                           QVector<TextRecordSlice>& outSlices,
+                                           QString* errorMessage)
 {
-  Q_UNUSED(strictValidation);
   outDb = {};
+  outSlices.clear();
   if (bytes.size() < 8) {
     return setError(errorMessage, "Text record database is too small");
   }
@@ -319,30 +391,46 @@ bool XngineRscFormat::parseTextRecordDatabase(const QByteArray& bytes, TextRecor
   offsets.push_back(outDb.sentinelHeader.offset);
   const QVector<quint32> sortedOffsets = sortedUniqueOffsets(offsets);
 
-  outDb.records.reserve(outDb.headers.size());
+  const char* data = bytes.constData();
+  outSlices.reserve(outDb.headers.size());
   for (int i = 0; i < outDb.headers.size(); ++i) {
     const auto& h = outDb.headers.at(i);
+    const qsizetype start = static_cast<qsizetype>(h.offset);
     const qsizetype end = nextOffsetEnd(h.offset, sortedOffsets, bytes.size());
-    if (end <= static_cast<qsizetype>(h.offset)) {
+    if (end <= start) {
       continue;
     }
 
-    QByteArray raw = bytes.mid(static_cast<qsizetype>(h.offset),
-                               end - static_cast<qsizetype>(h.offset));
-    const int recordEnd = raw.indexOf(static_cast<char>(0xFE));
-    if (recordEnd >= 0) {
-      raw.truncate(recordEnd + 1);
-    }
+    const void* terminator = std::memchr(data + start, 0xFE, static_cast<size_t>(end - start));
+    const qsizetype length =
+        terminator != nullptr ? static_cast<const char*>(terminator) - (data + start) + 1
+                              : end - start;
+    outSlices.push_back({h.id, h.offset, static_cast<qint32>(length), i});
+  }
+
+  return true;
+}
+
+bool XngineRscFormat::parseTextRecordDatabase(const QByteArray& bytes, TextRecordDatabase& outDb,
+                                              QString* errorMessage, bool strictValidation)
+{
+  Q_UNUSED(strictValidation);
+  QVector<TextRecordSlice> slices;
+  if (!parseTextRecordIndex(bytes, outDb, slices, errorMessage)) {
+    return false;
+  }
 
+  outDb.records.reserve(slices.size());
+  for (const auto& slice : slices) {
     TextRecord record;
     QString parseErr;
-    if (!parseTextRecord(raw, record, &parseErr)) {
+    if (!parseTextRecord(bytes.mid(slice.offset, slice.length), record, &parseErr)) {
       appendWarning(outDb.warning,
-                    QString("Record %1 parse warning: %2").arg(i).arg(parseErr));
+                    QString("Record %1 parse warning: %2").arg(slice.headerIndex).arg(parseErr));
       continue;
     }
-    record.id = h.id;
-    record.offset = h.offset;
+    record.id = slice.id;
+    record.offset = slice.offset;
     outDb.records.push_back(record);
   }
 
@@ -2,6 +2,7 @@
 #define XNGINERSCFORMAT_H
 
 #include <QByteArray>
+#include <QByteArrayView>
 #include <QString>
 #include <QStringList>
 #include <QVector>
@@ -34,17 +35,29 @@ public:
     RawControl
   };
 
+  // One token per byte for printable text, each owning its bytes. Kept for
+  // callers of tokenizeTextSubrecord; parsing uses TextTokenSpan.
   struct TextToken
   {
     TextTokenType type = TextTokenType::RawControl;
     QByteArray bytes;
   };
 
+  // Token as a span of the subrecord bytes. Consecutive printable bytes form one
+  // span. A PositionCode span starts at the byte before FB, which also belongs to
+  // the preceding token.
+  struct TextTokenSpan
+  {
+    TextTokenType type = TextTokenType::RawControl;
+    qint32 offset = 0;
+    qint32 length = 0;
+  };
+
   struct TextSubrecord
   {
     QByteArray raw;
     QString text;
-    QVector<TextToken> tokens;
+    QVector<TextTokenSpan> tokens;  // spans of raw
   };
 
   struct TextRecord
@@ -73,6 +86,15 @@ public:
     QString warning;
   };
 
+  // Where a record's bytes sit in the database, up to and including its 0xFE.
+  struct TextRecordSlice
+  {
+    quint16 id = 0xFFFF;
+    quint32 offset = 0;
+    qint32 length = 0;
+    int headerIndex = -1;  // position in TextRecordDatabase::headers
+  };
+
   struct Document
   {
     Variant variant = Variant::Auto;
@@ -91,12 +113,20 @@ public:
   static bool parseTextRecordDatabase(const QByteArray& bytes, TextRecordDatabase& outDb,
                                       QString* errorMessage = nullptr,
                                       bool strictValidation = true);
+  // Header table and record slices only; records stays empty. Pair with
+  // parseTextRecord on bytes.mid(slice.offset, slice.length) to decode on demand.
+  static bool parseTextRecordIndex(const QByteArray& bytes, TextRecordDatabase& outDb,
+                                   QVector<TextRecordSlice>& outSlices,
+                                   QString* errorMessage = nullptr);
   static bool writeTextRecordDatabase(const TextRecordDatabase& db, QByteArray& outBytes,
                                       QString* errorMessage = nullptr);
   static bool parseTextRecord(const QByteArray& bytes, TextRecord& outRecord,
                               QString* errorMessage = nullptr);
 
   static QVector<TextToken> tokenizeTextSubrecord(const QByteArray& bytes);
+  static QVector<TextTokenSpan> tokenizeTextSubrecordSpans(QByteArrayView bytes);
+  // Text of a subrecord from its spans, so parsing tokenizes each subrecord once.
+  static QString decodeTextTokens(QByteArrayView bytes, const QVector<TextTokenSpan>& tokens);
   static QString decodeTextSubrecordText(const QByteArray& bytes);
 };
 
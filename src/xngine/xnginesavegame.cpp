@@ -1,8 +1,10 @@
 #include "xnginesavegame.h"
 
+#ifndef XNGINE_HEADLESS
 #include "iplugingame.h"
 #include "log.h"
 #include "scriptextender.h"
+#endif
 
 #include <QDate>
 #include <QDir>
@@ -11,15 +13,21 @@
 #include <QScopedArrayPointer>
 #include <QTime>
 
+#ifdef Q_OS_WIN
 #include <Windows.h>
+#endif
 #include <lz4.h>
 #include <zlib.h>
 
+#include <algorithm>
+#include <climits>
 #include <stdexcept>
 #include <vector>
 
+#ifndef XNGINE_HEADLESS
 #include "gamexngine.h"
 #include "imoinfo.h"
+#endif
 
 #define CHUNK 16384
 
@@ -112,6 +120,7 @@ QStringList XngineSaveGame::allFiles() const
 
   // This returns all valid files associated with this game
   QStringList res = {m_FileName};
+#ifndef XNGINE_HEADLESS
   auto e = m_Game->m_Organizer->gameFeatures()->gameFeature<MOBase::ScriptExtender>();
   if (e != nullptr) {
     QFileInfo file(m_FileName);
@@ -121,9 +130,22 @@ QStringList XngineSaveGame::allFiles() const
       res.push_back(SEfile.absoluteFilePath());
     }
   }
+#endif
   return res;
 }
 
+XngineSaveGame::Metadata XngineSaveGame::metadata() const
+{
+  Metadata meta;
+  meta.filePath      = m_FileName;
+  meta.characterName = m_PCName;
+  meta.level         = m_PCLevel;
+  meta.location      = m_PCLocation;
+  meta.saveNumber    = m_SaveNumber;
+  meta.creationTime  = m_CreationTime;
+  return meta;
+}
+
 bool XngineSaveGame::hasScriptExtenderFile() const
 {
   QFileInfo file(m_FileName);
@@ -132,6 +154,7 @@ bool XngineSaveGame::hasScriptExtenderFile() const
   return SEfile.exists();
 }
 
+#ifdef Q_OS_WIN
 void XngineSaveGame::setCreationTime(_SYSTEMTIME const& ctime)
 {
   QDate date;
@@ -141,20 +164,23 @@ void XngineSaveGame::setCreationTime(_SYSTEMTIME const& ctime)
 
   m_CreationTime = QDateTime(date, time, Qt::UTC);
 }
+#endif
 
 XngineSaveGame::FileWrapper::FileWrapper(QString const& filepath,
                                          QString const& expected)
-    : m_File(filepath), m_HasFieldMarkers(false),
+    : m_View(filepath), m_HasFieldMarkers(false),
       m_PluginString(StringType::TYPE_WSTRING),
       m_PluginStringFormat(StringFormat::UTF8), m_NextChunk(0)
 {
-  if (!m_File.open(QIODevice::ReadOnly)) {
+  if (!m_View.isOpen()) {
     throw std::runtime_error(
         QObject::tr("failed to open %1").arg(filepath).toUtf8().constData());
   }
+  m_Cursor = m_View.cursor();
 
   std::vector<char> fileID(expected.length() + 1);
-  m_File.read(fileID.data(), expected.length());
+  m_Cursor.readBytes(fileID.data(),
+                     std::min<qsizetype>(expected.length(), m_Cursor.remaining()));
   fileID[expected.length()] = '\0';
 
   QString id(fileID.data());
@@ -300,8 +326,7 @@ void XngineSaveGame::FileWrapper::read<QString>(QString& value)
 
 void XngineSaveGame::FileWrapper::read(void* buff, std::size_t length)
 {
-  int read = m_File.read(static_cast<char*>(buff), length);
-  if (read != length) {
+  if (!m_Cursor.readBytes(buff, static_cast<qsizetype>(length))) {
     throw std::runtime_error("unexpected end of file");
   }
 }
@@ -397,8 +422,6 @@ bool XngineSaveGame::FileWrapper::openCompressedData(int bytesToIgnore)
 bool XngineSaveGame::FileWrapper::readNextChunk()
 {
   uint32_t have;
-  uint64_t read                     = 0;
-  std::unique_ptr<char[]> inBuffer  = std::make_unique<char[]>(CHUNK);
   std::unique_ptr<char[]> outBuffer = std::make_unique<char[]>(CHUNK);
   QByteArray finalData;
   m_Data->device()->close();
@@ -410,36 +433,33 @@ bool XngineSaveGame::FileWrapper::readNextChunk()
     stream.opaque   = Z_NULL;
     stream.avail_in = 0;
     stream.next_in  = Z_NULL;
-    if (m_NextChunk >= m_File.size() || finalData.size() == m_UncompressedSize)
+    if (m_NextChunk >= static_cast<uint64_t>(m_View.size()) ||
+        finalData.size() == m_UncompressedSize)
       return false;
-    m_File.seek(m_NextChunk);
     int zlibRet = inflateInit2(&stream, 15 + 32);
     if (zlibRet != Z_OK) {
       return false;
     }
+    // The whole compressed tail is already mapped; inflate straight from it instead
+    // of staging CHUNK-sized reads through an input buffer.
+    const uint64_t available = static_cast<uint64_t>(m_View.size()) - m_NextChunk;
+    stream.next_in  = const_cast<Bytef*>(m_View.data() + m_NextChunk);
+    stream.avail_in = static_cast<uInt>(std::min<uint64_t>(available, UINT_MAX));
     do {
-      stream.avail_in = m_File.read(inBuffer.get(), CHUNK);
-      read += stream.avail_in;
-      if (!m_File.isReadable()) {
+      stream.avail_out = CHUNK;
+      stream.next_out  = reinterpret_cast<Bytef*>(outBuffer.get());
+      zlibRet          = inflate(&stream, Z_NO_FLUSH);
+      if ((zlibRet != Z_OK) && (zlibRet != Z_STREAM_END) && (zlibRet != Z_BUF_ERROR)) {
         (void)inflateEnd(&stream);
         return false;
       }
-      if (stream.avail_in == 0)
+      have = CHUNK - stream.avail_out;
+      if (have == 0 && zlibRet == Z_BUF_ERROR) {
         break;
-      stream.next_in = reinterpret_cast<Bytef*>(inBuffer.get());
-      do {
-        stream.avail_out = CHUNK;
-        stream.next_out  = reinterpret_cast<Bytef*>(outBuffer.get());
-        zlibRet          = inflate(&stream, Z_NO_FLUSH);
-        if ((zlibRet != Z_OK) && (zlibRet != Z_STREAM_END) &&
-            (zlibRet != Z_BUF_ERROR)) {
-          return false;
-        }
-        have = CHUNK - stream.avail_out;
-        finalData += QByteArray::fromRawData(outBuffer.get(), have);
-      } while (stream.avail_out == 0);
-      read -= stream.avail_in;
+      }
+      finalData += QByteArray::fromRawData(outBuffer.get(), have);
     } while (zlibRet != Z_STREAM_END);
+    const uint64_t read = stream.total_in;
     inflateEnd(&stream);
     uint64_t remainder = (m_NextChunk + read) % 16;
     uint64_t next      = m_NextChunk + read + 16 - (remainder == 0 ? 16 : remainder);
@@ -652,7 +672,8 @@ QStringList XngineSaveGame::FileWrapper::readPluginData(uint32_t count, int extr
 
 void XngineSaveGame::FileWrapper::close()
 {
-  m_File.close();
+  m_Cursor = {};
+  m_View.close();
 }
 
 
@@ -1,8 +1,13 @@
 #ifndef XNGINESAVEGAME_H
 #define XNGINESAVEGAME_H
 
+#ifdef XNGINE_HEADLESS
+#include "xngineheadless.h"
+#else
 #include "isavegame.h"
 #include "memoizedlock.h"
+#endif
+#include "xnginesaveview.h"
 
 #include <QDateTime>
 #include <QFile>
@@ -10,10 +15,13 @@
 #include <QString>
 #include <QStringList>
 
+#include <optional>
 #include <stddef.h>
 #include <stdexcept>
 
+#ifdef Q_OS_WIN
 struct _SYSTEMTIME;
+#endif
 
 namespace MOBase
 {
@@ -47,6 +55,24 @@ public:
   virtual unsigned long getSaveNumber() const { return m_SaveNumber; }
   virtual QString getGameDetails() const { return {}; }
 
+  // Parsed header fields, detached from the save object so they can be indexed.
+  struct Metadata
+  {
+    QString filePath;
+    QString characterName;
+    unsigned short level = 0;
+    QString location;
+    QString region;
+    QString inGameDate;
+    quint64 inGameMinutes = 0;  // sortable in-game clock, 0 when unknown
+    std::optional<quint32> gold;  // unset when the save does not carry it or is cut short
+    unsigned long saveNumber = 0;
+    QDateTime creationTime;
+  };
+
+  // Subclasses fill in the game-specific fields (region, date, gold).
+  virtual Metadata metadata() const;
+
   QStringList const& getPlugins() const { return m_DataFields.value()->Plugins; }
   QStringList const& getMediumPlugins() const
   {
@@ -106,7 +132,7 @@ protected:
     template <typename T>
     void skip(int count = 1)
     {
-      if (!m_File.seek(m_File.pos() + count * sizeof(T))) {
+      if (!m_Cursor.skip(count * static_cast<qsizetype>(sizeof(T)))) {
         throw std::runtime_error("unexpected end of file");
       }
     }
@@ -114,8 +140,7 @@ protected:
     template <typename T>
     void read(T& value)
     {
-      int read = m_File.read(reinterpret_cast<char*>(&value), sizeof(T));
-      if (read != sizeof(T)) {
+      if (!m_Cursor.readBytes(&value, static_cast<qsizetype>(sizeof(T)))) {
         throw std::runtime_error("unexpected end of file");
       }
       if (m_HasFieldMarkers) {
@@ -123,12 +148,9 @@ protected:
       }
     }
 
-    template <>
-    void read<QString>(QString& value);
-
     void seek(unsigned long pos)
     {
-      if (!m_File.seek(pos)) {
+      if (!m_Cursor.seek(static_cast<qsizetype>(pos))) {
         throw std::runtime_error("unexpected end of file");
       }
     }
@@ -182,7 +204,8 @@ protected:
     void close();
 
   private:
-    QFile m_File;
+    XngineSaveView m_View;
+    XngineSaveView::Cursor m_Cursor;
     uint64_t m_NextChunk;
     uint64_t m_UncompressedSize;
     bool m_HasFieldMarkers;
@@ -203,7 +226,9 @@ protected:
                                const QStringList corePlugins);
   };
 
+#ifdef Q_OS_WIN
   void setCreationTime(_SYSTEMTIME const& time);
+#endif
 
   GameXngine const* m_Game;
   bool m_MediumEnabled;
@@ -241,4 +266,8 @@ protected:
   }
 };
 
+// Declared at namespace scope; in-class explicit specializations are an MSVC extension.
+template <>
+void XngineSaveGame::FileWrapper::read<QString>(QString& value);
+
 #endif  // XNGINESAVEGAME_H
@@ -2,10 +2,18 @@
 
 #include "xnginesavegameinfowidget.h"
 
-XngineSaveGameInfo::XngineSaveGameInfo(GameXngine const* game) : m_Game(game) {}
+XngineSaveGameInfo::XngineSaveGameInfo(GameXngine const* game)
+    : m_Game(game), m_SaveIndex(std::make_shared<XngineSaveIndex>())
+{}
 
 XngineSaveGameInfo::~XngineSaveGameInfo() {}
 
+void XngineSaveGameInfo::refreshSaveIndex(
+    const std::vector<std::shared_ptr<const MOBase::ISaveGame>>& saves) const
+{
+  m_SaveIndex->refresh(saves);
+}
+
 XngineSaveGameInfo::MissingAssets
 XngineSaveGameInfo::getMissingAssets(MOBase::ISaveGame const&) const
 {
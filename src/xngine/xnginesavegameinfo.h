@@ -2,6 +2,10 @@
 #define XGINESAVEGAMEINFO_H
 
 #include "savegameinfo.h"
+#include "xnginesaveindex.h"
+
+#include <memory>
+#include <vector>
 
 class GameXngine;
 
@@ -15,9 +19,15 @@ public:
 
   virtual MOBase::ISaveGameInfoWidget* getSaveGameWidget(QWidget*) const override;
 
+  // Metadata of the saves returned by the last listSaves() call.
+  const XngineSaveIndex& saveIndex() const { return *m_SaveIndex; }
+  // Called by GameXngine::listSaves(); the index guards itself with its own mutex.
+  void refreshSaveIndex(const std::vector<std::shared_ptr<const MOBase::ISaveGame>>& saves) const;
+
 protected:
   friend class XngineSaveGameInfoWidget;
   GameXngine const* m_Game;
+  std::shared_ptr<XngineSaveIndex> m_SaveIndex;
 };
 
 #endif  // XGINESAVEGAMEINFO_H
@@ -0,0 +1,289 @@
+#include "xnginesaveindex.h"
+
+#include <QMutexLocker>
+
+#include <algorithm>
+#include <numeric>
+
+void XngineSaveIndex::refresh(
+    const std::vector<std::shared_ptr<const MOBase::ISaveGame>>& saves)
+{
+  std::vector<Metadata> entries;
+  entries.reserve(saves.size());
+  for (const auto& save : saves) {
+    const auto* xngineSave = dynamic_cast<const XngineSaveGame*>(save.get());
+    if (xngineSave != nullptr) {
+      entries.push_back(xngineSave->metadata());
+    }
+  }
+
+  QMutexLocker lock(&m_Mutex);
+  m_Entries = std::move(entries);
+  m_ByPath.clear();
+  m_ByPath.reserve(static_cast<qsizetype>(m_Entries.size()));
+  for (int i = 0; i < static_cast<int>(m_Entries.size()); ++i) {
+    m_ByPath.insert(foldKey(m_Entries[static_cast<size_t>(i)].filePath), i);
+  }
+  invalidateLocked();
+}
+
+void XngineSaveIndex::insert(const Metadata& entry)
+{
+  QMutexLocker lock(&m_Mutex);
+  const QString key = foldKey(entry.filePath);
+  const auto it     = m_ByPath.constFind(key);
+  if (it != m_ByPath.constEnd()) {
+    m_Entries[static_cast<size_t>(it.value())] = entry;
+  } else {
+    m_ByPath.insert(key, static_cast<int>(m_Entries.size()));
+    m_Entries.push_back(entry);
+  }
+  invalidateLocked();
+}
+
+bool XngineSaveIndex::remove(const QString& filePath)
+{
+  QMutexLocker lock(&m_Mutex);
+  const auto it = m_ByPath.constFind(foldKey(filePath));
+  if (it == m_ByPath.constEnd()) {
+    return false;
+  }
+
+  // Swap-remove keeps the removal O(1); only the moved entry needs re-pointing.
+  const int index = it.value();
+  const int last  = static_cast<int>(m_Entries.size()) - 1;
+  m_ByPath.erase(it);
+  if (index != last) {
+    m_Entries[static_cast<size_t>(index)] = std::move(m_Entries.back());
+    m_ByPath.insert(foldKey(m_Entries[static_cast<size_t>(index)].filePath), index);
+  }
+  m_Entries.pop_back();
+  invalidateLocked();
+  return true;
+}
+
+void XngineSaveIndex::clear()
+{
+  QMutexLocker lock(&m_Mutex);
+  m_Entries.clear();
+  m_ByPath.clear();
+  invalidateLocked();
+}
+
+qsizetype XngineSaveIndex::size() const
+{
+  QMutexLocker lock(&m_Mutex);
+  return static_cast<qsizetype>(m_Entries.size());
+}
+
+std::optional<XngineSaveIndex::Metadata> XngineSaveIndex::find(const QString& filePath) const
+{
+  QMutexLocker lock(&m_Mutex);
+  const auto it = m_ByPath.constFind(foldKey(filePath));
+  if (it == m_ByPath.constEnd()) {
+    return std::nullopt;
+  }
+  return m_Entries[static_cast<size_t>(it.value())];
+}
+
+std::vector<XngineSaveIndex::Metadata> XngineSaveIndex::query(const Query& query) const
+{
+  QMutexLocker lock(&m_Mutex);
+  std::vector<Metadata> results;
+  if (query.limit == 0) {
+    return results;
+  }
+
+  qsizetype toSkip = std::max<qsizetype>(0, query.offset);
+  auto accept = [&](int index) {
+    const Metadata& entry = m_Entries[static_cast<size_t>(index)];
+    if (!matches(entry, query)) {
+      return true;
+    }
+    if (toSkip > 0) {
+      --toSkip;
+      return true;
+    }
+    results.push_back(entry);
+    return query.limit < 0 || static_cast<qsizetype>(results.size()) < query.limit;
+  };
+
+  // Narrow through the smallest exact-match bucket; its per-key order is cached
+  // alongside the index-wide one.
+  Bucket* bucket = nullptr;
+  if (!query.characterName.isEmpty() || !query.region.isEmpty()) {
+    ensureBucketsLocked();
+    auto lookup = [](QHash<QString, Bucket>& buckets, const QString& value) -> Bucket* {
+      const auto it = buckets.find(foldKey(value));
+      return it != buckets.end() ? &it.value() : nullptr;
+    };
+    Bucket* characterBucket =
+        query.characterName.isEmpty() ? nullptr : lookup(m_ByCharacter, query.characterName);
+    Bucket* regionBucket = query.region.isEmpty() ? nullptr : lookup(m_ByRegion, query.region);
+    if ((!query.characterName.isEmpty() && characterBucket == nullptr) ||
+        (!query.region.isEmpty() && regionBucket == nullptr)) {
+      return results;
+    }
+    bucket = characterBucket;
+    if (bucket == nullptr ||
+        (regionBucket != nullptr && regionBucket->members.size() < bucket->members.size())) {
+      bucket = regionBucket;
+    }
+  }
+
+  const auto& order = bucket != nullptr ? sortedBucketLocked(*bucket, query.sortKey)
+                                        : sortedOrderLocked(query.sortKey);
+  if (query.descending) {
+    for (auto it = order.crbegin(); it != order.crend(); ++it) {
+      if (!accept(*it)) {
+        break;
+      }
+    }
+  } else {
+    for (const int index : order) {
+      if (!accept(index)) {
+        break;
+      }
+    }
+  }
+  return results;
+}
+
+QStringList XngineSaveIndex::characterNames() const
+{
+  QMutexLocker lock(&m_Mutex);
+  ensureBucketsLocked();
+  QStringList names;
+  names.reserve(m_ByCharacter.size());
+  for (auto it = m_ByCharacter.cbegin(); it != m_ByCharacter.cend(); ++it) {
+    names.push_back(m_Entries[static_cast<size_t>(it.value().members.front())].characterName);
+  }
+  names.sort(Qt::CaseInsensitive);
+  return names;
+}
+
+QStringList XngineSaveIndex::regions() const
+{
+  QMutexLocker lock(&m_Mutex);
+  ensureBucketsLocked();
+  QStringList names;
+  names.reserve(m_ByRegion.size());
+  for (auto it = m_ByRegion.cbegin(); it != m_ByRegion.cend(); ++it) {
+    names.push_back(m_Entries[static_cast<size_t>(it.value().members.front())].region);
+  }
+  names.sort(Qt::CaseInsensitive);
+  return names;
+}
+
+QString XngineSaveIndex::foldKey(const QString& value)
+{
+  return value.trimmed().toCaseFolded();
+}
+
+bool XngineSaveIndex::lessThan(const Metadata& a, const Metadata& b, SortKey key)
+{
+  switch (key) {
+  case SortKey::SaveNumber:
+    return a.saveNumber < b.saveNumber;
+  case SortKey::CharacterName:
+    return a.characterName.compare(b.characterName, Qt::CaseInsensitive) < 0;
+  case SortKey::Level:
+    return a.level < b.level;
+  case SortKey::Location:
+    return a.location.compare(b.location, Qt::CaseInsensitive) < 0;
+  case SortKey::Region:
+    return a.region.compare(b.region, Qt::CaseInsensitive) < 0;
+  case SortKey::InGameTime:
+    return a.inGameMinutes < b.inGameMinutes;
+  case SortKey::Gold:
+    return a.gold < b.gold;  // unknown gold sorts first
+  case SortKey::CreationTime:
+  default:
+    return a.creationTime < b.creationTime;
+  }
+}
+
+bool XngineSaveIndex::matches(const Metadata& entry, const Query& query) const
+{
+  if (!query.characterName.isEmpty() &&
+      entry.characterName.trimmed().compare(query.characterName.trimmed(),
+                                            Qt::CaseInsensitive) != 0) {
+    return false;
+  }
+  if (!query.region.isEmpty() &&
+      entry.region.trimmed().compare(query.region.trimmed(), Qt::CaseInsensitive) != 0) {
+    return false;
+  }
+  if (!query.locationContains.isEmpty() &&
+      !entry.location.contains(query.locationContains, Qt::CaseInsensitive)) {
+    return false;
+  }
+  if (query.minLevel && entry.level < *query.minLevel) {
+    return false;
+  }
+  if (query.maxLevel && entry.level > *query.maxLevel) {
+    return false;
+  }
+  if (query.minGold && (!entry.gold || *entry.gold < *query.minGold)) {
+    return false;
+  }
+  return true;
+}
+
+void XngineSaveIndex::sortLocked(std::vector<int>& order, SortKey key) const
+{
+  std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+    return lessThan(m_Entries[static_cast<size_t>(a)], m_Entries[static_cast<size_t>(b)], key);
+  });
+}
+
+const std::vector<int>& XngineSaveIndex::sortedOrderLocked(SortKey key) const
+{
+  const auto slot = static_cast<size_t>(key);
+  auto& order     = m_SortedOrders[slot];
+  if (!m_SortedValid[slot]) {
+    order.resize(m_Entries.size());
+    std::iota(order.begin(), order.end(), 0);
+    sortLocked(order, key);
+    m_SortedValid[slot] = true;
+  }
+  return order;
+}
+
+const std::vector<int>& XngineSaveIndex::sortedBucketLocked(Bucket& bucket, SortKey key) const
+{
+  const auto slot = static_cast<size_t>(key);
+  auto& order     = bucket.sortedOrders[slot];
+  if (!bucket.sortedValid[slot]) {
+    order = bucket.members;
+    sortLocked(order, key);
+    bucket.sortedValid[slot] = true;
+  }
+  return order;
+}
+
+void XngineSaveIndex::ensureBucketsLocked() const
+{
+  if (m_BucketsValid) {
+    return;
+  }
+
+  m_ByCharacter.clear();
+  m_ByRegion.clear();
+  for (int i = 0; i < static_cast<int>(m_Entries.size()); ++i) {
+    const Metadata& entry = m_Entries[static_cast<size_t>(i)];
+    if (!entry.characterName.trimmed().isEmpty()) {
+      m_ByCharacter[foldKey(entry.characterName)].members.push_back(i);
+    }
+    if (!entry.region.trimmed().isEmpty()) {
+      m_ByRegion[foldKey(entry.region)].members.push_back(i);
+    }
+  }
+  m_BucketsValid = true;
+}
+
+void XngineSaveIndex::invalidateLocked()
+{
+  m_SortedValid.fill(false);
+  m_BucketsValid = false;
+}
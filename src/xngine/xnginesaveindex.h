@@ -0,0 +1,113 @@
+#ifndef XNGINESAVEINDEX_H
+#define XNGINESAVEINDEX_H
+
+#include "xnginesavegame.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QtGlobal>
+
+#include <array>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace MOBase
+{
+class ISaveGame;
+}
+
+/**
+ * In-memory index over parsed save metadata.
+ *
+ * listSaves() refreshes it with the saves it has just parsed; consumers can then
+ * sort and filter large save libraries without re-instantiating XngineSaveGame
+ * objects. Per-key sort orders are built lazily and cached until the next
+ * change, both for the whole index and for each character/region hash bucket.
+ * A query with a character or region filter walks only its (pre-sorted) bucket;
+ * the remaining filters are tested entry by entry along the sorted order, so a
+ * query without a bucket filter may visit every entry before filling its page.
+ */
+class XngineSaveIndex
+{
+public:
+  using Metadata = XngineSaveGame::Metadata;
+
+  enum class SortKey
+  {
+    CreationTime,
+    SaveNumber,
+    CharacterName,
+    Level,
+    Location,
+    Region,
+    InGameTime,
+    Gold,
+    Count
+  };
+
+  struct Query
+  {
+    // Exact, case-insensitive matches; empty means "any".
+    QString characterName;
+    QString region;
+    // Case-insensitive substring match on location.
+    QString locationContains;
+    std::optional<unsigned short> minLevel;
+    std::optional<unsigned short> maxLevel;
+    std::optional<quint32> minGold;
+
+    SortKey sortKey  = SortKey::CreationTime;
+    bool descending  = true;
+    qsizetype offset = 0;
+    qsizetype limit  = -1;
+  };
+
+public:
+  void refresh(const std::vector<std::shared_ptr<const MOBase::ISaveGame>>& saves);
+  void insert(const Metadata& entry);
+  bool remove(const QString& filePath);
+  void clear();
+
+  qsizetype size() const;
+  std::optional<Metadata> find(const QString& filePath) const;
+  std::vector<Metadata> query(const Query& query) const;
+
+  // Distinct values, for populating filter pickers.
+  QStringList characterNames() const;
+  QStringList regions() const;
+
+private:
+  using SortedOrders = std::array<std::vector<int>, static_cast<size_t>(SortKey::Count)>;
+  using SortedValid  = std::array<bool, static_cast<size_t>(SortKey::Count)>;
+
+  struct Bucket
+  {
+    std::vector<int> members;
+    SortedOrders sortedOrders;
+    SortedValid sortedValid{};
+  };
+
+private:
+  static QString foldKey(const QString& value);
+  static bool lessThan(const Metadata& a, const Metadata& b, SortKey key);
+  bool matches(const Metadata& entry, const Query& query) const;
+  void sortLocked(std::vector<int>& order, SortKey key) const;
+  const std::vector<int>& sortedOrderLocked(SortKey key) const;
+  const std::vector<int>& sortedBucketLocked(Bucket& bucket, SortKey key) const;
+  void ensureBucketsLocked() const;
+  void invalidateLocked();
+
+private:
+  mutable QMutex m_Mutex;
+  std::vector<Metadata> m_Entries;
+  QHash<QString, int> m_ByPath;
+  mutable QHash<QString, Bucket> m_ByCharacter;
+  mutable QHash<QString, Bucket> m_ByRegion;
+  mutable bool m_BucketsValid = false;
+  mutable SortedOrders m_SortedOrders;
+  mutable SortedValid m_SortedValid{};
+};
+
+#endif  // XNGINESAVEINDEX_H
@@ -0,0 +1,139 @@
+#include "xnginesaveview.h"
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+
+namespace
+{
+std::atomic<quint64> g_ViewsOpened{0};
+std::atomic<quint64> g_BytesViewed{0};
+}  // namespace
+
+XngineSaveView::XngineSaveView(const QString& filePath)
+{
+  open(filePath);
+}
+
+XngineSaveView::XngineSaveView(XngineSaveView&& other) noexcept
+{
+  *this = std::move(other);
+}
+
+XngineSaveView& XngineSaveView::operator=(XngineSaveView&& other) noexcept
+{
+  if (this != &other) {
+    close();
+    // m_Data points into the mapping or into m_Buffer's storage, both of which move
+    // with the object.
+    m_File   = std::move(other.m_File);
+    m_Mapped = std::exchange(other.m_Mapped, nullptr);
+    m_Buffer = std::move(other.m_Buffer);
+    m_Data   = std::exchange(other.m_Data, nullptr);
+    m_Size   = std::exchange(other.m_Size, 0);
+    m_Open   = std::exchange(other.m_Open, false);
+    other.m_Buffer.clear();
+  }
+  return *this;
+}
+
+XngineSaveView::~XngineSaveView()
+{
+  close();
+}
+
+bool XngineSaveView::open(const QString& filePath)
+{
+  close();
+
+  m_File = std::make_unique<QFile>(filePath);
+  if (!m_File->open(QIODevice::ReadOnly)) {
+    m_File.reset();
+    return false;
+  }
+
+  m_Open = true;
+  g_ViewsOpened.fetch_add(1, std::memory_order_relaxed);
+  const qint64 fileSize = m_File->size();
+  if (fileSize <= 0) {
+    m_File.reset();
+    return true;
+  }
+
+  m_Mapped = m_File->map(0, fileSize);
+  if (m_Mapped != nullptr) {
+    m_Data = m_Mapped;
+    m_Size = static_cast<qsizetype>(fileSize);
+    g_BytesViewed.fetch_add(static_cast<quint64>(m_Size), std::memory_order_relaxed);
+    return true;
+  }
+
+  // Mapping can fail on some network shares; fall back to a single read.
+  m_Buffer = m_File->readAll();
+  m_File.reset();
+  m_Data = reinterpret_cast<const uchar*>(m_Buffer.constData());
+  m_Size = m_Buffer.size();
+  g_BytesViewed.fetch_add(static_cast<quint64>(m_Size), std::memory_order_relaxed);
+  return true;
+}
+
+void XngineSaveView::close()
+{
+  if (m_File && m_Mapped != nullptr) {
+    m_File->unmap(m_Mapped);
+  }
+  m_File.reset();
+  m_Mapped = nullptr;
+  m_Buffer.clear();
+  m_Data = nullptr;
+  m_Size = 0;
+  m_Open = false;
+}
+
+QByteArray XngineSaveView::bytes() const
+{
+  return bytes(0, m_Size);
+}
+
+QByteArray XngineSaveView::bytes(qsizetype offset, qsizetype length) const
+{
+  if (!hasBytes(offset, length) || length == 0) {
+    return {};
+  }
+  return QByteArray::fromRawData(reinterpret_cast<const char*>(m_Data + offset), length);
+}
+
+QString XngineSaveView::readFixedString(qsizetype offset, qsizetype size) const
+{
+  if (size <= 0 || !hasBytes(offset, size)) {
+    return {};
+  }
+
+  const auto* begin = reinterpret_cast<const char*>(m_Data + offset);
+  const auto* nul   = static_cast<const char*>(std::memchr(begin, '\0', size));
+  const qsizetype length = nul != nullptr ? static_cast<qsizetype>(nul - begin) : size;
+  return QString::fromLocal8Bit(begin, length).trimmed();
+}
+
+bool XngineSaveView::allZero() const
+{
+  return std::all_of(m_Data, m_Data + m_Size, [](uchar c) {
+    return c == 0;
+  });
+}
+
+quint64 XngineSaveView::totalViewsOpened()
+{
+  return g_ViewsOpened.load(std::memory_order_relaxed);
+}
+
+quint64 XngineSaveView::totalBytesViewed()
+{
+  return g_BytesViewed.load(std::memory_order_relaxed);
+}
+
+void XngineSaveView::resetTotals()
+{
+  g_ViewsOpened.store(0, std::memory_order_relaxed);
+  g_BytesViewed.store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,171 @@
+#ifndef XNGINESAVEVIEW_H
+#define XNGINESAVEVIEW_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QtEndian>
+#include <QtGlobal>
+
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+/**
+ * Read-only view over a save file shared by all XnGine save parsers.
+ *
+ * The file is memory-mapped where possible (falling back to a single buffered
+ * read), so parsers index directly into the file contents instead of copying
+ * them into per-parser QByteArrays. All typed readers are little-endian and
+ * bounds-checked; they return false instead of throwing, matching the
+ * "best effort" style of the save metadata parsers.
+ *
+ * The mapping is released when the view is destroyed. Keep views scoped to a
+ * parse pass so the game can still overwrite the save while MO2 is running.
+ */
+class XngineSaveView
+{
+public:
+  class Cursor
+  {
+  public:
+    Cursor() = default;
+    Cursor(const uchar* data, qsizetype size, qsizetype pos = 0)
+        : m_Data(data), m_Size(size), m_Pos(pos)
+    {}
+
+    qsizetype pos() const { return m_Pos; }
+    qsizetype size() const { return m_Size; }
+    qsizetype remaining() const { return m_Size - m_Pos; }
+    bool atEnd() const { return m_Pos >= m_Size; }
+
+    bool seek(qsizetype pos)
+    {
+      if (pos < 0 || pos > m_Size) {
+        return false;
+      }
+      m_Pos = pos;
+      return true;
+    }
+
+    bool skip(qsizetype count)
+    {
+      return seek(m_Pos + count);
+    }
+
+    bool readBytes(void* out, qsizetype length)
+    {
+      if (length < 0 || length > remaining()) {
+        return false;
+      }
+      std::memcpy(out, m_Data + m_Pos, static_cast<size_t>(length));
+      m_Pos += length;
+      return true;
+    }
+
+    template <typename T>
+    bool readLE(T& value)
+    {
+      static_assert(std::is_arithmetic_v<T>);
+      if (static_cast<qsizetype>(sizeof(T)) > remaining()) {
+        return false;
+      }
+      value = loadLE<T>(m_Data + m_Pos);
+      m_Pos += static_cast<qsizetype>(sizeof(T));
+      return true;
+    }
+
+    // Raw pointer at the cursor position, for callers that decode in place.
+    const uchar* current() const { return m_Data + m_Pos; }
+
+  private:
+    const uchar* m_Data = nullptr;
+    qsizetype m_Size    = 0;
+    qsizetype m_Pos     = 0;
+  };
+
+public:
+  XngineSaveView() = default;
+  explicit XngineSaveView(const QString& filePath);
+
+  XngineSaveView(const XngineSaveView&)            = delete;
+  XngineSaveView& operator=(const XngineSaveView&) = delete;
+  // Moving transfers the mapping; the source is left closed.
+  XngineSaveView(XngineSaveView&& other) noexcept;
+  XngineSaveView& operator=(XngineSaveView&& other) noexcept;
+
+  ~XngineSaveView();
+
+  bool open(const QString& filePath);
+  void close();
+
+  // True when the file could be opened, even if it is empty.
+  bool isOpen() const { return m_Open; }
+  bool isEmpty() const { return m_Size == 0; }
+  bool isMapped() const { return m_Mapped != nullptr; }
+
+  qsizetype size() const { return m_Size; }
+  const uchar* data() const { return m_Data; }
+
+  bool hasBytes(qsizetype offset, qsizetype length) const
+  {
+    return offset >= 0 && length >= 0 && offset <= m_Size - length;
+  }
+
+  // Non-owning QByteArray over the view; only valid while the view is alive.
+  QByteArray bytes() const;
+  QByteArray bytes(qsizetype offset, qsizetype length) const;
+
+  Cursor cursor(qsizetype pos = 0) const { return Cursor(m_Data, m_Size, pos); }
+
+  template <typename T>
+  bool readLE(qsizetype offset, T& value) const
+  {
+    static_assert(std::is_arithmetic_v<T>);
+    if (!hasBytes(offset, static_cast<qsizetype>(sizeof(T)))) {
+      return false;
+    }
+    value = loadLE<T>(m_Data + offset);
+    return true;
+  }
+
+  bool readU8(qsizetype offset, quint8& value) const { return readLE(offset, value); }
+  bool readLE16U(qsizetype offset, quint16& value) const { return readLE(offset, value); }
+  bool readLE32(qsizetype offset, qint32& value) const { return readLE(offset, value); }
+  bool readLE32U(qsizetype offset, quint32& value) const { return readLE(offset, value); }
+  bool readF32LE(qsizetype offset, float& value) const { return readLE(offset, value); }
+
+  // NUL-terminated fixed-width local 8-bit string, trimmed.
+  QString readFixedString(qsizetype offset, qsizetype size) const;
+
+  bool allZero() const;
+
+  // Process-wide count of views opened and bytes they exposed, for benchmarking.
+  static quint64 totalViewsOpened();
+  static quint64 totalBytesViewed();
+  static void resetTotals();
+
+  template <typename T>
+  static T loadLE(const uchar* src)
+  {
+    if constexpr (std::is_floating_point_v<T>) {
+      using Bits = std::conditional_t<sizeof(T) == 4, quint32, quint64>;
+      const Bits bits = qFromLittleEndian<Bits>(src);
+      T value;
+      std::memcpy(&value, &bits, sizeof(T));
+      return value;
+    } else {
+      return qFromLittleEndian<T>(src);
+    }
+  }
+
+private:
+  std::unique_ptr<QFile> m_File;
+  uchar* m_Mapped    = nullptr;
+  QByteArray m_Buffer;
+  const uchar* m_Data = nullptr;
+  qsizetype m_Size    = 0;
+  bool m_Open         = false;
+};
+
+#endif  // XNGINESAVEVIEW_H
@@ -0,0 +1,358 @@
+#include "daggerfallarch3dbsa.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QTextStream>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+using Mode = DaggerfallArch3dBsa::UvReconstructionMode;
+using Point = DaggerfallArch3dBsa::Point;
+
+struct ModeSet
+{
+  QString name;
+  Mode mode = Mode::None;
+  QVector<DaggerfallArch3dBsa::MeshRecord> meshes;
+  qint64 planeCount = 0;
+  qint64 reconstructedPoints = 0;
+};
+
+void printUsage()
+{
+  QTextStream err(stderr);
+  err << "Usage: arch3d_uv_bench [--iterations <n>] [--threads <n>] <ARCH3D.BSA>\n"
+         "\n"
+         "Loads every ARCH3D record once (timed), then splits the planes by the UV\n"
+         "reconstruction mode they resolved to and times DaggerfallArch3dBsa::reconstructUv\n"
+         "over each group <n> times (default 10). Each group is re-checked so a plane that\n"
+         "changes mode on re-reconstruction is reported as a mismatch, and every rebuilt\n"
+         "U/V value is compared against a per-vertex reference of the original solver.\n";
+}
+
+qint64 percentile(const std::vector<qint64>& sorted, double fraction)
+{
+  if (sorted.empty()) {
+    return 0;
+  }
+  const auto rank = static_cast<size_t>(fraction * static_cast<double>(sorted.size() - 1) + 0.5);
+  return sorted[std::min(rank, sorted.size() - 1)];
+}
+
+QString formatMillis(qint64 nanoseconds)
+{
+  return QString::number(static_cast<double>(nanoseconds) / 1.0e6, 'f', 2) + " ms";
+}
+
+bool solveLinear4x4(double a[4][4], double b[4], double x[4])
+{
+  for (int col = 0; col < 4; ++col) {
+    int pivot = col;
+    double best = std::abs(a[col][col]);
+    for (int r = col + 1; r < 4; ++r) {
+      if (std::abs(a[r][col]) > best) {
+        best = std::abs(a[r][col]);
+        pivot = r;
+      }
+    }
+    if (best < 1.0e-12) {
+      return false;
+    }
+    if (pivot != col) {
+      for (int c = col; c < 4; ++c) {
+        std::swap(a[col][c], a[pivot][c]);
+      }
+      std::swap(b[col], b[pivot]);
+    }
+    const double div = a[col][col];
+    for (int c = col; c < 4; ++c) {
+      a[col][c] /= div;
+    }
+    b[col] /= div;
+    for (int r = 0; r < 4; ++r) {
+      const double factor = a[r][col];
+      if (r == col || std::abs(factor) < 1.0e-20) {
+        continue;
+      }
+      for (int c = col; c < 4; ++c) {
+        a[r][c] -= factor * a[col][c];
+      }
+      b[r] -= factor * b[col];
+    }
+  }
+  for (int i = 0; i < 4; ++i) {
+    x[i] = b[i];
+  }
+  return true;
+}
+
+// The per-vertex solver reconstructUv replaced: one 4x4 solve per plane and UV axis,
+// and per-point plane coordinates for the first-triangle fallback. Only the absolute
+// UVs and uvReconstructed are produced; the result is the reference for the batch.
+void referenceUv(DaggerfallArch3dBsa::Plane& plane, const QVector<Point>& points)
+{
+  auto& pts = plane.points;
+  const int count = static_cast<int>(pts.size());
+  auto valid = [&points](int index) { return index >= 0 && index < points.size(); };
+  for (auto& point : pts) {
+    point.uvReconstructed = false;
+  }
+  if (count >= 1) {
+    pts[0].uAbsolute = pts[0].u;
+    pts[0].vAbsolute = pts[0].v;
+  }
+  if (count >= 2) {
+    pts[1].uAbsolute = pts[0].uAbsolute + pts[1].u;
+    pts[1].vAbsolute = pts[0].vAbsolute + pts[1].v;
+  }
+  if (count >= 3) {
+    pts[2].uAbsolute = pts[1].uAbsolute + pts[2].u;
+    pts[2].vAbsolute = pts[1].vAbsolute + pts[2].v;
+  }
+  if (count >= 4) {
+    pts[3].uAbsolute = pts[3].u;
+    pts[3].vAbsolute = pts[3].v;
+  }
+  if (count < 5 || !valid(pts[0].pointIndex) || !valid(pts[1].pointIndex) ||
+      !valid(pts[2].pointIndex)) {
+    return;
+  }
+
+  auto coord = [](const Point& p, int axis) {
+    return static_cast<double>(axis == 0 ? p.x : (axis == 1 ? p.y : p.z));
+  };
+  if (valid(pts[3].pointIndex)) {
+    double coeff[2][4] = {};
+    bool solved = true;
+    for (int axis = 0; axis < 2 && solved; ++axis) {
+      double m[4][4];
+      double rhs[4];
+      for (int r = 0; r < 4; ++r) {
+        const Point& p = points.at(pts[r].pointIndex);
+        m[r][0] = coord(p, 0);
+        m[r][1] = coord(p, 1);
+        m[r][2] = coord(p, 2);
+        m[r][3] = 1.0;
+        rhs[r] = static_cast<double>(axis == 0 ? pts[r].uAbsolute : pts[r].vAbsolute);
+      }
+      solved = solveLinear4x4(m, rhs, coeff[axis]);
+    }
+    if (solved) {
+      for (int i = 4; i < count; ++i) {
+        if (!valid(pts[i].pointIndex)) {
+          continue;
+        }
+        const Point& p = points.at(pts[i].pointIndex);
+        double uv[2];
+        for (int axis = 0; axis < 2; ++axis) {
+          const double* c = coeff[axis];
+          uv[axis] = c[0] * coord(p, 0) + c[1] * coord(p, 1) + c[2] * coord(p, 2) + c[3];
+        }
+        pts[i].uAbsolute = static_cast<qint32>(std::llround(uv[0]));
+        pts[i].vAbsolute = static_cast<qint32>(std::llround(uv[1]));
+        pts[i].uvReconstructed = true;
+      }
+      return;
+    }
+  }
+
+  const Point& p0 = points.at(pts[0].pointIndex);
+  double e1[3];
+  double e2[3];
+  for (int axis = 0; axis < 3; ++axis) {
+    e1[axis] = coord(points.at(pts[1].pointIndex), axis) - coord(p0, axis);
+    e2[axis] = coord(points.at(pts[2].pointIndex), axis) - coord(p0, axis);
+  }
+  auto dot = [](const double a[3], const double b[3]) {
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+  };
+  const double a11 = dot(e1, e1);
+  const double a12 = dot(e1, e2);
+  const double a22 = dot(e2, e2);
+  const double det = a11 * a22 - a12 * a12;
+  const double u0 = static_cast<double>(pts[0].uAbsolute);
+  const double v0 = static_cast<double>(pts[0].vAbsolute);
+  const double du1 = static_cast<double>(pts[1].uAbsolute - pts[0].uAbsolute);
+  const double dv1 = static_cast<double>(pts[1].vAbsolute - pts[0].vAbsolute);
+  const double du2 = static_cast<double>(pts[2].uAbsolute - pts[0].uAbsolute);
+  const double dv2 = static_cast<double>(pts[2].vAbsolute - pts[0].vAbsolute);
+  if (std::abs(det) < 1.0e-12) {
+    return;
+  }
+  for (int i = 4; i < count; ++i) {
+    if (!valid(pts[i].pointIndex)) {
+      continue;
+    }
+    const Point& p = points.at(pts[i].pointIndex);
+    const double d[3] = {coord(p, 0) - coord(p0, 0), coord(p, 1) - coord(p0, 1),
+                         coord(p, 2) - coord(p0, 2)};
+    const double b1 = dot(d, e1);
+    const double b2 = dot(d, e2);
+    const double s = (b1 * a22 - b2 * a12) / det;
+    const double t = (a11 * b2 - a12 * b1) / det;
+    pts[i].uAbsolute = static_cast<qint32>(std::llround(u0 + s * du1 + t * du2));
+    pts[i].vAbsolute = static_cast<qint32>(std::llround(v0 + s * dv1 + t * dv2));
+    pts[i].uvReconstructed = true;
+  }
+}
+
+// Points of mesh whose U, V or uvReconstructed differ from referenceUv.
+qint64 countUvDifferences(const DaggerfallArch3dBsa::MeshRecord& mesh)
+{
+  qint64 differences = 0;
+  for (const auto& plane : mesh.planes) {
+    DaggerfallArch3dBsa::Plane reference = plane;
+    referenceUv(reference, mesh.points);
+    for (int i = 0; i < plane.points.size(); ++i) {
+      const auto& got = plane.points.at(i);
+      const auto& want = reference.points.at(i);
+      if (got.uAbsolute != want.uAbsolute || got.vAbsolute != want.vAbsolute ||
+          got.uvReconstructed != want.uvReconstructed) {
+        ++differences;
+      }
+    }
+  }
+  return differences;
+}
+
+// Copy of the mesh restricted to the planes that resolved to `mode`.
+DaggerfallArch3dBsa::MeshRecord filterPlanes(const DaggerfallArch3dBsa::MeshRecord& mesh,
+                                             Mode mode, qint64& reconstructedPoints)
+{
+  DaggerfallArch3dBsa::MeshRecord out = mesh;
+  out.planes.clear();
+  for (const auto& plane : mesh.planes) {
+    if (plane.uvMode != mode) {
+      continue;
+    }
+    out.planes.push_back(plane);
+    for (const auto& point : plane.points) {
+      reconstructedPoints += point.uvReconstructed ? 1 : 0;
+    }
+  }
+  return out;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+  QCoreApplication app(argc, argv);
+  const QStringList args = app.arguments();
+
+  QString archivePath;
+  int iterations = 10;
+  int threads = 0;
+  for (int i = 1; i < args.size(); ++i) {
+    const QString& arg = args.at(i);
+    const bool hasValue = i + 1 < args.size();
+    if ((arg == "--iterations" || arg == "--threads") && hasValue) {
+      bool ok = false;
+      const int value = args.at(++i).toInt(&ok);
+      if (!ok || value <= 0) {
+        printUsage();
+        return 2;
+      }
+      (arg == "--iterations" ? iterations : threads) = value;
+    } else if (!arg.startsWith("--") && archivePath.isEmpty()) {
+      archivePath = QDir::fromNativeSeparators(arg);
+    } else {
+      printUsage();
+      return 2;
+    }
+  }
+  if (archivePath.isEmpty()) {
+    printUsage();
+    return 2;
+  }
+
+  QTextStream out(stdout);
+  QElapsedTimer timer;
+  timer.start();
+  DaggerfallArch3dBsa::Reader reader;
+  QString error;
+  if (!reader.open(archivePath, &error)) {
+    QTextStream(stderr) << error << '\n';
+    return 1;
+  }
+  const qint64 openNs = timer.nsecsElapsed();
+
+  timer.restart();
+  QVector<DaggerfallArch3dBsa::MeshRecord> meshes;
+  QString warning;
+  reader.loadMeshRecords(reader.recordIds(), meshes, &warning, &error, threads);
+  const qint64 loadNs = timer.nsecsElapsed();
+
+  const auto failed = std::count_if(meshes.cbegin(), meshes.cend(), [](const auto& mesh) {
+    return !mesh.isValid();
+  });
+  out << "ARCH3D.BSA: " << meshes.size() << " record(s), " << failed << " failed\n";
+  out << "  open " << formatMillis(openNs) << "  decode " << formatMillis(loadNs) << '\n';
+
+  qint64 uvDifferences = 0;
+  for (const auto& mesh : meshes) {
+    if (mesh.isValid()) {
+      uvDifferences += countUvDifferences(mesh);
+    }
+  }
+
+  std::vector<ModeSet> sets = {{"Affine4", Mode::Affine4, {}, 0, 0},
+                               {"Triangle3", Mode::Triangle3, {}, 0, 0},
+                               {"None", Mode::None, {}, 0, 0}};
+  for (auto& set : sets) {
+    for (const auto& mesh : meshes) {
+      if (!mesh.isValid()) {
+        continue;
+      }
+      auto filtered = filterPlanes(mesh, set.mode, set.reconstructedPoints);
+      set.planeCount += filtered.planes.size();
+      if (!filtered.planes.isEmpty()) {
+        set.meshes.push_back(std::move(filtered));
+      }
+    }
+  }
+
+  int mismatches = 0;
+  for (auto& set : sets) {
+    std::vector<qint64> samples;
+    samples.reserve(static_cast<size_t>(iterations));
+    for (int iteration = 0; iteration < iterations; ++iteration) {
+      timer.restart();
+      for (auto& mesh : set.meshes) {
+        DaggerfallArch3dBsa::reconstructUv(mesh);
+      }
+      samples.push_back(timer.nsecsElapsed());
+    }
+    for (const auto& mesh : set.meshes) {
+      for (const auto& plane : mesh.planes) {
+        mismatches += plane.uvMode != set.mode ? 1 : 0;
+      }
+      uvDifferences += countUvDifferences(mesh);
+    }
+    std::sort(samples.begin(), samples.end());
+
+    const qint64 median = percentile(samples, 0.50);
+    const double perPlane =
+        set.planeCount > 0 ? static_cast<double>(median) / static_cast<double>(set.planeCount)
+                           : 0.0;
+    out << "  " << set.name.leftJustified(10) << set.planeCount << " planes, "
+        << set.reconstructedPoints << " reconstructed points\n";
+    out << "    pass p50 " << formatMillis(median) << "  p90 "
+        << formatMillis(percentile(samples, 0.90)) << "  max " << formatMillis(samples.back())
+        << "  (" << QString::number(perPlane, 'f', 1) << " ns/plane)\n";
+  }
+
+  if (mismatches > 0) {
+    QTextStream(stderr) << mismatches << " plane(s) changed UV mode on re-reconstruction\n";
+  }
+  if (uvDifferences > 0) {
+    QTextStream(stderr) << uvDifferences
+                        << " point(s) differ from the per-vertex reference UVs\n";
+  }
+  return mismatches > 0 || uvDifferences > 0 ? 1 : 0;
+}
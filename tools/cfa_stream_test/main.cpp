@@ -0,0 +1,189 @@
+#include "daggerfallimageformats.h"
+
+#include <QByteArray>
+#include <QCoreApplication>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QtEndian>
+
+#include <algorithm>
+#include <iterator>
+
+namespace {
+
+constexpr int kHeaderSize = 76;
+
+struct Case
+{
+  const char* name;
+  int width;
+  int height;
+  int frames;
+  bool overshoot;  // last run extends past the final frame
+};
+
+// Runs of one value up to 200 pixels long between stretches of noise, so repeat runs
+// regularly straddle frame boundaries.
+QByteArray makePixels(qsizetype size, quint32 seed)
+{
+  QByteArray out(size, Qt::Uninitialized);
+  quint32 state = seed;
+  auto next = [&state]() {
+    state = state * 1664525u + 1013904223u;
+    return state >> 8;
+  };
+  qsizetype i = 0;
+  while (i < size) {
+    const qsizetype length = std::min<qsizetype>(1 + next() % 200, size - i);
+    const bool solid = (next() & 1) != 0;
+    const char value = static_cast<char>(next());
+    for (qsizetype k = 0; k < length; ++k) {
+      out[i + k] = solid ? value : static_cast<char>(next());
+    }
+    i += length;
+  }
+  return out;
+}
+
+// Same RLE as Daggerfall::Image::decodeRle: c < 0x80 copies c+1 literal bytes,
+// 0x80..0xFE repeats the next byte c-127 times. Runs ignore frame boundaries.
+QByteArray encodeRle(const QByteArray& pixels)
+{
+  QByteArray out;
+  const qsizetype size = pixels.size();
+  qsizetype i = 0;
+  while (i < size) {
+    qsizetype same = 1;
+    while (i + same < size && same < 127 && pixels.at(i + same) == pixels.at(i)) {
+      ++same;
+    }
+    if (same >= 3) {
+      out.append(static_cast<char>(127 + same));
+      out.append(pixels.at(i));
+      i += same;
+      continue;
+    }
+    qsizetype literal = 1;
+    while (i + literal < size && literal < 128 &&
+           !(i + literal + 2 < size && pixels.at(i + literal) == pixels.at(i + literal + 1) &&
+             pixels.at(i + literal) == pixels.at(i + literal + 2))) {
+      ++literal;
+    }
+    out.append(static_cast<char>(literal - 1));
+    out.append(pixels.constData() + i, literal);
+    i += literal;
+  }
+  return out;
+}
+
+QByteArray makeCfa(const Case& c, const QByteArray& pixels)
+{
+  QByteArray out(kHeaderSize, '\0');
+  auto* header = reinterpret_cast<uchar*>(out.data());
+  qToLittleEndian<quint16>(static_cast<quint16>(c.width), header + 0);
+  qToLittleEndian<quint16>(static_cast<quint16>(c.height), header + 2);
+  qToLittleEndian<quint16>(static_cast<quint16>(c.width), header + 4);
+  header[10] = 8;
+  header[11] = static_cast<uchar>(c.frames);
+  qToLittleEndian<quint16>(static_cast<quint16>(kHeaderSize), header + 12);
+  out.append(encodeRle(pixels));
+  if (c.overshoot) {
+    out.append(static_cast<char>(0xFE));  // 127 more pixels, clipped by both decoders
+    out.append('\x2a');
+  }
+  return out;
+}
+
+bool runCase(const Case& c, const QString& dirPath, QTextStream& err)
+{
+  const qsizetype framePixels = static_cast<qsizetype>(c.width) * c.height;
+  const QByteArray pixels = makePixels(framePixels * c.frames, 0x5eed0000u + c.frames);
+  const QString path = dirPath + QString("/%1.CFA").arg(c.name);
+  QFile file(path);
+  const QByteArray bytes = makeCfa(c, pixels);
+  if (!file.open(QIODevice::WriteOnly) || file.write(bytes) != bytes.size()) {
+    err << c.name << ": cannot write " << path << "\n";
+    return false;
+  }
+  file.close();
+
+  Daggerfall::Image::CfaFile loaded;
+  QString error;
+  if (!Daggerfall::Image::loadCfaFile(path, loaded, &error)) {
+    err << c.name << ": loadCfaFile failed: " << error << "\n";
+    return false;
+  }
+  Daggerfall::Image::CfaStream stream;
+  if (!stream.open(path, &error)) {
+    err << c.name << ": CfaStream::open failed: " << error << "\n";
+    return false;
+  }
+  if (stream.frameCount() != static_cast<int>(loaded.frames.size()) ||
+      stream.frameCount() != c.frames) {
+    err << c.name << ": " << stream.frameCount() << " streamed vs " << loaded.frames.size()
+        << " loaded frames, expected " << c.frames << "\n";
+    return false;
+  }
+
+  QByteArray frame;
+  for (int i = 0; i < c.frames; ++i) {
+    if (!stream.decodeFrame(i, frame, &error)) {
+      err << c.name << ": frame " << i << " decode failed: " << error << "\n";
+      return false;
+    }
+    if (frame != loaded.frames.at(i) || frame != pixels.mid(i * framePixels, framePixels)) {
+      err << c.name << ": frame " << i << " differs from loadCfaFile\n";
+      return false;
+    }
+  }
+
+  // Cut inside the last frame: both readers must refuse it. The mapping is released
+  // first, since a mapped file cannot be rewritten on Windows.
+  stream.close();
+  const QByteArray truncated = bytes.left(kHeaderSize + encodeRle(pixels).size() / 2);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) ||
+      file.write(truncated) != truncated.size()) {
+    err << c.name << ": cannot write " << path << "\n";
+    return false;
+  }
+  file.close();
+  if (Daggerfall::Image::loadCfaFile(path, loaded) || stream.open(path)) {
+    err << c.name << ": truncated stream was accepted\n";
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+  QCoreApplication app(argc, argv);
+  QTextStream out(stdout);
+  QTextStream err(stderr);
+
+  QTemporaryDir dir;
+  if (!dir.isValid()) {
+    err << "Cannot create a temporary directory\n";
+    return 1;
+  }
+
+  // Frame sizes below 127 pixels put whole frames inside one repeat run.
+  const Case cases[] = {
+      {"single", 80, 60, 1, false},
+      {"single_overshoot", 80, 60, 1, true},
+      {"multi", 32, 24, 7, false},
+      {"multi_overshoot", 32, 24, 7, true},
+      {"tiny_frames", 10, 9, 12, false},
+  };
+  const int total = static_cast<int>(std::size(cases));
+  int failed = 0;
+  for (const Case& c : cases) {
+    const bool ok = runCase(c, dir.path(), err);
+    out << (ok ? "PASS " : "FAIL ") << c.name << "\n";
+    failed += ok ? 0 : 1;
+  }
+  out << QString("%1 of %2 case(s) passed\n").arg(total - failed).arg(total);
+  return failed > 0 ? 1 : 0;
+}
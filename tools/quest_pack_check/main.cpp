@@ -0,0 +1,71 @@
+#include "daggerfallquestvalidator.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFileInfo>
+#include <QTextStream>
+
+namespace {
+
+void printUsage()
+{
+  QTextStream err(stderr);
+  err << "Usage: quest_pack_check [--text-rsc <TEXT.RSC>] [--threads <n>] <dir|file.QBN>...\n"
+         "\n"
+         "Parses every QBN (directories are searched recursively) with its companion QRC\n"
+         "in parallel and cross-references message ids and text variables against the\n"
+         "QRC and TEXT.RSC. For a single directory TEXT.RSC is looked up next to it when\n"
+         "--text-rsc is not given. Exits with 1 when any quest has errors.\n";
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+  QCoreApplication app(argc, argv);
+  const QStringList args = app.arguments();
+
+  DaggerfallQuestValidator::Options options;
+  QStringList inputs;
+  for (int i = 1; i < args.size(); ++i) {
+    const QString& arg = args.at(i);
+    const bool hasValue = i + 1 < args.size();
+    if (arg == "--text-rsc" && hasValue) {
+      options.textRscPath = QDir::fromNativeSeparators(args.at(++i));
+    } else if (arg == "--threads" && hasValue) {
+      bool ok = false;
+      options.maxThreads = args.at(++i).toInt(&ok);
+      if (!ok || options.maxThreads <= 0) {
+        printUsage();
+        return 2;
+      }
+    } else if (!arg.startsWith("--")) {
+      inputs.push_back(QDir::fromNativeSeparators(arg));
+    } else {
+      printUsage();
+      return 2;
+    }
+  }
+  if (inputs.isEmpty()) {
+    printUsage();
+    return 2;
+  }
+
+  DaggerfallQuestValidator::Report report;
+  if (inputs.size() == 1 && QFileInfo(inputs.first()).isDir()) {
+    report = DaggerfallQuestValidator::validateDirectory(inputs.first(), options);
+  } else {
+    QStringList files;
+    for (const QString& input : inputs) {
+      if (QFileInfo(input).isDir()) {
+        files += DaggerfallQuestValidator::questFiles(input);
+      } else {
+        files.push_back(input);
+      }
+    }
+    report = DaggerfallQuestValidator::validateFiles(files, options);
+  }
+
+  QTextStream(stdout) << DaggerfallQuestValidator::formatReport(report);
+  return report.count(DaggerfallQuestValidator::Severity::Error) > 0 ? 1 : 0;
+}
@@ -0,0 +1,196 @@
+#include "xnginerscformat.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTextStream>
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+void printUsage()
+{
+  QTextStream err(stderr);
+  err << "Usage: rsc_tokenize_bench [--iterations <n>] <TEXT.RSC>\n"
+         "\n"
+         "Parses TEXT.RSC once to collect its subrecords, then times <n> passes\n"
+         "(default 20) of the per-byte tokenizer as parseTextRecord used it (tokens for\n"
+         "the record, again for the text) against one span tokenization plus\n"
+         "decodeTextTokens. Decoded text of both paths is compared.\n";
+}
+
+qint64 percentile(const std::vector<qint64>& sorted, double fraction)
+{
+  if (sorted.empty()) {
+    return 0;
+  }
+  const auto rank = static_cast<size_t>(fraction * static_cast<double>(sorted.size() - 1) + 0.5);
+  return sorted[std::min(rank, sorted.size() - 1)];
+}
+
+QString formatMillis(qint64 nanoseconds)
+{
+  return QString::number(static_cast<double>(nanoseconds) / 1.0e6, 'f', 2) + " ms";
+}
+
+QString formatRate(qint64 bytes, qint64 nanoseconds)
+{
+  if (nanoseconds <= 0) {
+    return "-";
+  }
+  const double mbPerSecond =
+      static_cast<double>(bytes) / (1024.0 * 1024.0) / (static_cast<double>(nanoseconds) / 1.0e9);
+  return QString::number(mbPerSecond, 'f', 1) + " MB/s";
+}
+
+// Text decoding as it was done over per-byte tokens.
+QString decodeLegacy(const QVector<XngineRscFormat::TextToken>& tokens, qsizetype sizeHint)
+{
+  using TextTokenType = XngineRscFormat::TextTokenType;
+
+  QString out;
+  out.reserve(sizeHint);
+  for (const auto& t : tokens) {
+    switch (t.type) {
+      case TextTokenType::Printable:
+        out.append(QChar::fromLatin1(t.bytes.at(0)));
+        break;
+      case TextTokenType::EndOfLine:
+      case TextTokenType::EndOfPage:
+        out.append('\n');
+        break;
+      default:
+        if (!t.bytes.isEmpty() && static_cast<quint8>(t.bytes.at(0)) == 0x00) {
+          out.append('\n');
+        }
+        break;
+    }
+  }
+  return out;
+}
+
+struct PassResult
+{
+  std::vector<qint64> samples;
+  qint64 tokenCount = 0;
+  QStringList texts;
+};
+
+void report(QTextStream& out, const QString& name, PassResult& result, qint64 bytes)
+{
+  std::sort(result.samples.begin(), result.samples.end());
+  const qint64 median = percentile(result.samples, 0.50);
+  out << "  " << name.leftJustified(8) << result.tokenCount << " tokens/pass\n";
+  out << "    pass p50 " << formatMillis(median) << "  p90 "
+      << formatMillis(percentile(result.samples, 0.90)) << "  max "
+      << formatMillis(result.samples.back()) << "  (" << formatRate(bytes, median) << ")\n";
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+  QCoreApplication app(argc, argv);
+  const QStringList args = app.arguments();
+
+  QString rscPath;
+  int iterations = 20;
+  for (int i = 1; i < args.size(); ++i) {
+    const QString& arg = args.at(i);
+    if (arg == "--iterations" && i + 1 < args.size()) {
+      bool ok = false;
+      iterations = args.at(++i).toInt(&ok);
+      if (!ok || iterations <= 0) {
+        printUsage();
+        return 2;
+      }
+    } else if (!arg.startsWith("--") && rscPath.isEmpty()) {
+      rscPath = QDir::fromNativeSeparators(arg);
+    } else {
+      printUsage();
+      return 2;
+    }
+  }
+  if (rscPath.isEmpty()) {
+    printUsage();
+    return 2;
+  }
+
+  QFile file(rscPath);
+  if (!file.open(QIODevice::ReadOnly)) {
+    QTextStream(stderr) << "Failed to open " << rscPath << '\n';
+    return 1;
+  }
+  const QByteArray bytes = file.readAll();
+
+  QTextStream out(stdout);
+  QElapsedTimer timer;
+  timer.start();
+  XngineRscFormat::TextRecordDatabase db;
+  QString error;
+  if (!XngineRscFormat::parseTextRecordDatabase(bytes, db, &error)) {
+    QTextStream(stderr) << error << '\n';
+    return 1;
+  }
+  const qint64 parseNs = timer.nsecsElapsed();
+
+  QVector<QByteArray> subrecords;
+  qint64 subrecordBytes = 0;
+  for (const auto& record : db.records) {
+    for (const auto& sub : record.subrecords) {
+      subrecords.push_back(sub.raw);
+      subrecordBytes += sub.raw.size();
+    }
+  }
+  out << "TEXT.RSC: " << db.records.size() << " record(s), " << subrecords.size()
+      << " subrecord(s), " << subrecordBytes << " bytes\n";
+  out << "  parse " << formatMillis(parseNs) << '\n';
+
+  PassResult legacy;
+  PassResult spans;
+  for (int iteration = 0; iteration < iterations; ++iteration) {
+    const bool keep = iteration == 0;
+    qint64 tokenCount = 0;
+
+    timer.restart();
+    for (const auto& raw : subrecords) {
+      const auto tokens = XngineRscFormat::tokenizeTextSubrecord(raw);
+      const QString text = decodeLegacy(XngineRscFormat::tokenizeTextSubrecord(raw), raw.size());
+      tokenCount += tokens.size();
+      if (keep) {
+        legacy.texts.push_back(text);
+      }
+    }
+    legacy.samples.push_back(timer.nsecsElapsed());
+    legacy.tokenCount = tokenCount;
+
+    tokenCount = 0;
+    timer.restart();
+    for (const auto& raw : subrecords) {
+      const auto tokens = XngineRscFormat::tokenizeTextSubrecordSpans(raw);
+      const QString text = XngineRscFormat::decodeTextTokens(raw, tokens);
+      tokenCount += tokens.size();
+      if (keep) {
+        spans.texts.push_back(text);
+      }
+    }
+    spans.samples.push_back(timer.nsecsElapsed());
+    spans.tokenCount = tokenCount;
+  }
+
+  report(out, "per-byte", legacy, subrecordBytes);
+  report(out, "spans", spans, subrecordBytes);
+
+  int mismatches = 0;
+  for (qsizetype i = 0; i < legacy.texts.size(); ++i) {
+    mismatches += legacy.texts.at(i) != spans.texts.at(i) ? 1 : 0;
+  }
+  if (mismatches > 0) {
+    QTextStream(stderr) << mismatches << " subrecord(s) decoded differently\n";
+    return 1;
+  }
+  return 0;
+}
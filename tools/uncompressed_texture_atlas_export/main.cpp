@@ -0,0 +1,149 @@
+#include "daggerfallimageformats.h"
+#include "daggerfalluncompressedtextureset.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFileInfo>
+#include <QTextStream>
+
+namespace {
+
+void printUsage()
+{
+  QTextStream err(stderr);
+  err << "Usage: uncompressed_texture_atlas_export [--palette <ART_PAL.COL>] [--threads <n>]\n"
+         "                                         [--max-width <px>] [--padding <px>]\n"
+         "                                         [--out <dir>] <ARENA2 dir|TEXTURE.xxx>...\n"
+         "\n"
+         "Decodes the uncompressed single-frame records of every TEXTURE.xxx archive in\n"
+         "parallel and packs each archive into one atlas.\n"
+         "With --out, writes <archive>.png plus .json and .bin UV manifests per archive;\n"
+         "the palette defaults to ART_PAL.COL next to the archives. Without --out only\n"
+         "the decode and pack timings are printed.\n"
+         "\n"
+         "RLE-compressed (RecordRle/ImageRle) and animated records are not supported;\n"
+         "they are counted as skipped, and archives left with no decoded frame get no\n"
+         "atlas.\n";
+}
+
+QString formatMillis(qint64 ns)
+{
+  return QString("%1 ms").arg(static_cast<double>(ns) / 1e6, 0, 'f', 2);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+  QCoreApplication app(argc, argv);
+  const QStringList args = app.arguments();
+
+  DaggerfallUncompressedTextureSet::Options options;
+  options.keepFrames = false;
+  QString palettePath;
+  QString outputDir;
+  QStringList inputs;
+  for (int i = 1; i < args.size(); ++i) {
+    const QString& arg = args.at(i);
+    const bool hasValue = i + 1 < args.size();
+    bool ok = true;
+    if (arg == "--palette" && hasValue) {
+      palettePath = QDir::fromNativeSeparators(args.at(++i));
+    } else if (arg == "--out" && hasValue) {
+      outputDir = QDir::fromNativeSeparators(args.at(++i));
+    } else if (arg == "--threads" && hasValue) {
+      options.maxThreads = args.at(++i).toInt(&ok);
+      ok = ok && options.maxThreads > 0;
+    } else if (arg == "--max-width" && hasValue) {
+      options.maxAtlasWidth = args.at(++i).toInt(&ok);
+      ok = ok && options.maxAtlasWidth > 0;
+    } else if (arg == "--padding" && hasValue) {
+      options.padding = args.at(++i).toInt(&ok);
+      ok = ok && options.padding >= 0;
+    } else if (!arg.startsWith("--")) {
+      inputs.push_back(QDir::fromNativeSeparators(arg));
+    } else {
+      ok = false;
+    }
+    if (!ok) {
+      printUsage();
+      return 2;
+    }
+  }
+  if (inputs.isEmpty()) {
+    printUsage();
+    return 2;
+  }
+
+  QStringList files;
+  for (const QString& input : inputs) {
+    if (QFileInfo(input).isDir()) {
+      files += DaggerfallUncompressedTextureSet::textureFiles(input);
+    } else {
+      files.push_back(input);
+    }
+  }
+
+  QTextStream out(stdout);
+  QTextStream err(stderr);
+  const DaggerfallUncompressedTextureSet::Result result =
+      DaggerfallUncompressedTextureSet::decodeFiles(files, options);
+  qint64 decodeNs = 0;
+  qint64 packNs = 0;
+  for (const auto& archive : result.archives) {
+    decodeNs += archive.decodeNs;
+    packNs += archive.packNs;
+    if (!archive.loaded) {
+      err << QDir::toNativeSeparators(archive.path) << ": " << archive.error << "\n";
+    } else if (!archive.warning.isEmpty()) {
+      err << QDir::toNativeSeparators(archive.path) << ": warning: " << archive.warning << "\n";
+    }
+  }
+  out << QString("%1 archive(s), %2 failed, %3 frame(s), %4 record(s) skipped in %5 "
+                 "(decode %6, pack %7 summed)\n")
+             .arg(result.archives.size())
+             .arg(result.failedCount())
+             .arg(result.frameCount())
+             .arg(result.skippedRecordCount())
+             .arg(formatMillis(result.elapsedNs), formatMillis(decodeNs), formatMillis(packNs));
+
+  if (outputDir.isEmpty() || files.isEmpty()) {
+    return result.failedCount() > 0 ? 1 : 0;
+  }
+
+  if (palettePath.isEmpty()) {
+    palettePath = QFileInfo(files.first()).dir().filePath("ART_PAL.COL");
+  }
+  Daggerfall::Image::PaletteFile palette;
+  QString error;
+  if (!Daggerfall::Image::loadPaletteFile(palettePath, palette, &error)) {
+    err << "Failed loading palette " << QDir::toNativeSeparators(palettePath) << ": " << error
+        << "\n";
+    return 1;
+  }
+  const QVector<QRgb> colorTable = Daggerfall::Image::argbColorTable(palette);
+
+  int written = 0;
+  int empty = 0;
+  for (const auto& archive : result.archives) {
+    if (!archive.loaded) {
+      continue;
+    }
+    if (archive.atlas.frames.isEmpty()) {
+      err << QDir::toNativeSeparators(archive.path)
+          << ": warning: no decoded frames, atlas not written\n";
+      ++empty;
+      continue;
+    }
+    if (!DaggerfallUncompressedTextureSet::writeAtlas(archive, outputDir, colorTable, &error)) {
+      err << error << "\n";
+      return 1;
+    }
+    ++written;
+  }
+  out << QString("%1 atlas(es) written to %2, %3 archive(s) without decoded frames skipped\n")
+             .arg(written)
+             .arg(QDir::toNativeSeparators(outputDir))
+             .arg(empty);
+  return result.failedCount() > 0 ? 1 : 0;
+}
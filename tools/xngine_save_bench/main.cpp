@@ -0,0 +1,342 @@
+#include "arenasavegame.h"
+#include "battlespiresavegame.h"
+#include "daggerfallsavegame.h"
+#include "redguardsavegame.h"
+#include "xngineheadless.h"
+#include "xnginesaveview.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRegularExpression>
+#include <QTextStream>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace {
+
+// Only calls to operator new are counted; Qt containers allocate their payloads with
+// malloc, so this tracks parser-side object churn, not total heap use, and is reported
+// as "operator new calls".
+std::atomic<quint64> g_Allocations{0};
+std::atomic<quint64> g_AllocatedBytes{0};
+
+}  // namespace
+
+void* operator new(std::size_t size)
+{
+  g_Allocations.fetch_add(1, std::memory_order_relaxed);
+  g_AllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+  if (void* ptr = std::malloc(size != 0 ? size : 1)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+namespace {
+
+struct Parser
+{
+  QString name;
+  // Slot directory names, matched the same way as the plugin's SaveLayout.
+  QRegularExpression slotDirRegex;
+  QStringList baseRelativePaths;
+  QString requiredFile;
+  std::function<std::shared_ptr<const XngineSaveGame>(const QString&)> make;
+};
+
+struct Sample
+{
+  qint64 nanoseconds = 0;
+  quint64 bytesViewed = 0;
+  quint64 allocations = 0;
+  quint64 allocatedBytes = 0;
+};
+
+void printUsage()
+{
+  QTextStream err(stderr);
+  err << "Usage: xngine_save_bench [--game <arena|battlespire|daggerfall|redguard>]\n"
+         "                         [--game-dir <install-dir>] [--iterations <n>]\n"
+         "                         [--json <output-file>] <saves-directory>\n"
+         "\n"
+         "Parses every save slot under <saves-directory> <n> times (default 5) and\n"
+         "reports per-parse latency percentiles, bytes read through XngineSaveView and\n"
+         "operator new calls. Without --game all four games are benchmarked: the\n"
+         "saves directory (and --game-dir, if given) must then hold one subdirectory\n"
+         "per game named as above; games without one are skipped.\n"
+         "--game-dir enables install lookups (palettes, MAPS.BSA, ENGLISH.RTX) so\n"
+         "timings match the plugin; without it those lookups are skipped. --json\n"
+         "writes the parsed metadata of each slot, grouped by game.\n";
+}
+
+// gameDirFor maps a parser name to its install directory ("" skips install lookups).
+std::vector<Parser> makeParsers(const std::function<QString(const QString&)>& gameDirFor)
+{
+  std::vector<Parser> parsers;
+
+  auto arena = std::make_shared<GameArena>(gameDirFor("arena"));
+  parsers.push_back({"arena", QRegularExpression("(?i)^SAVE(\\d+)$"), {""}, {},
+                     [arena](const QString& path) {
+                       return std::make_shared<ArenaSaveGame>(path, arena.get());
+                     }});
+
+  auto battlespire = std::make_shared<GameBattlespire>(gameDirFor("battlespire"));
+  parsers.push_back({"battlespire", QRegularExpression("^SAVE(\\d+)$"), {""}, {},
+                     [battlespire](const QString& path) {
+                       return std::make_shared<BattlespireSaveGame>(path, battlespire.get());
+                     }});
+
+  auto daggerfall = std::make_shared<GameDaggerfall>(gameDirFor("daggerfall"));
+  parsers.push_back({"daggerfall", QRegularExpression("^SAVE(\\d+)$"), {""}, {},
+                     [daggerfall](const QString& path) {
+                       return std::make_shared<DaggerfallsSaveGame>(path, daggerfall.get());
+                     }});
+
+  auto redguard = std::make_shared<GameRedguard>(gameDirFor("redguard"));
+  parsers.push_back({"redguard", QRegularExpression("(?i)^SAVEGAME\\.(\\d+)$"),
+                     {"", "SAVEGAME"}, "SAVEGAME.SAV",
+                     [redguard](const QString& path) {
+                       return std::make_shared<RedguardsSaveGame>(path, redguard.get());
+                     }});
+
+  return parsers;
+}
+
+QStringList findSlots(const Parser& parser, const QDir& savesDir)
+{
+  QStringList slotPaths;
+  for (const auto& relative : parser.baseRelativePaths) {
+    const QDir base(relative.isEmpty() ? savesDir.absolutePath()
+                                       : savesDir.absoluteFilePath(relative));
+    const auto entries = base.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name);
+    for (const auto& entry : entries) {
+      if (!parser.slotDirRegex.match(entry.fileName()).hasMatch()) {
+        continue;
+      }
+      if (!parser.requiredFile.isEmpty() &&
+          !QFileInfo::exists(QDir(entry.absoluteFilePath()).filePath(parser.requiredFile))) {
+        continue;
+      }
+      slotPaths.push_back(entry.absoluteFilePath());
+    }
+  }
+  return slotPaths;
+}
+
+qint64 percentile(const std::vector<qint64>& sorted, double fraction)
+{
+  if (sorted.empty()) {
+    return 0;
+  }
+  const auto rank = static_cast<size_t>(fraction * static_cast<double>(sorted.size() - 1) + 0.5);
+  return sorted[std::min(rank, sorted.size() - 1)];
+}
+
+QString formatMicros(qint64 nanoseconds)
+{
+  return QString::number(static_cast<double>(nanoseconds) / 1000.0, 'f', 1) + " us";
+}
+
+QJsonObject toJson(const XngineSaveGame::Metadata& meta)
+{
+  QJsonObject obj;
+  obj["filePath"] = meta.filePath;
+  obj["characterName"] = meta.characterName;
+  obj["level"] = static_cast<int>(meta.level);
+  obj["location"] = meta.location;
+  obj["region"] = meta.region;
+  obj["inGameDate"] = meta.inGameDate;
+  obj["inGameMinutes"] = static_cast<qint64>(meta.inGameMinutes);
+  obj["gold"] = meta.gold ? QJsonValue(static_cast<qint64>(*meta.gold)) : QJsonValue();
+  obj["saveNumber"] = static_cast<qint64>(meta.saveNumber);
+  obj["creationTime"] = meta.creationTime.toUTC().toString(Qt::ISODate);
+  return obj;
+}
+
+// Parses every slot `iterations` times and prints the summary; the metadata of the
+// first pass is appended to `metadata` when it is non-null.
+void runParser(const Parser& parser, const QStringList& slotPaths, int iterations,
+               QJsonArray* metadata)
+{
+  std::vector<Sample> samples;
+  samples.reserve(static_cast<size_t>(slotPaths.size()) * static_cast<size_t>(iterations));
+  for (int iteration = 0; iteration < iterations; ++iteration) {
+    for (const auto& slot : slotPaths) {
+      XngineSaveView::resetTotals();
+      const quint64 allocationsBefore = g_Allocations.load(std::memory_order_relaxed);
+      const quint64 allocatedBefore = g_AllocatedBytes.load(std::memory_order_relaxed);
+
+      QElapsedTimer timer;
+      timer.start();
+      const auto save = parser.make(slot);
+      const qint64 elapsed = timer.nsecsElapsed();
+
+      Sample sample;
+      sample.nanoseconds = elapsed;
+      sample.bytesViewed = XngineSaveView::totalBytesViewed();
+      sample.allocations = g_Allocations.load(std::memory_order_relaxed) - allocationsBefore;
+      sample.allocatedBytes =
+          g_AllocatedBytes.load(std::memory_order_relaxed) - allocatedBefore;
+      samples.push_back(sample);
+
+      if (iteration == 0 && metadata != nullptr) {
+        metadata->push_back(toJson(save->metadata()));
+      }
+    }
+  }
+
+  std::vector<qint64> latencies;
+  latencies.reserve(samples.size());
+  quint64 totalBytes = 0;
+  quint64 totalAllocations = 0;
+  quint64 totalAllocatedBytes = 0;
+  for (const auto& sample : samples) {
+    latencies.push_back(sample.nanoseconds);
+    totalBytes += sample.bytesViewed;
+    totalAllocations += sample.allocations;
+    totalAllocatedBytes += sample.allocatedBytes;
+  }
+  std::sort(latencies.begin(), latencies.end());
+  const auto count = static_cast<quint64>(samples.size());
+
+  QTextStream out(stdout);
+  out << parser.name << ": " << slotPaths.size() << " slot(s) x " << iterations
+      << " iteration(s)\n";
+  out << "  latency  p50 " << formatMicros(percentile(latencies, 0.50)) << "  p90 "
+      << formatMicros(percentile(latencies, 0.90)) << "  p99 "
+      << formatMicros(percentile(latencies, 0.99)) << "  max "
+      << formatMicros(latencies.back()) << '\n';
+  out << "  per parse  bytes read " << totalBytes / count << "  operator new calls "
+      << totalAllocations / count << " (" << totalAllocatedBytes / count << " bytes)\n";
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+  QCoreApplication app(argc, argv);
+  const QStringList args = app.arguments();
+
+  QString gameName;
+  QString gameDir;
+  QString jsonPath;
+  QString savesPath;
+  int iterations = 5;
+  for (int i = 1; i < args.size(); ++i) {
+    const QString& arg = args.at(i);
+    const bool hasValue = i + 1 < args.size();
+    if (arg == "--game" && hasValue) {
+      gameName = args.at(++i).toLower();
+    } else if (arg == "--game-dir" && hasValue) {
+      gameDir = QDir::fromNativeSeparators(args.at(++i));
+    } else if (arg == "--json" && hasValue) {
+      jsonPath = QDir::fromNativeSeparators(args.at(++i));
+    } else if (arg == "--iterations" && hasValue) {
+      bool ok = false;
+      iterations = args.at(++i).toInt(&ok);
+      if (!ok || iterations <= 0) {
+        printUsage();
+        return 2;
+      }
+    } else if (!arg.startsWith("--") && savesPath.isEmpty()) {
+      savesPath = QDir::fromNativeSeparators(arg);
+    } else {
+      printUsage();
+      return 2;
+    }
+  }
+
+  if (savesPath.isEmpty()) {
+    printUsage();
+    return 2;
+  }
+
+  const QDir savesDir(savesPath);
+  if (!savesDir.exists()) {
+    QTextStream(stderr) << "Saves directory not found: " << savesPath << '\n';
+    return 3;
+  }
+
+  // A single --game uses both directories as given; otherwise each game reads its own
+  // subdirectory of them.
+  const bool allGames = gameName.isEmpty();
+  const auto parsers = makeParsers([&](const QString& name) {
+    if (gameDir.isEmpty() || !allGames) {
+      return gameDir;
+    }
+    return QDir(gameDir).filePath(name);
+  });
+
+  std::vector<const Parser*> selected;
+  for (const auto& parser : parsers) {
+    if (allGames || parser.name == gameName) {
+      selected.push_back(&parser);
+    }
+  }
+  if (selected.empty()) {
+    QTextStream(stderr) << "Unknown game: " << gameName << '\n';
+    printUsage();
+    return 2;
+  }
+
+  QJsonArray games;
+  int benchmarked = 0;
+  for (const Parser* parser : selected) {
+    const QDir parserSavesDir(allGames ? savesDir.filePath(parser->name) : savesPath);
+    const QStringList slotPaths =
+        parserSavesDir.exists() ? findSlots(*parser, parserSavesDir) : QStringList();
+    if (slotPaths.isEmpty()) {
+      QTextStream(stderr) << "No " << parser->name << " save slots found under "
+                          << QDir::toNativeSeparators(parserSavesDir.path()) << '\n';
+      continue;
+    }
+
+    QJsonArray metadata;
+    runParser(*parser, slotPaths, iterations, jsonPath.isEmpty() ? nullptr : &metadata);
+    ++benchmarked;
+
+    QJsonObject game;
+    game["game"] = parser->name;
+    game["saves"] = metadata;
+    games.push_back(game);
+  }
+  if (benchmarked == 0) {
+    return 1;
+  }
+
+  if (!jsonPath.isEmpty()) {
+    QJsonObject root;
+    root["games"] = games;
+    QFile file(jsonPath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+      QTextStream(stderr) << "Failed to write " << jsonPath << ": " << file.errorString()
+                          << '\n';
+      return 1;
+    }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+  }
+
+  return 0;
+}